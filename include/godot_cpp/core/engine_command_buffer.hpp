@@ -0,0 +1,217 @@
+/**************************************************************************/
+/*  engine_command_buffer.hpp                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GODOT_ENGINE_COMMAND_BUFFER_HPP
+#define GODOT_ENGINE_COMMAND_BUFFER_HPP
+
+#include <godot_cpp/core/engine_ptrcall.hpp>
+#include <godot_cpp/core/error_macros.hpp>
+#include <godot_cpp/core/memory.hpp>
+#include <godot_cpp/core/method_ptrcall.hpp>
+#include <godot_cpp/core/object.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/templates/spin_lock.hpp>
+
+#include <atomic>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace godot {
+
+/**
+ * Engine calls recorded from any thread, and executed later in one pass by
+ * the thread calling flush(), normally the main thread.
+ *
+ * Each recording thread appends to its own buffer, so recording only takes
+ * an uncontended lock, and never boxes arguments into Variants:
+ *
+ * - push_ptrcall() encodes the arguments with PtrToArg when recording, and
+ *   flush() passes them straight to the method bind, as the generated
+ *   wrappers do.
+ * - push_call() stores the arguments as they are, and calls a wrapper method
+ *   (such as &Node3D::set_position) at flush time.
+ * - push() runs any callable.
+ *
+ * Calls on an object that was freed in the meantime are skipped. Commands
+ * recorded by one thread run in order; there is no ordering between
+ * threads. flush() may run while other threads keep recording, their new
+ * commands are left for the next flush.
+ */
+class EngineCommandBuffer {
+	struct Command {
+		Command *next = nullptr;
+		virtual void execute() = 0;
+		virtual ~Command() {}
+	};
+
+	template <class... EncodeT>
+	struct PtrCallCommand : public Command {
+		GDExtensionMethodBindPtr method_bind;
+		GDObjectInstanceID object_id;
+		std::tuple<EncodeT...> arguments;
+
+		virtual void execute() override {
+			GDExtensionObjectPtr owner = internal::gdextension_interface_object_get_instance_from_id(object_id);
+			if (!owner) {
+				return;
+			}
+			std::apply([this, owner](const EncodeT &...p_arguments) { internal::_call_native_mb_no_ret(method_bind, owner, &p_arguments...); }, arguments);
+		}
+	};
+
+	template <class T, class M, class... Args>
+	struct MethodCommand : public Command {
+		GDObjectInstanceID object_id;
+		M method;
+		std::tuple<Args...> arguments;
+
+		virtual void execute() override {
+			Object *object = ObjectDB::get_instance(object_id);
+			if (!object) {
+				return;
+			}
+			T *instance = static_cast<T *>(object);
+			std::apply([this, instance](Args &...p_arguments) { (instance->*method)(p_arguments...); }, arguments);
+		}
+	};
+
+	template <class F>
+	struct FunctionCommand : public Command {
+		F function;
+
+		virtual void execute() override {
+			function();
+		}
+
+		FunctionCommand(F &&p_function) :
+				function(std::move(p_function)) {}
+	};
+
+	// Commands are constructed in chunks, and destroyed after they ran.
+	struct Storage {
+		static constexpr size_t CHUNK_SIZE = 16 * 1024;
+
+		LocalVector<uint8_t *> chunks;
+		LocalVector<uint8_t *> large_chunks; // For commands bigger than a chunk.
+		uint32_t chunk_index = 0;
+		uint8_t *position = nullptr;
+		uint8_t *end = nullptr;
+		Command *first = nullptr;
+		Command *last = nullptr;
+		uint32_t count = 0;
+
+		void *alloc(size_t p_size);
+		void append(Command *p_command);
+		// Destroys the commands, running them first if p_execute is true.
+		void release(bool p_execute);
+	};
+
+	struct ThreadBuffer {
+		std::thread::id thread;
+		SpinLock lock;
+		Storage storages[2];
+		uint32_t recording = 0; // Index of the storage commands are recorded in.
+	};
+
+	// Tells apart command buffers in the per-thread cache of
+	// _get_thread_buffer(), even if one is allocated where another was.
+	const uint64_t serial;
+	SpinLock threads_lock;
+	LocalVector<ThreadBuffer *> threads;
+	SpinLock flush_lock;
+
+	ThreadBuffer *_get_thread_buffer();
+
+	template <class C>
+	void _record(C *p_command) {
+		ThreadBuffer *buffer = _get_thread_buffer();
+		buffer->lock.lock();
+		Storage &storage = buffer->storages[buffer->recording];
+		storage.append(memnew_placement(storage.alloc(sizeof(C)), C(std::move(*p_command))));
+		buffer->lock.unlock();
+	}
+
+public:
+	// Looks up the method bind to pass to push_ptrcall(). p_hash is the one
+	// from extension_api.json, also found in the generated wrapper.
+	static GDExtensionMethodBindPtr get_method_bind(const StringName &p_class, const StringName &p_method, int64_t p_hash);
+
+	// Records p_method_bind(p_args...) on p_object, without return value. The
+	// arguments must match the method signature exactly.
+	template <class... Args>
+	void push_ptrcall(Object *p_object, GDExtensionMethodBindPtr p_method_bind, const Args &...p_args) {
+		ERR_FAIL_NULL(p_object);
+		ERR_FAIL_NULL(p_method_bind);
+		typedef PtrCallCommand<typename PtrToArg<Args>::EncodeT...> C;
+		C command;
+		command.method_bind = p_method_bind;
+		command.object_id = internal::gdextension_interface_object_get_instance_id(p_object->_owner);
+		std::apply([&p_args...](typename PtrToArg<Args>::EncodeT &...r_encoded) { (PtrToArg<Args>::encode(p_args, &r_encoded), ...); }, command.arguments);
+		_record(&command);
+	}
+
+	// Records (p_object->*p_method)(p_args...).
+	template <class T, class M, class... Args>
+	void push_call(T *p_object, M p_method, Args &&...p_args) {
+		static_assert(std::is_base_of<Object, T>::value, "push_call() only records calls on Objects.");
+		ERR_FAIL_NULL(p_object);
+		typedef MethodCommand<T, M, std::decay_t<Args>...> C;
+		C command;
+		command.object_id = internal::gdextension_interface_object_get_instance_id(p_object->_owner);
+		command.method = p_method;
+		command.arguments = std::tuple<std::decay_t<Args>...>(std::forward<Args>(p_args)...);
+		_record(&command);
+	}
+
+	// Records p_function(), which owns whatever it captures.
+	template <class F>
+	void push(F p_function) {
+		FunctionCommand<F> command(std::move(p_function));
+		_record(&command);
+	}
+
+	// Runs the commands recorded so far, thread by thread. Returns how many
+	// ran.
+	uint32_t flush();
+
+	// Drops the commands recorded so far without running them.
+	void clear();
+
+	EngineCommandBuffer();
+	EngineCommandBuffer(const EngineCommandBuffer &) = delete;
+	EngineCommandBuffer &operator=(const EngineCommandBuffer &) = delete;
+	~EngineCommandBuffer();
+};
+
+} // namespace godot
+
+#endif // GODOT_ENGINE_COMMAND_BUFFER_HPP
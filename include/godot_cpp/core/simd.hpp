@@ -0,0 +1,221 @@
+/**************************************************************************/
+/*  simd.hpp                                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GODOT_SIMD_HPP
+#define GODOT_SIMD_HPP
+
+#include <godot_cpp/core/defs.hpp>
+
+// Vector3, Vector4 and Quaternion use these kernels in single precision
+// builds when the target guarantees SSE2 (x86) or NEON (AArch64). The `simd`
+// build option can raise the instruction set or define GODOT_SIMD_DISABLED
+// to keep the scalar code. The memory layout of the types is unchanged.
+#if !defined(REAL_T_IS_DOUBLE) && !defined(GODOT_SIMD_DISABLED)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GODOT_SIMD_ENABLED
+#define GODOT_SIMD_SSE
+#if defined(__SSE4_1__) || defined(__AVX__)
+#define GODOT_SIMD_SSE4
+#include <smmintrin.h>
+#else
+#include <emmintrin.h>
+#endif
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define GODOT_SIMD_ENABLED
+#define GODOT_SIMD_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
+#ifdef GODOT_SIMD_ENABLED
+
+namespace godot {
+
+// Operations on four packed floats. Three component values are loaded with
+// the fourth lane cleared, and only their first three lanes are meaningful.
+// Every operation rounds in the same order as the scalar code (dot products
+// sum from x to w, no fused multiply-add), so results are bit identical to
+// the engine's.
+namespace Simd {
+
+#if defined(GODOT_SIMD_SSE)
+
+typedef __m128 Float4;
+
+#define GODOT_SIMD_SHUFFLE(m_v, m_x, m_y, m_z, m_w) _mm_shuffle_ps(m_v, m_v, _MM_SHUFFLE(m_w, m_z, m_y, m_x))
+
+_FORCE_INLINE_ Float4 load4(const float *p_src) { return _mm_loadu_ps(p_src); }
+_FORCE_INLINE_ void store4(float *p_dst, Float4 p_v) { _mm_storeu_ps(p_dst, p_v); }
+
+// Accesses exactly 12 bytes, a Vector3 may be the last thing in a page.
+_FORCE_INLINE_ Float4 load3(const float *p_src) {
+	Float4 xy = _mm_castsi128_ps(_mm_loadu_si64(p_src));
+	return _mm_movelh_ps(xy, _mm_load_ss(p_src + 2));
+}
+
+_FORCE_INLINE_ void store3(float *p_dst, Float4 p_v) {
+	_mm_storeu_si64(p_dst, _mm_castps_si128(p_v));
+	_mm_store_ss(p_dst + 2, _mm_movehl_ps(p_v, p_v));
+}
+
+_FORCE_INLINE_ Float4 splat(float p_value) { return _mm_set1_ps(p_value); }
+_FORCE_INLINE_ Float4 add(Float4 p_a, Float4 p_b) { return _mm_add_ps(p_a, p_b); }
+_FORCE_INLINE_ Float4 sub(Float4 p_a, Float4 p_b) { return _mm_sub_ps(p_a, p_b); }
+_FORCE_INLINE_ Float4 mul(Float4 p_a, Float4 p_b) { return _mm_mul_ps(p_a, p_b); }
+_FORCE_INLINE_ Float4 div(Float4 p_a, Float4 p_b) { return _mm_div_ps(p_a, p_b); }
+_FORCE_INLINE_ Float4 sqrt(Float4 p_v) { return _mm_sqrt_ps(p_v); }
+// Same as MIN() and MAX(): p_b is returned when the values are unordered.
+_FORCE_INLINE_ Float4 min(Float4 p_a, Float4 p_b) { return _mm_min_ps(p_a, p_b); }
+_FORCE_INLINE_ Float4 max(Float4 p_a, Float4 p_b) { return _mm_max_ps(p_a, p_b); }
+
+// p_a + p_b in x, y and z, p_a - p_b in w. Subtracting (rather than adding a
+// negated w) keeps NaN signs identical to the scalar formulas.
+_FORCE_INLINE_ Float4 add_xyz_sub_w(Float4 p_a, Float4 p_b) {
+	const Float4 w = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+	return _mm_or_ps(_mm_andnot_ps(w, _mm_add_ps(p_a, p_b)), _mm_and_ps(w, _mm_sub_ps(p_a, p_b)));
+}
+
+// Lanes of p_v where p_test is zero become zero.
+_FORCE_INLINE_ Float4 clear_where_zero(Float4 p_v, Float4 p_test) {
+	return _mm_andnot_ps(_mm_cmpeq_ps(p_test, _mm_setzero_ps()), p_v);
+}
+
+_FORCE_INLINE_ float dot3(Float4 p_a, Float4 p_b) {
+	Float4 m = _mm_mul_ps(p_a, p_b);
+	Float4 s = _mm_add_ss(m, GODOT_SIMD_SHUFFLE(m, 1, 1, 1, 1));
+	return _mm_cvtss_f32(_mm_add_ss(s, _mm_movehl_ps(m, m)));
+}
+
+_FORCE_INLINE_ float dot4(Float4 p_a, Float4 p_b) {
+	Float4 m = _mm_mul_ps(p_a, p_b);
+	Float4 s = _mm_add_ss(m, GODOT_SIMD_SHUFFLE(m, 1, 1, 1, 1));
+	s = _mm_add_ss(s, _mm_movehl_ps(m, m));
+	return _mm_cvtss_f32(_mm_add_ss(s, GODOT_SIMD_SHUFFLE(m, 3, 3, 3, 3)));
+}
+
+#ifdef GODOT_SIMD_SSE4
+#define GODOT_SIMD_ROUNDING
+_FORCE_INLINE_ Float4 floor(Float4 p_v) { return _mm_floor_ps(p_v); }
+_FORCE_INLINE_ Float4 ceil(Float4 p_v) { return _mm_ceil_ps(p_v); }
+#endif
+
+#elif defined(GODOT_SIMD_NEON)
+
+typedef float32x4_t Float4;
+
+#if defined(__clang__) || __GNUC__ >= 12
+#define GODOT_SIMD_SHUFFLE(m_v, m_x, m_y, m_z, m_w) __builtin_shufflevector(m_v, m_v, m_x, m_y, m_z, m_w)
+#else
+#define GODOT_SIMD_SHUFFLE(m_v, m_x, m_y, m_z, m_w) __builtin_shuffle(m_v, (uint32x4_t){ m_x, m_y, m_z, m_w })
+#endif
+
+_FORCE_INLINE_ Float4 load4(const float *p_src) { return vld1q_f32(p_src); }
+_FORCE_INLINE_ void store4(float *p_dst, Float4 p_v) { vst1q_f32(p_dst, p_v); }
+
+_FORCE_INLINE_ Float4 load3(const float *p_src) {
+	return vcombine_f32(vld1_f32(p_src), vld1_lane_f32(p_src + 2, vdup_n_f32(0.0f), 0));
+}
+
+_FORCE_INLINE_ void store3(float *p_dst, Float4 p_v) {
+	vst1_f32(p_dst, vget_low_f32(p_v));
+	vst1q_lane_f32(p_dst + 2, p_v, 2);
+}
+
+_FORCE_INLINE_ Float4 splat(float p_value) { return vdupq_n_f32(p_value); }
+_FORCE_INLINE_ Float4 add(Float4 p_a, Float4 p_b) { return vaddq_f32(p_a, p_b); }
+_FORCE_INLINE_ Float4 sub(Float4 p_a, Float4 p_b) { return vsubq_f32(p_a, p_b); }
+_FORCE_INLINE_ Float4 mul(Float4 p_a, Float4 p_b) { return vmulq_f32(p_a, p_b); }
+_FORCE_INLINE_ Float4 div(Float4 p_a, Float4 p_b) { return vdivq_f32(p_a, p_b); }
+_FORCE_INLINE_ Float4 sqrt(Float4 p_v) { return vsqrtq_f32(p_v); }
+// vminq_f32() and vmaxq_f32() propagate NaNs, select like MIN() and MAX() instead.
+_FORCE_INLINE_ Float4 min(Float4 p_a, Float4 p_b) { return vbslq_f32(vcltq_f32(p_a, p_b), p_a, p_b); }
+_FORCE_INLINE_ Float4 max(Float4 p_a, Float4 p_b) { return vbslq_f32(vcgtq_f32(p_a, p_b), p_a, p_b); }
+
+_FORCE_INLINE_ Float4 add_xyz_sub_w(Float4 p_a, Float4 p_b) {
+	const uint32x4_t w = { 0, 0, 0, 0xFFFFFFFF };
+	return vbslq_f32(w, vsubq_f32(p_a, p_b), vaddq_f32(p_a, p_b));
+}
+
+_FORCE_INLINE_ Float4 clear_where_zero(Float4 p_v, Float4 p_test) {
+	return vbslq_f32(vceqzq_f32(p_test), vdupq_n_f32(0.0f), p_v);
+}
+
+_FORCE_INLINE_ float dot3(Float4 p_a, Float4 p_b) {
+	Float4 m = vmulq_f32(p_a, p_b);
+	return vpadds_f32(vget_low_f32(m)) + vgetq_lane_f32(m, 2);
+}
+
+_FORCE_INLINE_ float dot4(Float4 p_a, Float4 p_b) {
+	Float4 m = vmulq_f32(p_a, p_b);
+	return vpadds_f32(vget_low_f32(m)) + vgetq_lane_f32(m, 2) + vgetq_lane_f32(m, 3);
+}
+
+#define GODOT_SIMD_ROUNDING
+_FORCE_INLINE_ Float4 floor(Float4 p_v) { return vrndmq_f32(p_v); }
+_FORCE_INLINE_ Float4 ceil(Float4 p_v) { return vrndpq_f32(p_v); }
+
+#endif
+
+// (y * b.z - z * b.y, z * b.x - x * b.z, x * b.y - y * b.x).
+_FORCE_INLINE_ Float4 cross3(Float4 p_a, Float4 p_b) {
+	Float4 a_yzx = GODOT_SIMD_SHUFFLE(p_a, 1, 2, 0, 3);
+	Float4 a_zxy = GODOT_SIMD_SHUFFLE(p_a, 2, 0, 1, 3);
+	Float4 b_yzx = GODOT_SIMD_SHUFFLE(p_b, 1, 2, 0, 3);
+	Float4 b_zxy = GODOT_SIMD_SHUFFLE(p_b, 2, 0, 1, 3);
+	return sub(mul(a_yzx, b_zxy), mul(a_zxy, b_yzx));
+}
+
+// p_from + p_weight * (p_to - p_from), no fused multiply-add.
+_FORCE_INLINE_ Float4 lerp(Float4 p_from, Float4 p_to, float p_weight) {
+	return add(p_from, mul(splat(p_weight), sub(p_to, p_from)));
+}
+
+// Hamilton product of two (x, y, z, w) quaternions, see Quaternion::operator*=().
+_FORCE_INLINE_ Float4 quaternion_multiply(Float4 p_a, Float4 p_b) {
+	Float4 r = mul(GODOT_SIMD_SHUFFLE(p_a, 3, 3, 3, 3), p_b);
+	r = add_xyz_sub_w(r, mul(GODOT_SIMD_SHUFFLE(p_a, 0, 1, 2, 0), GODOT_SIMD_SHUFFLE(p_b, 3, 3, 3, 0)));
+	r = add_xyz_sub_w(r, mul(GODOT_SIMD_SHUFFLE(p_a, 1, 2, 0, 1), GODOT_SIMD_SHUFFLE(p_b, 2, 0, 1, 1)));
+	return sub(r, mul(GODOT_SIMD_SHUFFLE(p_a, 2, 0, 1, 2), GODOT_SIMD_SHUFFLE(p_b, 1, 2, 0, 2)));
+}
+
+// Rotates the vector p_v by the unit quaternion p_q, see Quaternion::xform().
+_FORCE_INLINE_ Float4 quaternion_xform(Float4 p_q, Float4 p_v) {
+	Float4 uv = cross3(p_q, p_v);
+	Float4 t = add(mul(uv, GODOT_SIMD_SHUFFLE(p_q, 3, 3, 3, 3)), cross3(p_q, uv));
+	return add(p_v, mul(t, splat(2.0f)));
+}
+
+} // namespace Simd
+
+} // namespace godot
+
+#endif // GODOT_SIMD_ENABLED
+
+#endif // GODOT_SIMD_HPP
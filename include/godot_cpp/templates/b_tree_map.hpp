@@ -0,0 +1,841 @@
+/**************************************************************************/
+/*  b_tree_map.hpp                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GODOT_B_TREE_MAP_HPP
+#define GODOT_B_TREE_MAP_HPP
+
+#include <godot_cpp/core/error_macros.hpp>
+#include <godot_cpp/core/memory.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/templates/pair.hpp>
+
+#include <type_traits>
+
+namespace godot {
+
+/**
+ * An ordered map implemented as a B+ tree, as an alternative to RBMap for
+ * large maps.
+ *
+ * Every node holds up to NODE_CAPACITY keys in contiguous arrays, and the
+ * key/value pairs only live in the leaves, which are linked together. This
+ * makes lookups touch a handful of cache lines instead of one node per
+ * level, and ordered iteration or range queries (lower_bound() and
+ * upper_bound() followed by iteration) walk memory sequentially.
+ *
+ * Unlike RBMap, elements move around when the tree changes: inserting or
+ * erasing invalidates iterators and pointers, and lookups return iterators
+ * instead of Element pointers. Keys must be default constructible, as
+ * copies of them are kept in the inner nodes.
+ *
+ * A map can be built from sorted data in linear time with bulk_load().
+ */
+
+template <class K, class V, class C = Comparator<K>, uint32_t NODE_CAPACITY = 32>
+class BTreeMap {
+	static_assert(NODE_CAPACITY >= 4, "BTreeMap nodes need a capacity of at least 4.");
+
+	typedef KeyValue<K, V> Pair;
+
+	static constexpr uint32_t MIN_LEAF = NODE_CAPACITY / 2;
+	static constexpr uint32_t MIN_INNER = (NODE_CAPACITY - 1) / 2;
+	static constexpr uint32_t MAX_DEPTH = 64;
+
+	struct Node {
+		uint32_t count = 0;
+		bool leaf = true;
+	};
+
+	struct LeafNode : public Node {
+		LeafNode *prev = nullptr;
+		LeafNode *next = nullptr;
+		alignas(Pair) uint8_t data[sizeof(Pair) * NODE_CAPACITY];
+
+		_FORCE_INLINE_ Pair *pairs() { return reinterpret_cast<Pair *>(data); }
+		_FORCE_INLINE_ const Pair *pairs() const { return reinterpret_cast<const Pair *>(data); }
+	};
+
+	struct InnerNode : public Node {
+		// All the keys under children[i] are smaller than keys[i], which is smaller or equal to the keys under children[i + 1].
+		K keys[NODE_CAPACITY];
+		Node *children[NODE_CAPACITY + 1];
+
+		InnerNode() { this->leaf = false; }
+	};
+
+	Node *root = nullptr;
+	LeafNode *first_leaf = nullptr;
+	LeafNode *last_leaf = nullptr;
+	uint32_t element_count = 0;
+
+public:
+	C compare;
+
+	struct Iterator {
+		_FORCE_INLINE_ KeyValue<K, V> &operator*() const {
+			return leaf->pairs()[index];
+		}
+		_FORCE_INLINE_ KeyValue<K, V> *operator->() const { return &leaf->pairs()[index]; }
+		_FORCE_INLINE_ Iterator &operator++() {
+			if (leaf && ++index >= leaf->count) {
+				leaf = leaf->next;
+				index = 0;
+			}
+			return *this;
+		}
+		_FORCE_INLINE_ Iterator &operator--() {
+			if (leaf) {
+				if (index == 0) {
+					leaf = leaf->prev;
+					index = leaf ? leaf->count - 1 : 0;
+				} else {
+					index--;
+				}
+			}
+			return *this;
+		}
+
+		_FORCE_INLINE_ bool operator==(const Iterator &b) const { return leaf == b.leaf && index == b.index; }
+		_FORCE_INLINE_ bool operator!=(const Iterator &b) const { return leaf != b.leaf || index != b.index; }
+		explicit operator bool() const {
+			return leaf != nullptr;
+		}
+		Iterator(LeafNode *p_leaf, uint32_t p_index) {
+			leaf = p_leaf;
+			index = p_index;
+		}
+		Iterator() {}
+
+	private:
+		friend class BTreeMap;
+		LeafNode *leaf = nullptr;
+		uint32_t index = 0;
+	};
+
+	struct ConstIterator {
+		_FORCE_INLINE_ const KeyValue<K, V> &operator*() const {
+			return leaf->pairs()[index];
+		}
+		_FORCE_INLINE_ const KeyValue<K, V> *operator->() const { return &leaf->pairs()[index]; }
+		_FORCE_INLINE_ ConstIterator &operator++() {
+			if (leaf && ++index >= leaf->count) {
+				leaf = leaf->next;
+				index = 0;
+			}
+			return *this;
+		}
+		_FORCE_INLINE_ ConstIterator &operator--() {
+			if (leaf) {
+				if (index == 0) {
+					leaf = leaf->prev;
+					index = leaf ? leaf->count - 1 : 0;
+				} else {
+					index--;
+				}
+			}
+			return *this;
+		}
+
+		_FORCE_INLINE_ bool operator==(const ConstIterator &b) const { return leaf == b.leaf && index == b.index; }
+		_FORCE_INLINE_ bool operator!=(const ConstIterator &b) const { return leaf != b.leaf || index != b.index; }
+		explicit operator bool() const {
+			return leaf != nullptr;
+		}
+		ConstIterator(const LeafNode *p_leaf, uint32_t p_index) {
+			leaf = p_leaf;
+			index = p_index;
+		}
+		ConstIterator(const Iterator &p_it) {
+			leaf = p_it.leaf;
+			index = p_it.index;
+		}
+		ConstIterator() {}
+
+	private:
+		const LeafNode *leaf = nullptr;
+		uint32_t index = 0;
+	};
+
+private:
+	// Moves constructed pairs to uninitialized memory. Ranges may overlap, as long
+	// as the part of the destination outside of the source is uninitialized.
+	static void _relocate(Pair *p_dst, Pair *p_src, uint32_t p_count) {
+		if (p_count == 0 || p_dst == p_src) {
+			return;
+		}
+		if constexpr (std::is_trivially_copyable<K>::value && std::is_trivially_copyable<V>::value) {
+			memmove((void *)p_dst, (const void *)p_src, sizeof(Pair) * p_count);
+		} else if (p_dst < p_src) {
+			for (uint32_t i = 0; i < p_count; i++) {
+				memnew_placement(&p_dst[i], Pair(p_src[i]));
+				p_src[i].~Pair();
+			}
+		} else {
+			for (uint32_t i = p_count; i-- > 0;) {
+				memnew_placement(&p_dst[i], Pair(p_src[i]));
+				p_src[i].~Pair();
+			}
+		}
+	}
+
+	// Index of the first pair whose key is not smaller than p_key.
+	_FORCE_INLINE_ uint32_t _leaf_lower_bound(const LeafNode *p_leaf, const K &p_key) const {
+		uint32_t low = 0;
+		uint32_t high = p_leaf->count;
+		while (low < high) {
+			uint32_t mid = (low + high) / 2;
+			if (compare(p_leaf->pairs()[mid].key, p_key)) {
+				low = mid + 1;
+			} else {
+				high = mid;
+			}
+		}
+		return low;
+	}
+
+	// Index of the first pair whose key is greater than p_key.
+	_FORCE_INLINE_ uint32_t _leaf_upper_bound(const LeafNode *p_leaf, const K &p_key) const {
+		uint32_t low = 0;
+		uint32_t high = p_leaf->count;
+		while (low < high) {
+			uint32_t mid = (low + high) / 2;
+			if (compare(p_key, p_leaf->pairs()[mid].key)) {
+				high = mid;
+			} else {
+				low = mid + 1;
+			}
+		}
+		return low;
+	}
+
+	_FORCE_INLINE_ uint32_t _child_index(const InnerNode *p_node, const K &p_key) const {
+		uint32_t low = 0;
+		uint32_t high = p_node->count;
+		while (low < high) {
+			uint32_t mid = (low + high) / 2;
+			if (compare(p_key, p_node->keys[mid])) {
+				high = mid;
+			} else {
+				low = mid + 1;
+			}
+		}
+		return low;
+	}
+
+	_FORCE_INLINE_ LeafNode *_find_leaf(const K &p_key) const {
+		Node *node = root;
+		while (!node->leaf) {
+			InnerNode *inner = static_cast<InnerNode *>(node);
+			node = inner->children[_child_index(inner, p_key)];
+		}
+		return static_cast<LeafNode *>(node);
+	}
+
+	void _leaf_insert_at(LeafNode *p_leaf, uint32_t p_pos, const K &p_key, const V &p_value) {
+		_relocate(p_leaf->pairs() + p_pos + 1, p_leaf->pairs() + p_pos, p_leaf->count - p_pos);
+		memnew_placement(&p_leaf->pairs()[p_pos], Pair(p_key, p_value));
+		p_leaf->count++;
+	}
+
+	void _leaf_remove_at(LeafNode *p_leaf, uint32_t p_pos) {
+		p_leaf->pairs()[p_pos].~Pair();
+		_relocate(p_leaf->pairs() + p_pos, p_leaf->pairs() + p_pos + 1, p_leaf->count - p_pos - 1);
+		p_leaf->count--;
+	}
+
+	// Inserts p_key at p_pos, and p_child right after it.
+	void _inner_insert_at(InnerNode *p_node, uint32_t p_pos, const K &p_key, Node *p_child) {
+		for (uint32_t i = p_node->count; i > p_pos; i--) {
+			p_node->keys[i] = p_node->keys[i - 1];
+			p_node->children[i + 1] = p_node->children[i];
+		}
+		p_node->keys[p_pos] = p_key;
+		p_node->children[p_pos + 1] = p_child;
+		p_node->count++;
+	}
+
+	// Removes the key at p_pos, and the child right after it.
+	void _inner_remove_at(InnerNode *p_node, uint32_t p_pos) {
+		for (uint32_t i = p_pos + 1; i < p_node->count; i++) {
+			p_node->keys[i - 1] = p_node->keys[i];
+			p_node->children[i] = p_node->children[i + 1];
+		}
+		p_node->count--;
+	}
+
+	void _merge_leaves(LeafNode *p_left, LeafNode *p_right) {
+		_relocate(p_left->pairs() + p_left->count, p_right->pairs(), p_right->count);
+		p_left->count += p_right->count;
+		p_right->count = 0;
+
+		p_left->next = p_right->next;
+		if (p_right->next) {
+			p_right->next->prev = p_left;
+		} else {
+			last_leaf = p_left;
+		}
+		memdelete(p_right);
+	}
+
+	void _merge_inner(InnerNode *p_left, const K &p_separator, InnerNode *p_right) {
+		p_left->keys[p_left->count] = p_separator;
+		for (uint32_t i = 0; i < p_right->count; i++) {
+			p_left->keys[p_left->count + 1 + i] = p_right->keys[i];
+		}
+		for (uint32_t i = 0; i <= p_right->count; i++) {
+			p_left->children[p_left->count + 1 + i] = p_right->children[i];
+		}
+		p_left->count += p_right->count + 1;
+		memdelete(p_right);
+	}
+
+	void _free_node(Node *p_node) {
+		if (p_node->leaf) {
+			LeafNode *leaf = static_cast<LeafNode *>(p_node);
+			if (!std::is_trivially_destructible<Pair>::value) {
+				for (uint32_t i = 0; i < leaf->count; i++) {
+					leaf->pairs()[i].~Pair();
+				}
+			}
+			memdelete(leaf);
+		} else {
+			InnerNode *inner = static_cast<InnerNode *>(p_node);
+			for (uint32_t i = 0; i <= inner->count; i++) {
+				_free_node(inner->children[i]);
+			}
+			memdelete(inner);
+		}
+	}
+
+	// Rebalances the nodes along p_path after a pair was removed from p_leaf.
+	void _rebalance(LeafNode *p_leaf, InnerNode **p_path, uint32_t *p_path_index, uint32_t p_depth) {
+		if (p_depth == 0) {
+			// The leaf is the root, it can hold any amount of pairs.
+			if (p_leaf->count == 0) {
+				memdelete(p_leaf);
+				root = nullptr;
+				first_leaf = nullptr;
+				last_leaf = nullptr;
+			}
+			return;
+		}
+
+		if (p_leaf->count >= MIN_LEAF) {
+			return;
+		}
+
+		InnerNode *parent = p_path[p_depth - 1];
+		uint32_t index = p_path_index[p_depth - 1];
+		LeafNode *left = index > 0 ? static_cast<LeafNode *>(parent->children[index - 1]) : nullptr;
+		LeafNode *right = index < parent->count ? static_cast<LeafNode *>(parent->children[index + 1]) : nullptr;
+
+		if (left && left->count > MIN_LEAF) {
+			// Borrow the last pair of the left sibling.
+			_relocate(p_leaf->pairs() + 1, p_leaf->pairs(), p_leaf->count);
+			_relocate(p_leaf->pairs(), left->pairs() + left->count - 1, 1);
+			left->count--;
+			p_leaf->count++;
+			parent->keys[index - 1] = p_leaf->pairs()[0].key;
+			return;
+		}
+
+		if (right && right->count > MIN_LEAF) {
+			// Borrow the first pair of the right sibling.
+			_relocate(p_leaf->pairs() + p_leaf->count, right->pairs(), 1);
+			_relocate(right->pairs(), right->pairs() + 1, right->count - 1);
+			right->count--;
+			p_leaf->count++;
+			parent->keys[index] = right->pairs()[0].key;
+			return;
+		}
+
+		if (left) {
+			_merge_leaves(left, p_leaf);
+			_inner_remove_at(parent, index - 1);
+		} else {
+			_merge_leaves(p_leaf, right);
+			_inner_remove_at(parent, index);
+		}
+
+		// The parent lost a child, walk up while inner nodes underflow.
+		for (uint32_t d = p_depth - 1;; d--) {
+			InnerNode *node = p_path[d];
+
+			if (d == 0) {
+				if (node->count == 0) {
+					// Root with a single child left, shrink the tree.
+					root = node->children[0];
+					memdelete(node);
+				}
+				return;
+			}
+
+			if (node->count >= MIN_INNER) {
+				return;
+			}
+
+			InnerNode *node_parent = p_path[d - 1];
+			uint32_t node_index = p_path_index[d - 1];
+			InnerNode *node_left = node_index > 0 ? static_cast<InnerNode *>(node_parent->children[node_index - 1]) : nullptr;
+			InnerNode *node_right = node_index < node_parent->count ? static_cast<InnerNode *>(node_parent->children[node_index + 1]) : nullptr;
+
+			if (node_left && node_left->count > MIN_INNER) {
+				// Rotate the last child of the left sibling through the parent.
+				node->children[node->count + 1] = node->children[node->count];
+				for (uint32_t i = node->count; i > 0; i--) {
+					node->keys[i] = node->keys[i - 1];
+					node->children[i] = node->children[i - 1];
+				}
+				node->keys[0] = node_parent->keys[node_index - 1];
+				node->children[0] = node_left->children[node_left->count];
+				node_parent->keys[node_index - 1] = node_left->keys[node_left->count - 1];
+				node_left->count--;
+				node->count++;
+				return;
+			}
+
+			if (node_right && node_right->count > MIN_INNER) {
+				// Rotate the first child of the right sibling through the parent.
+				node->keys[node->count] = node_parent->keys[node_index];
+				node->children[node->count + 1] = node_right->children[0];
+				node_parent->keys[node_index] = node_right->keys[0];
+				for (uint32_t i = 1; i < node_right->count; i++) {
+					node_right->keys[i - 1] = node_right->keys[i];
+				}
+				for (uint32_t i = 1; i <= node_right->count; i++) {
+					node_right->children[i - 1] = node_right->children[i];
+				}
+				node_right->count--;
+				node->count++;
+				return;
+			}
+
+			if (node_left) {
+				_merge_inner(node_left, node_parent->keys[node_index - 1], node);
+				_inner_remove_at(node_parent, node_index - 1);
+			} else {
+				_merge_inner(node, node_parent->keys[node_index], node_right);
+				_inner_remove_at(node_parent, node_index);
+			}
+		}
+	}
+
+	struct ArraySource {
+		const K *keys = nullptr;
+		const V *values = nullptr;
+		uint32_t index = 0;
+
+		_FORCE_INLINE_ Pair get() const { return Pair(keys[index], values ? values[index] : V()); }
+		_FORCE_INLINE_ void next() { index++; }
+	};
+
+	struct MapSource {
+		ConstIterator it;
+
+		_FORCE_INLINE_ const Pair &get() const { return *it; }
+		_FORCE_INLINE_ void next() { ++it; }
+	};
+
+	// Builds the tree bottom up, with nodes filled evenly.
+	template <class S>
+	void _bulk_load(S &p_source, uint32_t p_count) {
+		clear();
+		if (p_count == 0) {
+			return;
+		}
+
+		LocalVector<Node *> level;
+		LocalVector<const K *> level_min_keys;
+
+		uint32_t leaf_count = (p_count + NODE_CAPACITY - 1) / NODE_CAPACITY;
+		level.resize(leaf_count);
+		level_min_keys.resize(leaf_count);
+
+		LeafNode *prev = nullptr;
+		for (uint32_t l = 0; l < leaf_count; l++) {
+			uint32_t count = (uint32_t)((uint64_t)p_count * (l + 1) / leaf_count - (uint64_t)p_count * l / leaf_count);
+
+			LeafNode *leaf = memnew(LeafNode);
+			for (uint32_t i = 0; i < count; i++) {
+				memnew_placement(&leaf->pairs()[i], Pair(p_source.get()));
+				p_source.next();
+			}
+			leaf->count = count;
+
+			leaf->prev = prev;
+			if (prev) {
+				prev->next = leaf;
+			} else {
+				first_leaf = leaf;
+			}
+			prev = leaf;
+
+			level[l] = leaf;
+			level_min_keys[l] = &leaf->pairs()[0].key;
+		}
+		last_leaf = prev;
+
+		while (level.size() > 1) {
+			uint32_t child_count = level.size();
+			uint32_t node_count = (child_count + NODE_CAPACITY) / (NODE_CAPACITY + 1);
+
+			for (uint32_t n = 0; n < node_count; n++) {
+				uint32_t from = (uint32_t)((uint64_t)child_count * n / node_count);
+				uint32_t to = (uint32_t)((uint64_t)child_count * (n + 1) / node_count);
+
+				InnerNode *inner = memnew(InnerNode);
+				inner->count = to - from - 1;
+				for (uint32_t i = from; i < to; i++) {
+					inner->children[i - from] = level[i];
+					if (i > from) {
+						inner->keys[i - from - 1] = *level_min_keys[i];
+					}
+				}
+
+				// Nodes are built in order, so writing over the current level is safe.
+				level_min_keys[n] = level_min_keys[from];
+				level[n] = inner;
+			}
+
+			level.resize(node_count);
+			level_min_keys.resize(node_count);
+		}
+
+		root = level[0];
+		element_count = p_count;
+	}
+
+public:
+	_FORCE_INLINE_ uint32_t size() const { return element_count; }
+	_FORCE_INLINE_ bool is_empty() const { return element_count == 0; }
+
+	void clear() {
+		if (root) {
+			_free_node(root);
+		}
+		root = nullptr;
+		first_leaf = nullptr;
+		last_leaf = nullptr;
+		element_count = 0;
+	}
+
+	Iterator find(const K &p_key) {
+		if (!root) {
+			return Iterator();
+		}
+		LeafNode *leaf = _find_leaf(p_key);
+		uint32_t pos = _leaf_lower_bound(leaf, p_key);
+		if (pos < leaf->count && !compare(p_key, leaf->pairs()[pos].key)) {
+			return Iterator(leaf, pos);
+		}
+		return Iterator();
+	}
+
+	ConstIterator find(const K &p_key) const {
+		return const_cast<BTreeMap *>(this)->find(p_key);
+	}
+
+	bool has(const K &p_key) const {
+		return bool(find(p_key));
+	}
+
+	// First element whose key is not smaller than p_key.
+	Iterator lower_bound(const K &p_key) {
+		if (!root) {
+			return Iterator();
+		}
+		LeafNode *leaf = _find_leaf(p_key);
+		uint32_t pos = _leaf_lower_bound(leaf, p_key);
+		if (pos == leaf->count) {
+			return Iterator(leaf->next, 0);
+		}
+		return Iterator(leaf, pos);
+	}
+
+	ConstIterator lower_bound(const K &p_key) const {
+		return const_cast<BTreeMap *>(this)->lower_bound(p_key);
+	}
+
+	// First element whose key is greater than p_key.
+	Iterator upper_bound(const K &p_key) {
+		if (!root) {
+			return Iterator();
+		}
+		LeafNode *leaf = _find_leaf(p_key);
+		uint32_t pos = _leaf_upper_bound(leaf, p_key);
+		if (pos == leaf->count) {
+			return Iterator(leaf->next, 0);
+		}
+		return Iterator(leaf, pos);
+	}
+
+	ConstIterator upper_bound(const K &p_key) const {
+		return const_cast<BTreeMap *>(this)->upper_bound(p_key);
+	}
+
+	// Last element whose key is not greater than p_key, like RBMap::find_closest().
+	Iterator find_closest(const K &p_key) {
+		Iterator it = upper_bound(p_key);
+		if (!it) {
+			return last();
+		}
+		return --it;
+	}
+
+	ConstIterator find_closest(const K &p_key) const {
+		return const_cast<BTreeMap *>(this)->find_closest(p_key);
+	}
+
+	Iterator insert(const K &p_key, const V &p_value) {
+		if (!root) {
+			LeafNode *leaf = memnew(LeafNode);
+			root = leaf;
+			first_leaf = leaf;
+			last_leaf = leaf;
+		}
+
+		InnerNode *path[MAX_DEPTH];
+		uint32_t path_index[MAX_DEPTH];
+		uint32_t depth = 0;
+
+		Node *node = root;
+		while (!node->leaf) {
+			InnerNode *inner = static_cast<InnerNode *>(node);
+			uint32_t index = _child_index(inner, p_key);
+			path[depth] = inner;
+			path_index[depth] = index;
+			depth++;
+			node = inner->children[index];
+		}
+
+		LeafNode *leaf = static_cast<LeafNode *>(node);
+		uint32_t pos = _leaf_lower_bound(leaf, p_key);
+		if (pos < leaf->count && !compare(p_key, leaf->pairs()[pos].key)) {
+			leaf->pairs()[pos].value = p_value;
+			return Iterator(leaf, pos);
+		}
+
+		element_count++;
+
+		if (leaf->count < NODE_CAPACITY) {
+			_leaf_insert_at(leaf, pos, p_key, p_value);
+			return Iterator(leaf, pos);
+		}
+
+		// The leaf is full, split it in two halves.
+		LeafNode *right = memnew(LeafNode);
+		right->prev = leaf;
+		right->next = leaf->next;
+		if (leaf->next) {
+			leaf->next->prev = right;
+		} else {
+			last_leaf = right;
+		}
+		leaf->next = right;
+
+		const uint32_t mid = (NODE_CAPACITY + 1) / 2;
+		Iterator ret;
+		if (pos < mid) {
+			_relocate(right->pairs(), leaf->pairs() + mid - 1, NODE_CAPACITY - mid + 1);
+			right->count = NODE_CAPACITY - mid + 1;
+			leaf->count = mid - 1;
+			_leaf_insert_at(leaf, pos, p_key, p_value);
+			ret = Iterator(leaf, pos);
+		} else {
+			_relocate(right->pairs(), leaf->pairs() + mid, NODE_CAPACITY - mid);
+			right->count = NODE_CAPACITY - mid;
+			leaf->count = mid;
+			_leaf_insert_at(right, pos - mid, p_key, p_value);
+			ret = Iterator(right, pos - mid);
+		}
+
+		// Insert the new node in the parent, splitting inner nodes up the path as needed.
+		K separator = right->pairs()[0].key;
+		Node *new_node = right;
+
+		while (depth > 0) {
+			depth--;
+			InnerNode *parent = path[depth];
+			uint32_t index = path_index[depth];
+
+			if (parent->count < NODE_CAPACITY) {
+				_inner_insert_at(parent, index, separator, new_node);
+				return ret;
+			}
+
+			K keys[NODE_CAPACITY + 1];
+			Node *children[NODE_CAPACITY + 2];
+			for (uint32_t i = 0, j = 0; i <= NODE_CAPACITY; i++) {
+				keys[i] = i == index ? separator : parent->keys[j++];
+			}
+			for (uint32_t i = 0, j = 0; i <= NODE_CAPACITY + 1; i++) {
+				children[i] = i == index + 1 ? new_node : parent->children[j++];
+			}
+
+			InnerNode *right_inner = memnew(InnerNode);
+			parent->count = mid;
+			right_inner->count = NODE_CAPACITY - mid;
+			for (uint32_t i = 0; i < mid; i++) {
+				parent->keys[i] = keys[i];
+			}
+			for (uint32_t i = 0; i <= mid; i++) {
+				parent->children[i] = children[i];
+			}
+			for (uint32_t i = 0; i < right_inner->count; i++) {
+				right_inner->keys[i] = keys[mid + 1 + i];
+			}
+			for (uint32_t i = 0; i <= right_inner->count; i++) {
+				right_inner->children[i] = children[mid + 1 + i];
+			}
+
+			separator = keys[mid];
+			new_node = right_inner;
+		}
+
+		// The root was split, grow the tree by one level.
+		InnerNode *new_root = memnew(InnerNode);
+		new_root->count = 1;
+		new_root->keys[0] = separator;
+		new_root->children[0] = root;
+		new_root->children[1] = new_node;
+		root = new_root;
+
+		return ret;
+	}
+
+	bool erase(const K &p_key) {
+		if (!root) {
+			return false;
+		}
+
+		InnerNode *path[MAX_DEPTH];
+		uint32_t path_index[MAX_DEPTH];
+		uint32_t depth = 0;
+
+		Node *node = root;
+		while (!node->leaf) {
+			InnerNode *inner = static_cast<InnerNode *>(node);
+			uint32_t index = _child_index(inner, p_key);
+			path[depth] = inner;
+			path_index[depth] = index;
+			depth++;
+			node = inner->children[index];
+		}
+
+		LeafNode *leaf = static_cast<LeafNode *>(node);
+		uint32_t pos = _leaf_lower_bound(leaf, p_key);
+		if (pos == leaf->count || compare(p_key, leaf->pairs()[pos].key)) {
+			return false;
+		}
+
+		_leaf_remove_at(leaf, pos);
+		element_count--;
+		_rebalance(leaf, path, path_index, depth);
+		return true;
+	}
+
+	void remove(const Iterator &p_iter) {
+		if (p_iter) {
+			K key = p_iter->key;
+			erase(key);
+		}
+	}
+
+	// Replaces the contents with p_count pairs, whose keys must be sorted and unique.
+	// p_values can be null, to use default constructed values.
+	void bulk_load(const K *p_keys, const V *p_values, uint32_t p_count) {
+		for (uint32_t i = 1; i < p_count; i++) {
+			ERR_FAIL_COND_MSG(!compare(p_keys[i - 1], p_keys[i]), "BTreeMap::bulk_load() requires sorted, unique keys.");
+		}
+		ArraySource source;
+		source.keys = p_keys;
+		source.values = p_values;
+		_bulk_load(source, p_count);
+	}
+
+	const V &operator[](const K &p_key) const {
+		ConstIterator it = find(p_key);
+		CRASH_COND(!it);
+		return it->value;
+	}
+
+	V &operator[](const K &p_key) {
+		Iterator it = find(p_key);
+		if (!it) {
+			it = insert(p_key, V());
+		}
+		return it->value;
+	}
+
+	_FORCE_INLINE_ Iterator begin() {
+		return Iterator(first_leaf, 0);
+	}
+	_FORCE_INLINE_ Iterator end() {
+		return Iterator();
+	}
+	_FORCE_INLINE_ Iterator last() {
+		return last_leaf ? Iterator(last_leaf, last_leaf->count - 1) : Iterator();
+	}
+
+	_FORCE_INLINE_ ConstIterator begin() const {
+		return ConstIterator(first_leaf, 0);
+	}
+	_FORCE_INLINE_ ConstIterator end() const {
+		return ConstIterator();
+	}
+	_FORCE_INLINE_ ConstIterator last() const {
+		return last_leaf ? ConstIterator(last_leaf, last_leaf->count - 1) : ConstIterator();
+	}
+
+	void operator=(const BTreeMap &p_other) {
+		if (this == &p_other) {
+			return; // Ignore self assignment.
+		}
+		MapSource source;
+		source.it = p_other.begin();
+		_bulk_load(source, p_other.size());
+	}
+
+	BTreeMap(const BTreeMap &p_other) {
+		MapSource source;
+		source.it = p_other.begin();
+		_bulk_load(source, p_other.size());
+	}
+
+	_FORCE_INLINE_ BTreeMap() {}
+
+	~BTreeMap() {
+		clear();
+	}
+};
+
+} // namespace godot
+
+#endif // GODOT_B_TREE_MAP_HPP
@@ -0,0 +1,109 @@
+/**************************************************************************/
+/*  b_tree_set.hpp                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GODOT_B_TREE_SET_HPP
+#define GODOT_B_TREE_SET_HPP
+
+#include <godot_cpp/templates/b_tree_map.hpp>
+
+namespace godot {
+
+/**
+ * An ordered set implemented as a B+ tree, the set counterpart of BTreeMap.
+ * See BTreeMap for the trade-offs compared to RBSet.
+ */
+
+template <class T, class C = Comparator<T>, uint32_t NODE_CAPACITY = 32>
+class BTreeSet {
+	struct Empty {};
+
+	typedef BTreeMap<T, Empty, C, NODE_CAPACITY> Map;
+	Map map;
+
+public:
+	struct Iterator {
+		_FORCE_INLINE_ const T &operator*() const {
+			return it->key;
+		}
+		_FORCE_INLINE_ const T *operator->() const {
+			return &it->key;
+		}
+		_FORCE_INLINE_ Iterator &operator++() {
+			++it;
+			return *this;
+		}
+		_FORCE_INLINE_ Iterator &operator--() {
+			--it;
+			return *this;
+		}
+
+		_FORCE_INLINE_ bool operator==(const Iterator &b) const { return it == b.it; }
+		_FORCE_INLINE_ bool operator!=(const Iterator &b) const { return it != b.it; }
+		explicit operator bool() const {
+			return bool(it);
+		}
+		Iterator(const typename Map::ConstIterator &p_it) {
+			it = p_it;
+		}
+		Iterator() {}
+
+	private:
+		typename Map::ConstIterator it;
+	};
+
+	_FORCE_INLINE_ uint32_t size() const { return map.size(); }
+	_FORCE_INLINE_ bool is_empty() const { return map.is_empty(); }
+	_FORCE_INLINE_ void clear() { map.clear(); }
+
+	_FORCE_INLINE_ Iterator find(const T &p_value) const { return map.find(p_value); }
+	_FORCE_INLINE_ bool has(const T &p_value) const { return map.has(p_value); }
+	_FORCE_INLINE_ Iterator lower_bound(const T &p_value) const { return map.lower_bound(p_value); }
+	_FORCE_INLINE_ Iterator upper_bound(const T &p_value) const { return map.upper_bound(p_value); }
+	_FORCE_INLINE_ Iterator find_closest(const T &p_value) const { return map.find_closest(p_value); }
+
+	_FORCE_INLINE_ Iterator insert(const T &p_value) { return typename Map::ConstIterator(map.insert(p_value, Empty())); }
+	_FORCE_INLINE_ bool erase(const T &p_value) { return map.erase(p_value); }
+
+	// Replaces the contents with p_count values, which must be sorted and unique.
+	_FORCE_INLINE_ void bulk_load(const T *p_values, uint32_t p_count) { map.bulk_load(p_values, nullptr, p_count); }
+
+	_FORCE_INLINE_ Iterator begin() const { return map.begin(); }
+	_FORCE_INLINE_ Iterator end() const { return map.end(); }
+	_FORCE_INLINE_ Iterator last() const { return map.last(); }
+
+	void operator=(const BTreeSet &p_other) { map = p_other.map; }
+	BTreeSet(const BTreeSet &p_other) :
+			map(p_other.map) {}
+	_FORCE_INLINE_ BTreeSet() {}
+};
+
+} // namespace godot
+
+#endif // GODOT_B_TREE_SET_HPP
@@ -0,0 +1,401 @@
+/**************************************************************************/
+/*  bit_vector.hpp                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GODOT_BIT_VECTOR_HPP
+#define GODOT_BIT_VECTOR_HPP
+
+#include <godot_cpp/core/error_macros.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GODOT_BIT_VECTOR_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+#define GODOT_BIT_VECTOR_NEON
+#include <arm_neon.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace godot {
+
+/**
+ * A dynamically sized array of bits, stored in 64-bit words.
+ *
+ * Meant for masks and occupancy grids: besides single bit access, it can count
+ * the bits that are set, find the next set or unset bit one word at a time,
+ * and combine whole bitsets with and/or/xor/and_not, two words per SIMD
+ * instruction when SSE2 or NEON is available.
+ *
+ * Bits past size() in the last word are always kept cleared, so counting and
+ * searching never need to mask them out.
+ */
+class BitVector {
+	static constexpr uint32_t WORD_BITS = 64;
+
+	LocalVector<uint64_t> words;
+	uint32_t bit_count = 0;
+
+	static _FORCE_INLINE_ uint32_t _word_count(uint32_t p_bits) {
+		return (p_bits + WORD_BITS - 1) / WORD_BITS;
+	}
+
+	static _FORCE_INLINE_ uint32_t _popcount(uint64_t p_word) {
+#if defined(__GNUC__)
+		return (uint32_t)__builtin_popcountll(p_word);
+#elif defined(_MSC_VER) && defined(_M_X64)
+		return (uint32_t)__popcnt64(p_word);
+#else
+		p_word = p_word - ((p_word >> 1) & 0x5555555555555555ULL);
+		p_word = (p_word & 0x3333333333333333ULL) + ((p_word >> 2) & 0x3333333333333333ULL);
+		p_word = (p_word + (p_word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+		return (uint32_t)((p_word * 0x0101010101010101ULL) >> 56);
+#endif
+	}
+
+	// p_word must not be zero.
+	static _FORCE_INLINE_ uint32_t _lowest_bit(uint64_t p_word) {
+#if defined(__GNUC__)
+		return (uint32_t)__builtin_ctzll(p_word);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+		unsigned long index;
+		_BitScanForward64(&index, p_word);
+		return index;
+#else
+		uint32_t index = 0;
+		while (!(p_word & 1)) {
+			p_word >>= 1;
+			index++;
+		}
+		return index;
+#endif
+	}
+
+	_FORCE_INLINE_ void _clear_tail() {
+		uint32_t tail = bit_count % WORD_BITS;
+		if (tail) {
+			words[words.size() - 1] &= (uint64_t(1) << tail) - 1;
+		}
+	}
+
+	struct OpAnd {
+		static _FORCE_INLINE_ uint64_t word(uint64_t a, uint64_t b) { return a & b; }
+#if defined(GODOT_BIT_VECTOR_SSE2)
+		static _FORCE_INLINE_ __m128i vec(__m128i a, __m128i b) { return _mm_and_si128(a, b); }
+#elif defined(GODOT_BIT_VECTOR_NEON)
+		static _FORCE_INLINE_ uint64x2_t vec(uint64x2_t a, uint64x2_t b) { return vandq_u64(a, b); }
+#endif
+	};
+
+	struct OpOr {
+		static _FORCE_INLINE_ uint64_t word(uint64_t a, uint64_t b) { return a | b; }
+#if defined(GODOT_BIT_VECTOR_SSE2)
+		static _FORCE_INLINE_ __m128i vec(__m128i a, __m128i b) { return _mm_or_si128(a, b); }
+#elif defined(GODOT_BIT_VECTOR_NEON)
+		static _FORCE_INLINE_ uint64x2_t vec(uint64x2_t a, uint64x2_t b) { return vorrq_u64(a, b); }
+#endif
+	};
+
+	struct OpXor {
+		static _FORCE_INLINE_ uint64_t word(uint64_t a, uint64_t b) { return a ^ b; }
+#if defined(GODOT_BIT_VECTOR_SSE2)
+		static _FORCE_INLINE_ __m128i vec(__m128i a, __m128i b) { return _mm_xor_si128(a, b); }
+#elif defined(GODOT_BIT_VECTOR_NEON)
+		static _FORCE_INLINE_ uint64x2_t vec(uint64x2_t a, uint64x2_t b) { return veorq_u64(a, b); }
+#endif
+	};
+
+	struct OpAndNot {
+		static _FORCE_INLINE_ uint64_t word(uint64_t a, uint64_t b) { return a & ~b; }
+#if defined(GODOT_BIT_VECTOR_SSE2)
+		static _FORCE_INLINE_ __m128i vec(__m128i a, __m128i b) { return _mm_andnot_si128(b, a); }
+#elif defined(GODOT_BIT_VECTOR_NEON)
+		static _FORCE_INLINE_ uint64x2_t vec(uint64x2_t a, uint64x2_t b) { return vbicq_u64(a, b); }
+#endif
+	};
+
+	// Combines every word of this bitset with the matching word of p_other.
+	template <class Op>
+	void _apply(const BitVector &p_other) {
+		uint64_t *dst = words.ptr();
+		const uint64_t *src = p_other.words.ptr();
+		const uint32_t count = words.size();
+		uint32_t i = 0;
+#if defined(GODOT_BIT_VECTOR_SSE2)
+		for (; i + 2 <= count; i += 2) {
+			__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst + i));
+			__m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), Op::vec(a, b));
+		}
+#elif defined(GODOT_BIT_VECTOR_NEON)
+		for (; i + 2 <= count; i += 2) {
+			vst1q_u64(dst + i, Op::vec(vld1q_u64(dst + i), vld1q_u64(src + i)));
+		}
+#endif
+		for (; i < count; i++) {
+			dst[i] = Op::word(dst[i], src[i]);
+		}
+	}
+
+	// Finds the first bit at or after p_from whose value is p_value.
+	int64_t _find_next(uint32_t p_from, bool p_value) const {
+		if (p_from >= bit_count) {
+			return -1;
+		}
+		const uint64_t invert = p_value ? 0 : ~uint64_t(0);
+		uint32_t w = p_from / WORD_BITS;
+		uint64_t word = (words[w] ^ invert) & (~uint64_t(0) << (p_from % WORD_BITS));
+		while (true) {
+			if (word) {
+				uint32_t index = w * WORD_BITS + _lowest_bit(word);
+				return index < bit_count ? int64_t(index) : -1;
+			}
+			if (++w >= words.size()) {
+				return -1;
+			}
+			word = words[w] ^ invert;
+		}
+	}
+
+public:
+	_FORCE_INLINE_ uint32_t size() const { return bit_count; }
+	_FORCE_INLINE_ bool is_empty() const { return bit_count == 0; }
+
+	// Direct access to the storage, bit i is bit (i % 64) of word (i / 64).
+	_FORCE_INLINE_ uint64_t *ptrw() { return words.ptr(); }
+	_FORCE_INLINE_ const uint64_t *ptr() const { return words.ptr(); }
+	_FORCE_INLINE_ uint32_t get_word_count() const { return words.size(); }
+
+	void resize(uint32_t p_size, bool p_value = false) {
+		uint32_t old_size = bit_count;
+		uint32_t old_word_count = words.size();
+		words.resize(_word_count(p_size));
+		bit_count = p_size;
+		if (p_size > old_size) {
+			for (uint32_t i = old_word_count; i < words.size(); i++) {
+				words[i] = p_value ? ~uint64_t(0) : 0;
+			}
+			if (p_value && old_size % WORD_BITS) {
+				words[old_size / WORD_BITS] |= ~uint64_t(0) << (old_size % WORD_BITS);
+			}
+		}
+		_clear_tail();
+	}
+
+	void clear() {
+		words.clear();
+		bit_count = 0;
+	}
+
+	void fill(bool p_value) {
+		uint64_t value = p_value ? ~uint64_t(0) : 0;
+		for (uint32_t i = 0; i < words.size(); i++) {
+			words[i] = value;
+		}
+		_clear_tail();
+	}
+
+	_FORCE_INLINE_ bool get(uint32_t p_index) const {
+		CRASH_BAD_UNSIGNED_INDEX(p_index, bit_count);
+		return (words[p_index / WORD_BITS] >> (p_index % WORD_BITS)) & 1;
+	}
+
+	_FORCE_INLINE_ void set(uint32_t p_index, bool p_value = true) {
+		CRASH_BAD_UNSIGNED_INDEX(p_index, bit_count);
+		uint64_t mask = uint64_t(1) << (p_index % WORD_BITS);
+		if (p_value) {
+			words[p_index / WORD_BITS] |= mask;
+		} else {
+			words[p_index / WORD_BITS] &= ~mask;
+		}
+	}
+
+	_FORCE_INLINE_ void flip(uint32_t p_index) {
+		CRASH_BAD_UNSIGNED_INDEX(p_index, bit_count);
+		words[p_index / WORD_BITS] ^= uint64_t(1) << (p_index % WORD_BITS);
+	}
+
+	_FORCE_INLINE_ bool operator[](uint32_t p_index) const { return get(p_index); }
+
+	// Number of bits that are set.
+	uint32_t count() const {
+		uint32_t total = 0;
+		for (uint32_t i = 0; i < words.size(); i++) {
+			total += _popcount(words[i]);
+		}
+		return total;
+	}
+
+	bool any() const {
+		for (uint32_t i = 0; i < words.size(); i++) {
+			if (words[i]) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	_FORCE_INLINE_ bool none() const { return !any(); }
+	_FORCE_INLINE_ bool all() const { return count() == bit_count; }
+
+	// Index of the first set bit, or -1 if there is none.
+	_FORCE_INLINE_ int64_t find_first_set() const { return _find_next(0, true); }
+	// Index of the first set bit at or after p_from, or -1 if there is none.
+	_FORCE_INLINE_ int64_t find_next_set(uint32_t p_from) const { return _find_next(p_from, true); }
+	_FORCE_INLINE_ int64_t find_first_unset() const { return _find_next(0, false); }
+	_FORCE_INLINE_ int64_t find_next_unset(uint32_t p_from) const { return _find_next(p_from, false); }
+
+	// Returns true if both bitsets have at least one set bit in common.
+	bool intersects(const BitVector &p_other) const {
+		ERR_FAIL_COND_V_MSG(bit_count != p_other.bit_count, false, "BitVector sizes don't match.");
+		for (uint32_t i = 0; i < words.size(); i++) {
+			if (words[i] & p_other.words[i]) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// Returns true if every bit set in this bitset is also set in p_other.
+	bool is_subset_of(const BitVector &p_other) const {
+		ERR_FAIL_COND_V_MSG(bit_count != p_other.bit_count, false, "BitVector sizes don't match.");
+		for (uint32_t i = 0; i < words.size(); i++) {
+			if (words[i] & ~p_other.words[i]) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	BitVector &operator&=(const BitVector &p_other) {
+		ERR_FAIL_COND_V_MSG(bit_count != p_other.bit_count, *this, "BitVector sizes don't match.");
+		_apply<OpAnd>(p_other);
+		return *this;
+	}
+
+	BitVector &operator|=(const BitVector &p_other) {
+		ERR_FAIL_COND_V_MSG(bit_count != p_other.bit_count, *this, "BitVector sizes don't match.");
+		_apply<OpOr>(p_other);
+		return *this;
+	}
+
+	BitVector &operator^=(const BitVector &p_other) {
+		ERR_FAIL_COND_V_MSG(bit_count != p_other.bit_count, *this, "BitVector sizes don't match.");
+		_apply<OpXor>(p_other);
+		return *this;
+	}
+
+	// Clears every bit that is set in p_other.
+	BitVector &and_not(const BitVector &p_other) {
+		ERR_FAIL_COND_V_MSG(bit_count != p_other.bit_count, *this, "BitVector sizes don't match.");
+		_apply<OpAndNot>(p_other);
+		return *this;
+	}
+
+	BitVector operator&(const BitVector &p_other) const {
+		BitVector ret = *this;
+		ret &= p_other;
+		return ret;
+	}
+
+	BitVector operator|(const BitVector &p_other) const {
+		BitVector ret = *this;
+		ret |= p_other;
+		return ret;
+	}
+
+	BitVector operator^(const BitVector &p_other) const {
+		BitVector ret = *this;
+		ret ^= p_other;
+		return ret;
+	}
+
+	BitVector operator~() const {
+		BitVector ret = *this;
+		for (uint32_t i = 0; i < ret.words.size(); i++) {
+			ret.words[i] = ~ret.words[i];
+		}
+		ret._clear_tail();
+		return ret;
+	}
+
+	bool operator==(const BitVector &p_other) const {
+		if (bit_count != p_other.bit_count) {
+			return false;
+		}
+		return words.size() == 0 || memcmp(words.ptr(), p_other.words.ptr(), words.size() * sizeof(uint64_t)) == 0;
+	}
+
+	_FORCE_INLINE_ bool operator!=(const BitVector &p_other) const { return !(*this == p_other); }
+
+	// Packs the bits into bytes, bit i being bit (i % 8) of byte (i / 8).
+	PackedByteArray to_packed_byte_array() const {
+		PackedByteArray ret;
+		uint32_t byte_count = (bit_count + 7) / 8;
+		ret.resize(byte_count);
+		uint8_t *w = ret.ptrw();
+		for (uint32_t i = 0; i < byte_count; i++) {
+			w[i] = uint8_t(words[i / 8] >> ((i % 8) * 8));
+		}
+		return ret;
+	}
+
+	// Unpacks bits stored like to_packed_byte_array() does. When p_bit_count is
+	// negative, every bit of the array is used.
+	void from_packed_byte_array(const PackedByteArray &p_bytes, int64_t p_bit_count = -1) {
+		int64_t available = p_bytes.size() * 8;
+		if (p_bit_count < 0) {
+			p_bit_count = available;
+		}
+		ERR_FAIL_COND_MSG(p_bit_count > available, "Not enough bytes for the requested amount of bits.");
+		ERR_FAIL_COND_MSG(p_bit_count > UINT32_MAX, "Too many bits for a BitVector.");
+
+		clear();
+		resize(uint32_t(p_bit_count));
+		const uint8_t *r = p_bytes.ptr();
+		uint32_t byte_count = (bit_count + 7) / 8;
+		for (uint32_t i = 0; i < byte_count; i++) {
+			words[i / 8] |= uint64_t(r[i]) << ((i % 8) * 8);
+		}
+		_clear_tail();
+	}
+
+	_FORCE_INLINE_ BitVector() {}
+	_FORCE_INLINE_ explicit BitVector(uint32_t p_size, bool p_value = false) {
+		resize(p_size, p_value);
+	}
+};
+
+} // namespace godot
+
+#endif // GODOT_BIT_VECTOR_HPP
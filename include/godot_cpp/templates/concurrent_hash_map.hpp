@@ -0,0 +1,211 @@
+/**************************************************************************/
+/*  concurrent_hash_map.hpp                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GODOT_CONCURRENT_HASH_MAP_HPP
+#define GODOT_CONCURRENT_HASH_MAP_HPP
+
+#include <godot_cpp/core/error_macros.hpp>
+#include <godot_cpp/core/memory.hpp>
+#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/hashfuncs.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/templates/pair.hpp>
+#include <godot_cpp/templates/spin_lock.hpp>
+
+namespace godot {
+
+/**
+ * A HashMap that can be accessed from multiple threads at once.
+ *
+ * Keys are spread over a fixed number of shards, each one being a regular
+ * HashMap guarded by its own RWSpinLock, so lookups never block each other
+ * and writers only contend when they hit the same shard. Shards are padded
+ * with a cache line to avoid false sharing between their locks, as the
+ * allocator doesn't honor over-aligned types.
+ *
+ * Values are returned by copy, as a reference would be left unprotected once
+ * the shard is unlocked. Iteration is done over a snapshot, which is taken
+ * one shard at a time: it is consistent within each shard, but not across
+ * the whole map if other threads keep writing in the meantime.
+ */
+
+template <class TKey, class TValue,
+		class Hasher = HashMapHasherDefault,
+		class Comparator = HashMapComparatorDefault<TKey>,
+		uint32_t SHARD_COUNT = 64>
+class ConcurrentHashMap {
+	static_assert(SHARD_COUNT > 0 && (SHARD_COUNT & (SHARD_COUNT - 1)) == 0, "SHARD_COUNT must be a power of two.");
+
+	static constexpr uint32_t CACHE_LINE_SIZE = 64;
+
+	struct Shard {
+		mutable RWSpinLock lock;
+		HashMap<TKey, TValue, Hasher, Comparator> map;
+		// A full line between shards keeps them apart whatever the alignment of the map.
+		uint8_t padding[CACHE_LINE_SIZE];
+	};
+
+	Shard shards[SHARD_COUNT];
+
+	_FORCE_INLINE_ Shard &_get_shard(const TKey &p_key) {
+		// Remix so the shard doesn't depend on the same bits HashMap uses for its slot.
+		return shards[hash_fmix32(Hasher::hash(p_key)) & (SHARD_COUNT - 1)];
+	}
+
+	_FORCE_INLINE_ const Shard &_get_shard(const TKey &p_key) const {
+		return shards[hash_fmix32(Hasher::hash(p_key)) & (SHARD_COUNT - 1)];
+	}
+
+	// Copies the elements of a shard into r_elements. The buffer is grown with
+	// the lock released, so nothing is allocated while other threads wait.
+	void _copy_shard(const Shard &p_shard, LocalVector<Pair<TKey, TValue>> &r_elements) const {
+		r_elements.clear();
+		p_shard.lock.read_lock();
+		while (p_shard.map.size() > r_elements.get_capacity()) {
+			uint32_t count = p_shard.map.size();
+			p_shard.lock.read_unlock();
+			r_elements.reserve(count + count / 4);
+			p_shard.lock.read_lock();
+		}
+		for (const KeyValue<TKey, TValue> &E : p_shard.map) {
+			r_elements.push_back(Pair<TKey, TValue>(E.key, E.value));
+		}
+		p_shard.lock.read_unlock();
+	}
+
+public:
+	// Returns the number of elements. Not atomic across shards, so it's only an estimate while other threads write.
+	uint32_t size() const {
+		uint32_t count = 0;
+		for (uint32_t i = 0; i < SHARD_COUNT; i++) {
+			shards[i].lock.read_lock();
+			count += shards[i].map.size();
+			shards[i].lock.read_unlock();
+		}
+		return count;
+	}
+
+	bool is_empty() const {
+		return size() == 0;
+	}
+
+	void clear() {
+		for (uint32_t i = 0; i < SHARD_COUNT; i++) {
+			shards[i].lock.write_lock();
+			shards[i].map.clear();
+			shards[i].lock.write_unlock();
+		}
+	}
+
+	bool has(const TKey &p_key) const {
+		const Shard &shard = _get_shard(p_key);
+		shard.lock.read_lock();
+		bool exists = shard.map.has(p_key);
+		shard.lock.read_unlock();
+		return exists;
+	}
+
+	// Copies the value of p_key into r_value. Returns false if the key is not present.
+	bool get(const TKey &p_key, TValue &r_value) const {
+		const Shard &shard = _get_shard(p_key);
+		shard.lock.read_lock();
+		const TValue *value = shard.map.getptr(p_key);
+		if (value) {
+			r_value = *value;
+		}
+		shard.lock.read_unlock();
+		return value != nullptr;
+	}
+
+	// Returns the value of p_key, inserting p_value first if the key is not present.
+	// The lookup and the insertion are atomic, so concurrent callers all get the same value.
+	TValue get_or_insert(const TKey &p_key, const TValue &p_value) {
+		TValue ret;
+		if (get(p_key, ret)) {
+			return ret;
+		}
+
+		Shard &shard = _get_shard(p_key);
+		shard.lock.write_lock();
+		TValue *value = shard.map.getptr(p_key);
+		if (!value) {
+			value = &shard.map.insert(p_key, p_value)->value;
+		}
+		ret = *value;
+		shard.lock.write_unlock();
+		return ret;
+	}
+
+	// Inserts p_value, replacing the existing value if there is one.
+	void insert(const TKey &p_key, const TValue &p_value) {
+		Shard &shard = _get_shard(p_key);
+		shard.lock.write_lock();
+		shard.map.insert(p_key, p_value);
+		shard.lock.write_unlock();
+	}
+
+	bool erase(const TKey &p_key) {
+		Shard &shard = _get_shard(p_key);
+		shard.lock.write_lock();
+		bool erased = shard.map.erase(p_key);
+		shard.lock.write_unlock();
+		return erased;
+	}
+
+	// Calls p_func(const TKey &, const TValue &) for every element of a snapshot of the map.
+	// Each shard is copied under its lock and visited after unlocking, so p_func may access the map.
+	template <class F>
+	void for_each(F p_func) const {
+		LocalVector<Pair<TKey, TValue>> elements;
+		for (uint32_t i = 0; i < SHARD_COUNT; i++) {
+			_copy_shard(shards[i], elements);
+			for (const Pair<TKey, TValue> &E : elements) {
+				p_func(E.first, E.second);
+			}
+		}
+	}
+
+	// Returns a copy of all the elements, see for_each() about consistency.
+	HashMap<TKey, TValue, Hasher, Comparator> snapshot() const {
+		HashMap<TKey, TValue, Hasher, Comparator> ret;
+		for_each([&ret](const TKey &p_key, const TValue &p_value) {
+			ret.insert(p_key, p_value);
+		});
+		return ret;
+	}
+
+	ConcurrentHashMap() {}
+	ConcurrentHashMap(const ConcurrentHashMap &p_other) = delete;
+	void operator=(const ConcurrentHashMap &p_other) = delete;
+};
+
+} // namespace godot
+
+#endif // GODOT_CONCURRENT_HASH_MAP_HPP
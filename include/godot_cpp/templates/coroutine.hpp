@@ -0,0 +1,606 @@
+/**************************************************************************/
+/*  coroutine.hpp                                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GODOT_COROUTINE_HPP
+#define GODOT_COROUTINE_HPP
+
+#if !defined(__cpp_impl_coroutine) || __cpp_impl_coroutine < 201902L
+#error "coroutine.hpp requires C++20 coroutines, build the extension with -std=c++20 (or /std:c++20)."
+#endif
+
+#include <godot_cpp/classes/engine.hpp>
+#include <godot_cpp/classes/object.hpp>
+#include <godot_cpp/classes/os.hpp>
+#include <godot_cpp/classes/scene_tree.hpp>
+#include <godot_cpp/classes/worker_thread_pool.hpp>
+#include <godot_cpp/core/error_macros.hpp>
+#include <godot_cpp/core/memory.hpp>
+#include <godot_cpp/templates/hashfuncs.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/templates/spin_lock.hpp>
+#include <godot_cpp/variant/array.hpp>
+#include <godot_cpp/variant/callable.hpp>
+#include <godot_cpp/variant/callable_custom.hpp>
+#include <godot_cpp/variant/callable_method_pointer.hpp>
+#include <godot_cpp/variant/signal.hpp>
+
+#include <coroutine>
+#include <type_traits>
+#include <utility>
+
+/**
+ * C++20 coroutines running on the main thread.
+ *
+ * A function returning Coroutine starts right away and runs until its first
+ * co_await. It can then wait for:
+ *
+ * - a Signal (`Array args = co_await signal;`),
+ * - the next process frame (`co_await Coroutines::next_frame();`),
+ * - a function run on the WorkerThreadPool
+ *   (`int n = co_await Coroutines::run_in_background([]() { return 42; });`),
+ * - another coroutine returning CoroutineTask<T>.
+ *
+ * Every wait resumes on the main thread: frame and background waits are
+ * resumed by Coroutines::process(), which is connected to
+ * SceneTree::process_frame on first use. Signal waits resume from the
+ * emission when the signal is emitted on the main thread, and from the next
+ * process() otherwise.
+ *
+ * A coroutine waiting for a signal is destroyed (running the destructors of
+ * its locals) if the emitting object is freed, and so is one waiting for the
+ * next frame if the owner passed to next_frame() is freed. Call
+ * Coroutines::clear() before the extension is unloaded to destroy those still
+ * waiting and disconnect process().
+ *
+ * Coroutine frames are allocated from pooled blocks, so short-lived
+ * coroutines don't go through the general allocator.
+ *
+ * This header needs C++20 and is not used by godot-cpp itself, which builds
+ * as C++17.
+ */
+
+namespace godot {
+
+class CoroutineFrameAllocator {
+	static constexpr uint32_t SIZE_CLASSES = 7; // 64 to 4096 bytes.
+	static constexpr size_t MIN_BLOCK_SIZE = 64;
+	static constexpr size_t PAGE_SIZE = 16384;
+
+	struct FreeBlock {
+		FreeBlock *next;
+	};
+
+	// Pages are never released, the blocks are reused for the lifetime of
+	// the process.
+	static inline SpinLock lock;
+	static inline FreeBlock *free_lists[SIZE_CLASSES] = {};
+
+	static _FORCE_INLINE_ uint32_t _get_size_class(size_t p_size) {
+		uint32_t size_class = 0;
+		while ((MIN_BLOCK_SIZE << size_class) < p_size) {
+			size_class++;
+		}
+		return size_class;
+	}
+
+public:
+	static void *alloc(size_t p_size) {
+		const uint32_t size_class = _get_size_class(p_size);
+		if (size_class >= SIZE_CLASSES) {
+			return memalloc(p_size);
+		}
+		lock.lock();
+		FreeBlock *&free_list = free_lists[size_class];
+		if (unlikely(!free_list)) {
+			const size_t block_size = MIN_BLOCK_SIZE << size_class;
+			uint8_t *page = (uint8_t *)memalloc(PAGE_SIZE);
+			for (size_t offset = 0; offset + block_size <= PAGE_SIZE; offset += block_size) {
+				FreeBlock *block = (FreeBlock *)(page + offset);
+				block->next = free_list;
+				free_list = block;
+			}
+		}
+		FreeBlock *block = free_list;
+		free_list = block->next;
+		lock.unlock();
+		return block;
+	}
+
+	static void free(void *p_memory, size_t p_size) {
+		const uint32_t size_class = _get_size_class(p_size);
+		if (size_class >= SIZE_CLASSES) {
+			memfree(p_memory);
+			return;
+		}
+		FreeBlock *block = (FreeBlock *)p_memory;
+		lock.lock();
+		block->next = free_lists[size_class];
+		free_lists[size_class] = block;
+		lock.unlock();
+	}
+};
+
+// Common part of the promise of Coroutine and CoroutineTask.
+class CoroutinePromiseBase {
+	template <class T>
+	friend class CoroutineTask;
+
+	CoroutinePromiseBase *parent = nullptr; // The coroutine awaiting this one, if any.
+
+protected:
+	std::coroutine_handle<> handle;
+
+public:
+	// Destroys the whole chain of coroutines this one is part of. It must be
+	// suspended.
+	void cancel() {
+		CoroutinePromiseBase *root = this;
+		while (root->parent) {
+			root = root->parent;
+		}
+		root->handle.destroy();
+	}
+
+	void unhandled_exception() {
+		CRASH_NOW_MSG("Unhandled exception in a coroutine.");
+	}
+
+	static void *operator new(size_t p_size) {
+		return CoroutineFrameAllocator::alloc(p_size);
+	}
+
+	static void operator delete(void *p_memory, size_t p_size) {
+		CoroutineFrameAllocator::free(p_memory, p_size);
+	}
+};
+
+// Return type of top-level coroutines. They start when called and destroy
+// themselves when they are done; the returned object can be ignored.
+class Coroutine {
+public:
+	struct promise_type : public CoroutinePromiseBase {
+		Coroutine get_return_object() {
+			handle = std::coroutine_handle<promise_type>::from_promise(*this);
+			return Coroutine();
+		}
+		std::suspend_never initial_suspend() noexcept { return {}; }
+		std::suspend_never final_suspend() noexcept { return {}; }
+		void return_void() {}
+	};
+};
+
+template <class T>
+class CoroutineTaskResult {
+	alignas(T) uint8_t data[sizeof(T)];
+	bool has_value = false;
+
+public:
+	template <class V>
+	void set(V &&p_value) {
+		memnew_placement(data, T(std::forward<V>(p_value)));
+		has_value = true;
+	}
+
+	T take() {
+		CRASH_COND(!has_value);
+		return std::move(*reinterpret_cast<T *>(data));
+	}
+
+	~CoroutineTaskResult() {
+		if (has_value) {
+			reinterpret_cast<T *>(data)->~T();
+		}
+	}
+};
+
+template <class T>
+struct CoroutineTaskPromiseResult {
+	CoroutineTaskResult<T> result;
+
+	template <class V>
+	void return_value(V &&p_value) {
+		result.set(std::forward<V>(p_value));
+	}
+};
+
+template <>
+struct CoroutineTaskPromiseResult<void> {
+	void return_void() {}
+};
+
+// Return type of coroutines meant to be awaited by other coroutines, with
+// `T value = co_await task;`. They only start once awaited, and are
+// destroyed with the CoroutineTask object.
+template <class T = void>
+class CoroutineTask {
+public:
+	struct promise_type : public CoroutinePromiseBase, public CoroutineTaskPromiseResult<T> {
+		std::coroutine_handle<> continuation;
+
+		struct FinalAwaiter {
+			bool await_ready() noexcept { return false; }
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> p_handle) noexcept {
+				return p_handle.promise().continuation;
+			}
+			void await_resume() noexcept {}
+		};
+
+		CoroutineTask get_return_object() {
+			handle = std::coroutine_handle<promise_type>::from_promise(*this);
+			return CoroutineTask(std::coroutine_handle<promise_type>::from_promise(*this));
+		}
+		std::suspend_always initial_suspend() noexcept { return {}; }
+		FinalAwaiter final_suspend() noexcept { return {}; }
+	};
+
+private:
+	std::coroutine_handle<promise_type> handle;
+
+	explicit CoroutineTask(std::coroutine_handle<promise_type> p_handle) :
+			handle(p_handle) {}
+
+public:
+	struct Awaiter {
+		std::coroutine_handle<promise_type> handle;
+
+		bool await_ready() { return false; }
+
+		template <class P>
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<P> p_awaiting) {
+			static_assert(std::is_base_of<CoroutinePromiseBase, P>::value, "CoroutineTask can only be awaited from a Coroutine or CoroutineTask.");
+			promise_type &promise = handle.promise();
+			promise.continuation = p_awaiting;
+			promise.parent = &p_awaiting.promise();
+			return handle;
+		}
+
+		T await_resume() {
+			if constexpr (!std::is_void<T>::value) {
+				return handle.promise().result.take();
+			}
+		}
+	};
+
+	Awaiter operator co_await() {
+		CRASH_COND_MSG(!handle, "Awaiting an empty CoroutineTask.");
+		return Awaiter{ handle };
+	}
+
+	_FORCE_INLINE_ bool is_done() const { return handle && handle.done(); }
+
+	CoroutineTask(CoroutineTask &&p_other) :
+			handle(std::exchange(p_other.handle, nullptr)) {}
+	CoroutineTask &operator=(CoroutineTask &&p_other) {
+		if (this != &p_other) {
+			if (handle) {
+				handle.destroy();
+			}
+			handle = std::exchange(p_other.handle, nullptr);
+		}
+		return *this;
+	}
+	CoroutineTask(const CoroutineTask &) = delete;
+	CoroutineTask &operator=(const CoroutineTask &) = delete;
+
+	~CoroutineTask() {
+		if (handle) {
+			handle.destroy();
+		}
+	}
+};
+
+class Coroutines {
+	friend class CoroutineSignalCallable;
+	friend struct CoroutineSignalAwaiter;
+
+	struct FrameWait {
+		std::coroutine_handle<> handle;
+		CoroutinePromiseBase *promise;
+		uint64_t owner_id;
+	};
+
+	struct TaskWait {
+		std::coroutine_handle<> handle;
+		CoroutinePromiseBase *promise;
+		WorkerThreadPool::TaskID task_id;
+	};
+
+	// Only touched from the main thread. Coroutines wait in
+	// frame_waits[current_frame_waits], while process() resumes the other list.
+	static inline LocalVector<FrameWait> frame_waits[2];
+	static inline uint32_t current_frame_waits = 0;
+	static inline LocalVector<TaskWait> task_waits;
+	static inline bool connected = false;
+
+	// Signal waits whose signal was emitted on another thread, filled from
+	// any thread and resumed by process().
+	static inline SpinLock signal_resumes_lock;
+	static inline LocalVector<FrameWait> signal_resumes;
+
+	static void _connect() {
+		if (connected) {
+			return;
+		}
+		SceneTree *tree = Object::cast_to<SceneTree>(Engine::get_singleton()->get_main_loop());
+		// Without a SceneTree, process() has to be called manually.
+		if (tree) {
+			tree->connect("process_frame", callable_mp_static(&Coroutines::process));
+			connected = true;
+		}
+	}
+
+	static void _disconnect() {
+		if (!connected) {
+			return;
+		}
+		SceneTree *tree = Object::cast_to<SceneTree>(Engine::get_singleton()->get_main_loop());
+		Callable callable = callable_mp_static(&Coroutines::process);
+		if (tree && tree->is_connected("process_frame", callable)) {
+			tree->disconnect("process_frame", callable);
+		}
+		connected = false;
+	}
+
+	static _FORCE_INLINE_ bool _is_main_thread() {
+		const OS *os = OS::get_singleton();
+		return os->get_thread_caller_id() == os->get_main_thread_id();
+	}
+
+	static void _defer_signal_resume(std::coroutine_handle<> p_handle, CoroutinePromiseBase *p_promise) {
+		signal_resumes_lock.lock();
+		signal_resumes.push_back({ p_handle, p_promise, 0 });
+		signal_resumes_lock.unlock();
+	}
+
+	// Takes the signal wait at p_index, or returns false and empties the
+	// list once it is past the end.
+	static bool _take_signal_resume(uint32_t p_index, FrameWait &r_wait) {
+		signal_resumes_lock.lock();
+		const bool found = p_index < signal_resumes.size();
+		if (found) {
+			r_wait = signal_resumes[p_index];
+		} else {
+			signal_resumes.clear();
+		}
+		signal_resumes_lock.unlock();
+		return found;
+	}
+
+	template <class F>
+	struct BackgroundAwaiter {
+		typedef std::invoke_result_t<F &> R;
+
+		F function;
+		std::conditional_t<std::is_void<R>::value, bool, CoroutineTaskResult<R>> result;
+
+		static void _run(void *p_userdata) {
+			BackgroundAwaiter *self = static_cast<BackgroundAwaiter *>(p_userdata);
+			if constexpr (std::is_void<R>::value) {
+				self->function();
+			} else {
+				self->result.set(self->function());
+			}
+		}
+
+		bool await_ready() { return false; }
+
+		template <class P>
+		void await_suspend(std::coroutine_handle<P> p_handle) {
+			WorkerThreadPool::TaskID task_id = WorkerThreadPool::get_singleton()->add_native_task(&BackgroundAwaiter::_run, this, false, "Coroutine");
+			task_waits.push_back({ p_handle, &p_handle.promise(), task_id });
+			_connect();
+		}
+
+		R await_resume() {
+			if constexpr (!std::is_void<R>::value) {
+				return result.take();
+			}
+		}
+	};
+
+public:
+	struct FrameAwaiter {
+		uint64_t owner_id = 0;
+
+		bool await_ready() { return false; }
+
+		template <class P>
+		void await_suspend(std::coroutine_handle<P> p_handle) {
+			static_assert(std::is_base_of<CoroutinePromiseBase, P>::value, "Only a Coroutine or CoroutineTask can wait for the next frame.");
+			frame_waits[current_frame_waits].push_back({ p_handle, &p_handle.promise(), owner_id });
+			_connect();
+		}
+
+		void await_resume() {}
+	};
+
+	// Resumes on the next process frame. With p_owner, the coroutine is
+	// destroyed instead if p_owner is freed meanwhile.
+	static FrameAwaiter next_frame(const Object *p_owner = nullptr) {
+		return FrameAwaiter{ p_owner ? p_owner->get_instance_id() : 0 };
+	}
+
+	// Runs p_function on the WorkerThreadPool, and resumes with its result on
+	// the first process frame after it is done.
+	template <class F>
+	static BackgroundAwaiter<std::decay_t<F>> run_in_background(F &&p_function) {
+		return BackgroundAwaiter<std::decay_t<F>>{ std::forward<F>(p_function), {} };
+	}
+
+	// Resumes the coroutines waiting for the next frame, those whose
+	// background function is done, and those whose signal was emitted on
+	// another thread.
+	static void process() {
+		FrameWait signal_wait;
+		for (uint32_t i = 0; _take_signal_resume(i, signal_wait); i++) {
+			signal_wait.handle.resume();
+		}
+
+		for (uint32_t i = 0; i < task_waits.size();) {
+			const TaskWait wait = task_waits[i];
+			if (!WorkerThreadPool::get_singleton()->is_task_completed(wait.task_id)) {
+				i++;
+				continue;
+			}
+			WorkerThreadPool::get_singleton()->wait_for_task_completion(wait.task_id);
+			task_waits.remove_at_unordered(i);
+			wait.handle.resume();
+		}
+
+		// Coroutines waiting again while being resumed go to the next frame.
+		LocalVector<FrameWait> &resuming = frame_waits[current_frame_waits];
+		current_frame_waits ^= 1;
+		for (const FrameWait &wait : resuming) {
+			if (wait.owner_id != 0 && ObjectDB::get_instance(wait.owner_id) == nullptr) {
+				wait.promise->cancel();
+			} else {
+				wait.handle.resume();
+			}
+		}
+		resuming.clear();
+	}
+
+	// Destroys all the coroutines waiting for a frame or a background
+	// function, or resumed by a signal emitted on another thread, and
+	// disconnects process(). Coroutines waiting for a signal stay connected.
+	static void clear() {
+		_disconnect();
+		FrameWait signal_wait;
+		for (uint32_t i = 0; _take_signal_resume(i, signal_wait); i++) {
+			signal_wait.promise->cancel();
+		}
+		signal_resumes.reset();
+
+		while (!task_waits.is_empty()) {
+			const TaskWait wait = task_waits[task_waits.size() - 1];
+			task_waits.resize(task_waits.size() - 1);
+			WorkerThreadPool::get_singleton()->wait_for_task_completion(wait.task_id);
+			wait.promise->cancel();
+		}
+		for (LocalVector<FrameWait> &waits : frame_waits) {
+			while (!waits.is_empty()) {
+				const FrameWait wait = waits[waits.size() - 1];
+				waits.resize(waits.size() - 1);
+				wait.promise->cancel();
+			}
+			waits.reset();
+		}
+		task_waits.reset();
+	}
+};
+
+// One-shot connection resuming a coroutine with the signal arguments. If it
+// is dropped without being called, the emitter was freed, and the
+// coroutine is cancelled.
+class CoroutineSignalCallable : public CallableCustom {
+	std::coroutine_handle<> handle;
+	mutable CoroutinePromiseBase *promise;
+	Array *arguments;
+
+	static bool _compare_equal(const CallableCustom *p_a, const CallableCustom *p_b) {
+		return p_a == p_b;
+	}
+
+	static bool _compare_less(const CallableCustom *p_a, const CallableCustom *p_b) {
+		return (void *)p_a < (void *)p_b;
+	}
+
+public:
+	virtual uint32_t hash() const override { return hash_murmur3_one_64((uint64_t)this); }
+	virtual String get_as_text() const override { return "<Coroutine>"; }
+	virtual CompareEqualFunc get_compare_equal_func() const override { return &_compare_equal; }
+	virtual CompareLessFunc get_compare_less_func() const override { return &_compare_less; }
+	virtual bool is_valid() const override { return true; }
+	virtual ObjectID get_object() const override { return ObjectID(); }
+
+	virtual void call(const Variant **p_arguments, int p_argcount, Variant &, GDExtensionCallError &r_call_error) const override {
+		r_call_error.error = GDEXTENSION_CALL_OK;
+		if (!promise) {
+			return;
+		}
+		CoroutinePromiseBase *resumed = promise;
+		promise = nullptr;
+		arguments->resize(p_argcount);
+		for (int i = 0; i < p_argcount; i++) {
+			(*arguments)[i] = *p_arguments[i];
+		}
+		if (Coroutines::_is_main_thread()) {
+			handle.resume();
+		} else {
+			Coroutines::_defer_signal_resume(handle, resumed);
+		}
+	}
+
+	// Called when connecting failed, the coroutine goes on without waiting.
+	void detach() { promise = nullptr; }
+
+	CoroutineSignalCallable(std::coroutine_handle<> p_handle, CoroutinePromiseBase *p_promise, Array *r_arguments) :
+			handle(p_handle), promise(p_promise), arguments(r_arguments) {}
+
+	~CoroutineSignalCallable() {
+		if (promise) {
+			promise->cancel();
+		}
+	}
+};
+
+struct CoroutineSignalAwaiter {
+	Signal signal;
+	Array arguments;
+
+	bool await_ready() { return false; }
+
+	template <class P>
+	bool await_suspend(std::coroutine_handle<P> p_handle) {
+		static_assert(std::is_base_of<CoroutinePromiseBase, P>::value, "Only a Coroutine or CoroutineTask can await a signal.");
+		CoroutineSignalCallable *custom = memnew(CoroutineSignalCallable(p_handle, &p_handle.promise(), &arguments));
+		Callable callable(custom);
+		Error err = (Error)signal.connect(callable, Object::CONNECT_ONE_SHOT);
+		if (err != OK) {
+			custom->detach();
+			ERR_FAIL_V_MSG(false, "Can't await signal '" + String(signal.get_name()) + "'.");
+		}
+		// In case the signal is emitted on another thread.
+		Coroutines::_connect();
+		return true;
+	}
+
+	Array await_resume() { return std::move(arguments); }
+};
+
+// `Array args = co_await signal;` resumes with the arguments of the next
+// emission.
+inline CoroutineSignalAwaiter operator co_await(const Signal &p_signal) {
+	return CoroutineSignalAwaiter{ p_signal, Array() };
+}
+
+} // namespace godot
+
+#endif // GODOT_COROUTINE_HPP
@@ -60,6 +60,10 @@ SAFE_NUMERIC_TYPE_PUN_GUARANTEES(uint64_t)
 #pragma GCC diagnostic ignored "-Wplacement-new"
 #endif
 
+// Reference counted copy-on-write storage of Vector.
+// Writes go through ptrw(), which copies the data first when it is shared; a
+// single ptrw() before a loop avoids repeating the atomic check per element.
+// LocalVector is the choice for data that is never shared.
 template <class T>
 class CowData {
 	template <class TV>
@@ -210,10 +214,11 @@ public:
 	Error insert(Size p_pos, const T &p_val) {
 		ERR_FAIL_INDEX_V(p_pos, size() + 1, ERR_INVALID_PARAMETER);
 		resize(size() + 1);
+		T *p = ptrw();
 		for (Size i = (size() - 1); i > p_pos; i--) {
-			set(i, get(i - 1));
+			p[i] = p[i - 1];
 		}
-		set(p_pos, p_val);
+		p[p_pos] = p_val;
 
 		return OK;
 	}
@@ -0,0 +1,102 @@
+/**************************************************************************/
+/*  cpu_topology.hpp                                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GODOT_CPU_TOPOLOGY_HPP
+#define GODOT_CPU_TOPOLOGY_HPP
+
+#include <godot_cpp/templates/local_vector.hpp>
+
+#include <cstdint>
+
+namespace godot {
+
+/**
+ * Logical CPUs of the machine, grouped by physical core and by shared L3
+ * cache, as read from sysfs on Linux. Elsewhere, or if sysfs can't be read,
+ * every CPU is reported as its own core, all sharing one L3 cache.
+ *
+ * Used to pin worker threads, see ThreadWorkPool::init().
+ */
+class CPUTopology {
+public:
+	enum Placement {
+		PLACEMENT_NONE, // Let the OS schedule threads anywhere.
+		PLACEMENT_COMPACT, // One CPU per thread, filling an L3 group (SMT siblings included) before the next.
+		PLACEMENT_SCATTER, // One CPU per thread, spread over L3 groups and physical cores first.
+		PLACEMENT_L3_GROUPS, // Each thread may run on any CPU of one L3 group, groups assigned round-robin.
+	};
+
+	struct CPU {
+		uint32_t id = 0; // As used by the OS.
+		uint32_t package = 0;
+		uint32_t core = 0; // Physical core, numbered across packages.
+		uint32_t smt_index = 0; // Rank among the hardware threads of the core.
+		uint32_t l3_group = 0;
+	};
+
+private:
+	LocalVector<CPU> cpus;
+	uint32_t core_count = 0;
+	uint32_t l3_group_count = 0;
+	uint32_t package_count = 0;
+
+	// Indices into cpus, in the order PLACEMENT_COMPACT and
+	// PLACEMENT_SCATTER hand them out.
+	LocalVector<uint32_t> compact_order;
+	LocalVector<uint32_t> scatter_order;
+
+	void _discover();
+	void _discover_fallback();
+
+	CPUTopology() { _discover(); }
+
+public:
+	// Discovered on first use.
+	static const CPUTopology &get_singleton();
+
+	_FORCE_INLINE_ uint32_t get_cpu_count() const { return cpus.size(); }
+	_FORCE_INLINE_ const CPU &get_cpu(uint32_t p_index) const { return cpus[p_index]; }
+	_FORCE_INLINE_ uint32_t get_core_count() const { return core_count; }
+	_FORCE_INLINE_ uint32_t get_l3_group_count() const { return l3_group_count; }
+	_FORCE_INLINE_ uint32_t get_package_count() const { return package_count; }
+
+	// CPU ids the p_thread-th worker may run on with p_placement. Empty for
+	// PLACEMENT_NONE.
+	void get_thread_cpus(Placement p_placement, uint32_t p_thread, LocalVector<uint32_t> &r_cpus) const;
+
+	// Both return false where unsupported. Names are truncated to 15
+	// characters on Linux.
+	static bool set_current_thread_affinity(const LocalVector<uint32_t> &p_cpus);
+	static bool set_current_thread_name(const char *p_name);
+};
+
+} // namespace godot
+
+#endif // GODOT_CPU_TOPOLOGY_HPP
@@ -0,0 +1,145 @@
+/**************************************************************************/
+/*  eytzinger_array.hpp                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GODOT_EYTZINGER_ARRAY_HPP
+#define GODOT_EYTZINGER_ARRAY_HPP
+
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/templates/search_array.hpp>
+
+namespace godot {
+
+/**
+ * A read-only copy of a sorted array in Eytzinger (breadth-first) order, for
+ * large arrays that are searched much more often than they change.
+ *
+ * Node k of the implicit tree has its children at 2k and 2k + 1, so the first
+ * levels of every search share the same few cache lines, and the descendants
+ * a few levels down are contiguous and can be prefetched ahead of time. The
+ * descent itself is branchless.
+ *
+ * Results are indices into the original sorted array, with the same meaning
+ * as SearchArray::bisect().
+ */
+template <class T, class Comparator = _DefaultComparator<T>>
+class EytzingerArray {
+	// 1-based tree, element 0 is unused.
+	LocalVector<T> tree;
+	// Position of each tree node in the sorted array.
+	LocalVector<uint32_t> ranks;
+	uint32_t count = 0;
+
+	// Nodes four levels below k start at 16k, prefetch the cache line holding them.
+	static constexpr uint32_t PREFETCH_STRIDE = 16;
+
+	uint32_t _build(const T *p_sorted, uint32_t p_index, uint32_t p_node) {
+		if (p_node <= count) {
+			p_index = _build(p_sorted, p_index, 2 * p_node);
+			tree[p_node] = p_sorted[p_index];
+			ranks[p_node] = p_index;
+			p_index = _build(p_sorted, p_index + 1, 2 * p_node + 1);
+		}
+		return p_index;
+	}
+
+	// Returns the node of the first element for which p_pred fails, or 0 if there is none.
+	template <class Pred>
+	_FORCE_INLINE_ uint32_t _partition_node(const Pred &p_pred) const {
+		uint32_t k = 1;
+		const T *t = tree.ptr();
+		while (k <= count) {
+			search_array_prefetch(t + MIN(k * PREFETCH_STRIDE, count));
+			k = 2 * k + (p_pred(t[k]) ? 1 : 0);
+		}
+		// Undo the right turns taken after the last left turn, the node where it was taken is the answer.
+		return k >> (_trailing_ones(k) + 1);
+	}
+
+	template <class Pred>
+	_FORCE_INLINE_ int _partition_point(const Pred &p_pred) const {
+		uint32_t k = _partition_node(p_pred);
+		return k == 0 ? int(count) : int(ranks[k]);
+	}
+
+	static _FORCE_INLINE_ uint32_t _trailing_ones(uint32_t p_value) {
+		uint32_t inverted = ~p_value;
+#if defined(__GNUC__)
+		return inverted ? __builtin_ctz(inverted) : 32;
+#else
+		uint32_t n = 0;
+		while (inverted && !(inverted & 1)) {
+			inverted >>= 1;
+			n++;
+		}
+		return inverted ? n : 32;
+#endif
+	}
+
+public:
+	Comparator compare;
+
+	// p_sorted must be sorted according to the comparator.
+	void build(const T *p_sorted, int p_len) {
+		count = p_len > 0 ? uint32_t(p_len) : 0;
+		tree.resize(count + 1);
+		ranks.resize(count + 1);
+		_build(p_sorted, 0, 1);
+	}
+
+	_FORCE_INLINE_ int size() const { return int(count); }
+	_FORCE_INLINE_ bool is_empty() const { return count == 0; }
+
+	// Same result as SearchArray::bisect() on the sorted array.
+	int bisect(const T &p_value, bool p_before) const {
+		if (p_before) {
+			return _partition_point([this, &p_value](const T &p_element) { return compare(p_element, p_value); });
+		} else {
+			return _partition_point([this, &p_value](const T &p_element) { return !compare(p_value, p_element); });
+		}
+	}
+
+	// Index of p_value in the sorted array, or -1.
+	int find(const T &p_value) const {
+		uint32_t k = _partition_node([this, &p_value](const T &p_element) { return compare(p_element, p_value); });
+		if (k == 0 || compare(p_value, tree[k])) {
+			return -1;
+		}
+		return int(ranks[k]);
+	}
+
+	EytzingerArray() {}
+	EytzingerArray(const T *p_sorted, int p_len) {
+		build(p_sorted, p_len);
+	}
+};
+
+} // namespace godot
+
+#endif // GODOT_EYTZINGER_ARRAY_HPP
@@ -0,0 +1,743 @@
+/**************************************************************************/
+/*  flat_hash_map.hpp                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GODOT_FLAT_HASH_MAP_HPP
+#define GODOT_FLAT_HASH_MAP_HPP
+
+#include <godot_cpp/core/error_macros.hpp>
+#include <godot_cpp/core/memory.hpp>
+#include <godot_cpp/templates/hashfuncs.hpp>
+#include <godot_cpp/templates/pair.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GODOT_FLAT_HASH_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+#define GODOT_FLAT_HASH_NEON
+#include <arm_neon.h>
+#endif
+
+namespace godot {
+
+/**
+ * A group of 16 control bytes, shared by FlatHashMap and FlatHashSet.
+ *
+ * Each slot of a flat hash table has one control byte: EMPTY, DELETED, or the
+ * lowest 7 bits of the key hash when the slot is in use. Lookups compare a
+ * whole group of control bytes at once (SSE2 or NEON when available, plain
+ * loops otherwise) and only compare keys for the slots that matched.
+ *
+ * The match functions return a bitmask where bit i stands for slot i of the group.
+ */
+struct FlatHashGroup {
+	static constexpr uint32_t SIZE = 16;
+	static constexpr int8_t EMPTY = -128;
+	static constexpr int8_t DELETED = -2;
+
+#if defined(GODOT_FLAT_HASH_SSE2)
+	__m128i ctrl;
+
+	_FORCE_INLINE_ explicit FlatHashGroup(const int8_t *p_ctrl) {
+		ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p_ctrl));
+	}
+
+	_FORCE_INLINE_ uint32_t match(int8_t p_h2) const {
+		return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(p_h2)));
+	}
+
+	_FORCE_INLINE_ uint32_t match_empty_or_deleted() const {
+		// Both EMPTY and DELETED are smaller than -1, full slots are positive.
+		return (uint32_t)_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), ctrl));
+	}
+
+	_FORCE_INLINE_ uint32_t match_full() const {
+		return (uint32_t)_mm_movemask_epi8(ctrl) ^ 0xFFFF;
+	}
+#elif defined(GODOT_FLAT_HASH_NEON)
+	int8x16_t ctrl;
+
+	static _FORCE_INLINE_ uint32_t _to_mask(uint8x16_t p_cmp) {
+		static const uint8_t bits[SIZE] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+		uint8x16_t masked = vandq_u8(p_cmp, vld1q_u8(bits));
+		return (uint32_t)vaddv_u8(vget_low_u8(masked)) | ((uint32_t)vaddv_u8(vget_high_u8(masked)) << 8);
+	}
+
+	_FORCE_INLINE_ explicit FlatHashGroup(const int8_t *p_ctrl) {
+		ctrl = vld1q_s8(p_ctrl);
+	}
+
+	_FORCE_INLINE_ uint32_t match(int8_t p_h2) const {
+		return _to_mask(vceqq_s8(ctrl, vdupq_n_s8(p_h2)));
+	}
+
+	_FORCE_INLINE_ uint32_t match_empty_or_deleted() const {
+		return _to_mask(vcltq_s8(ctrl, vdupq_n_s8(-1)));
+	}
+
+	_FORCE_INLINE_ uint32_t match_full() const {
+		return _to_mask(vcgeq_s8(ctrl, vdupq_n_s8(0)));
+	}
+#else
+	const int8_t *ctrl;
+
+	_FORCE_INLINE_ explicit FlatHashGroup(const int8_t *p_ctrl) {
+		ctrl = p_ctrl;
+	}
+
+	_FORCE_INLINE_ uint32_t match(int8_t p_h2) const {
+		uint32_t mask = 0;
+		for (uint32_t i = 0; i < SIZE; i++) {
+			mask |= uint32_t(ctrl[i] == p_h2) << i;
+		}
+		return mask;
+	}
+
+	_FORCE_INLINE_ uint32_t match_empty_or_deleted() const {
+		uint32_t mask = 0;
+		for (uint32_t i = 0; i < SIZE; i++) {
+			mask |= uint32_t(ctrl[i] < -1) << i;
+		}
+		return mask;
+	}
+
+	_FORCE_INLINE_ uint32_t match_full() const {
+		uint32_t mask = 0;
+		for (uint32_t i = 0; i < SIZE; i++) {
+			mask |= uint32_t(ctrl[i] >= 0) << i;
+		}
+		return mask;
+	}
+#endif
+
+	_FORCE_INLINE_ uint32_t match_empty() const {
+		return match(EMPTY);
+	}
+
+	static _FORCE_INLINE_ uint32_t lowest_bit(uint32_t p_mask) {
+#if defined(__GNUC__)
+		return __builtin_ctz(p_mask);
+#elif defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward(&index, p_mask);
+		return index;
+#else
+		uint32_t index = 0;
+		while (!(p_mask & 1)) {
+			p_mask >>= 1;
+			index++;
+		}
+		return index;
+#endif
+	}
+
+	// Returns the first used slot at or after p_from, or p_capacity if there is none.
+	static _FORCE_INLINE_ uint32_t next_full(const int8_t *p_ctrl, uint32_t p_capacity, uint32_t p_from) {
+		while (p_from < p_capacity) {
+			uint32_t base = p_from & ~(SIZE - 1);
+			uint32_t mask = FlatHashGroup(p_ctrl + base).match_full() & (0xFFFFu << (p_from - base));
+			if (mask) {
+				return base + lowest_bit(mask);
+			}
+			p_from = base + SIZE;
+		}
+		return p_capacity;
+	}
+
+	// Returns the last used slot at or before p_from, or UINT32_MAX if there is none.
+	static _FORCE_INLINE_ uint32_t prev_full(const int8_t *p_ctrl, uint32_t p_from) {
+		for (int64_t i = p_from; i >= 0; i--) {
+			if (p_ctrl[i] >= 0) {
+				return (uint32_t)i;
+			}
+		}
+		return UINT32_MAX;
+	}
+
+	// Smallest power of two capacity (at least one group) that holds p_elements under the maximum load factor of 7/8.
+	static _FORCE_INLINE_ uint32_t capacity_for(uint32_t p_elements) {
+		uint32_t capacity = SIZE;
+		while (capacity < (1u << 31) && capacity - capacity / 8 < p_elements) {
+			capacity <<= 1;
+		}
+		return capacity;
+	}
+};
+
+/**
+ * Slot storage and probing shared by FlatHashMap and FlatHashSet. TSlot is
+ * the stored element, KeyOf::get() returns its key.
+ *
+ * Inserting is split in two: prepare_insert() finds the key or reserves a
+ * slot for it, hashing the key only once, and the caller then constructs
+ * the element in the reserved slot.
+ */
+template <class TSlot, class TKey, class KeyOf, class Hasher, class Comparator>
+struct FlatHashTable {
+	static constexpr uint32_t MIN_CAPACITY = FlatHashGroup::SIZE;
+
+	int8_t *ctrl = nullptr;
+	TSlot *slots = nullptr;
+
+	uint32_t capacity = MIN_CAPACITY;
+	uint32_t num_elements = 0;
+	// Number of EMPTY slots that can still be used before the maximum load factor is reached.
+	uint32_t growth_left = 0;
+
+	_FORCE_INLINE_ static uint32_t _get_h1(uint32_t p_hash) { return p_hash >> 7; }
+	_FORCE_INLINE_ static int8_t _get_h2(uint32_t p_hash) { return (int8_t)(p_hash & 0x7F); }
+
+	bool lookup_pos(const TKey &p_key, uint32_t p_hash, uint32_t &r_pos) const {
+		if (ctrl == nullptr) {
+			return false; // Failed lookups, no elements
+		}
+
+		int8_t h2 = _get_h2(p_hash);
+		uint32_t group_mask = capacity / FlatHashGroup::SIZE - 1;
+		uint32_t group = _get_h1(p_hash) & group_mask;
+
+		// Triangular probing over groups visits every group when their count is a power of two.
+		for (uint32_t probe = 1;; probe++) {
+			uint32_t base = group * FlatHashGroup::SIZE;
+			FlatHashGroup g(ctrl + base);
+
+			uint32_t mask = g.match(h2);
+			while (mask) {
+				uint32_t pos = base + FlatHashGroup::lowest_bit(mask);
+				if (Comparator::compare(KeyOf::get(slots[pos]), p_key)) {
+					r_pos = pos;
+					return true;
+				}
+				mask &= mask - 1;
+			}
+
+			if (g.match_empty()) {
+				return false;
+			}
+
+			group = (group + probe) & group_mask;
+		}
+	}
+
+	_FORCE_INLINE_ bool lookup_pos(const TKey &p_key, uint32_t &r_pos) const {
+		if (ctrl == nullptr) {
+			return false;
+		}
+		return lookup_pos(p_key, Hasher::hash(p_key), r_pos);
+	}
+
+	uint32_t find_insert_pos(uint32_t p_hash) const {
+		uint32_t group_mask = capacity / FlatHashGroup::SIZE - 1;
+		uint32_t group = _get_h1(p_hash) & group_mask;
+
+		for (uint32_t probe = 1;; probe++) {
+			uint32_t base = group * FlatHashGroup::SIZE;
+			uint32_t mask = FlatHashGroup(ctrl + base).match_empty_or_deleted();
+			if (mask) {
+				return base + FlatHashGroup::lowest_bit(mask);
+			}
+
+			group = (group + probe) & group_mask;
+		}
+	}
+
+	void allocate(uint32_t p_capacity) {
+		capacity = p_capacity;
+		ctrl = reinterpret_cast<int8_t *>(Memory::alloc_static(sizeof(int8_t) * capacity));
+		slots = reinterpret_cast<TSlot *>(Memory::alloc_static(sizeof(TSlot) * capacity));
+		memset(ctrl, FlatHashGroup::EMPTY, capacity);
+		growth_left = capacity - capacity / 8;
+	}
+
+	void resize_and_rehash(uint32_t p_new_capacity) {
+		int8_t *old_ctrl = ctrl;
+		TSlot *old_slots = slots;
+		uint32_t old_capacity = capacity;
+
+		allocate(p_new_capacity);
+
+		for (uint32_t i = 0; i < old_capacity; i++) {
+			if (old_ctrl[i] < 0) {
+				continue;
+			}
+
+			uint32_t hash = Hasher::hash(KeyOf::get(old_slots[i]));
+			uint32_t pos = find_insert_pos(hash);
+			ctrl[pos] = _get_h2(hash);
+			memnew_placement(&slots[pos], TSlot(old_slots[i]));
+			old_slots[i].~TSlot();
+		}
+		growth_left -= num_elements;
+
+		Memory::free_static(old_ctrl);
+		Memory::free_static(old_slots);
+	}
+
+	// Returns the slot holding p_key (r_exists is true), or a reserved slot
+	// where the caller must construct the new element. UINT32_MAX when the
+	// table cannot grow anymore.
+	uint32_t prepare_insert(const TKey &p_key, bool &r_exists) {
+		if (unlikely(ctrl == nullptr)) {
+			// Allocate on demand to save memory.
+			allocate(capacity);
+		}
+
+		const uint32_t hash = Hasher::hash(p_key);
+		uint32_t pos = 0;
+		r_exists = lookup_pos(p_key, hash, pos);
+		if (r_exists) {
+			return pos;
+		}
+
+		if (growth_left == 0) {
+			// Out of EMPTY slots. If most of the used ones are tombstones, cleaning
+			// them up at the same size is enough; otherwise double the capacity.
+			if (num_elements <= (capacity - capacity / 8) / 2) {
+				resize_and_rehash(capacity);
+			} else {
+				ERR_FAIL_COND_V_MSG(capacity >= (1u << 31), UINT32_MAX, "Hash table maximum capacity reached, aborting insertion.");
+				resize_and_rehash(capacity * 2);
+			}
+		}
+
+		pos = find_insert_pos(hash);
+		if (ctrl[pos] == FlatHashGroup::EMPTY) {
+			growth_left--;
+		}
+		ctrl[pos] = _get_h2(hash);
+		num_elements++;
+		return pos;
+	}
+
+	bool erase(const TKey &p_key) {
+		uint32_t pos = 0;
+		if (!lookup_pos(p_key, pos)) {
+			return false;
+		}
+
+		slots[pos].~TSlot();
+		num_elements--;
+
+		// A group that still has an EMPTY slot never overflowed into the next
+		// one, so no probe sequence goes through it and the slot can be reused
+		// freely. Otherwise leave a tombstone so lookups keep probing past it.
+		if (FlatHashGroup(ctrl + (pos & ~(FlatHashGroup::SIZE - 1))).match_empty()) {
+			ctrl[pos] = FlatHashGroup::EMPTY;
+			growth_left++;
+		} else {
+			ctrl[pos] = FlatHashGroup::DELETED;
+		}
+		return true;
+	}
+
+	void reserve(uint32_t p_elements) {
+		uint32_t new_capacity = FlatHashGroup::capacity_for(p_elements);
+
+		if (new_capacity <= capacity) {
+			return;
+		}
+
+		if (ctrl == nullptr) {
+			capacity = new_capacity;
+			return; // Unallocated yet.
+		}
+		resize_and_rehash(new_capacity);
+	}
+
+	void clear() {
+		if (ctrl == nullptr) {
+			return;
+		}
+		if (!std::is_trivially_destructible<TSlot>::value) {
+			for (uint32_t i = 0; i < capacity; i++) {
+				if (ctrl[i] >= 0) {
+					slots[i].~TSlot();
+				}
+			}
+		}
+
+		memset(ctrl, FlatHashGroup::EMPTY, capacity);
+		growth_left = capacity - capacity / 8;
+		num_elements = 0;
+	}
+
+	void init_from(const FlatHashTable &p_other) {
+		capacity = p_other.capacity;
+
+		if (p_other.ctrl == nullptr) {
+			return;
+		}
+
+		allocate(capacity);
+		memcpy(ctrl, p_other.ctrl, capacity);
+		for (uint32_t i = 0; i < capacity; i++) {
+			if (ctrl[i] >= 0) {
+				memnew_placement(&slots[i], TSlot(p_other.slots[i]));
+			}
+		}
+		num_elements = p_other.num_elements;
+		growth_left = p_other.growth_left;
+	}
+
+	void free() {
+		clear();
+
+		if (ctrl != nullptr) {
+			Memory::free_static(ctrl);
+			Memory::free_static(slots);
+			ctrl = nullptr;
+			slots = nullptr;
+		}
+	}
+
+	_FORCE_INLINE_ uint32_t first_full() const { return FlatHashGroup::next_full(ctrl, capacity, 0); }
+	_FORCE_INLINE_ uint32_t last_full() const { return FlatHashGroup::prev_full(ctrl, capacity - 1); }
+};
+
+/**
+ * A HashMap alternative that stores keys and values inline, in a single
+ * power of two sized array of slots, Swiss table style.
+ *
+ * There is no allocation per element and lookups usually resolve with a
+ * single group compare and one key comparison, which makes it a good fit for
+ * large lookup tables that are queried very often.
+ *
+ * Unlike HashMap, elements are not kept in insertion order, and inserting or
+ * erasing elements invalidates iterators and pointers to values.
+ *
+ * The assignment operator copy the pairs from one map to the other.
+ */
+
+template <class TKey, class TValue,
+		class Hasher = HashMapHasherDefault,
+		class Comparator = HashMapComparatorDefault<TKey>>
+class FlatHashMap {
+public:
+	static constexpr uint32_t MIN_CAPACITY = FlatHashGroup::SIZE;
+
+private:
+	typedef KeyValue<TKey, TValue> Element;
+
+	struct KeyOfElement {
+		static _FORCE_INLINE_ const TKey &get(const Element &p_element) { return p_element.key; }
+	};
+
+	FlatHashTable<Element, TKey, KeyOfElement, Hasher, Comparator> table;
+
+	uint32_t _insert(const TKey &p_key, const TValue &p_value) {
+		bool exists = false;
+		uint32_t pos = table.prepare_insert(p_key, exists);
+		if (exists) {
+			table.slots[pos].value = p_value;
+		} else if (pos != UINT32_MAX) {
+			memnew_placement(&table.slots[pos], Element(p_key, p_value));
+		}
+		return pos;
+	}
+
+public:
+	_FORCE_INLINE_ uint32_t get_capacity() const { return table.capacity; }
+	_FORCE_INLINE_ uint32_t size() const { return table.num_elements; }
+
+	/* Standard Godot Container API */
+
+	bool is_empty() const {
+		return table.num_elements == 0;
+	}
+
+	void clear() {
+		table.clear();
+	}
+
+	TValue &get(const TKey &p_key) {
+		uint32_t pos = 0;
+		bool exists = table.lookup_pos(p_key, pos);
+		CRASH_COND_MSG(!exists, "FlatHashMap key not found.");
+		return table.slots[pos].value;
+	}
+
+	const TValue &get(const TKey &p_key) const {
+		uint32_t pos = 0;
+		bool exists = table.lookup_pos(p_key, pos);
+		CRASH_COND_MSG(!exists, "FlatHashMap key not found.");
+		return table.slots[pos].value;
+	}
+
+	const TValue *getptr(const TKey &p_key) const {
+		uint32_t pos = 0;
+		bool exists = table.lookup_pos(p_key, pos);
+
+		if (exists) {
+			return &table.slots[pos].value;
+		}
+		return nullptr;
+	}
+
+	TValue *getptr(const TKey &p_key) {
+		uint32_t pos = 0;
+		bool exists = table.lookup_pos(p_key, pos);
+
+		if (exists) {
+			return &table.slots[pos].value;
+		}
+		return nullptr;
+	}
+
+	_FORCE_INLINE_ bool has(const TKey &p_key) const {
+		uint32_t _pos = 0;
+		return table.lookup_pos(p_key, _pos);
+	}
+
+	bool erase(const TKey &p_key) {
+		return table.erase(p_key);
+	}
+
+	// Reserves space for a number of elements, useful to avoid many resizes and rehashes.
+	// Unlike HashMap, the argument is the number of elements and not the number of slots.
+	void reserve(uint32_t p_new_capacity) {
+		table.reserve(p_new_capacity);
+	}
+
+	/** Iterator API **/
+
+	struct ConstIterator {
+		_FORCE_INLINE_ const KeyValue<TKey, TValue> &operator*() const {
+			return slots[index];
+		}
+		_FORCE_INLINE_ const KeyValue<TKey, TValue> *operator->() const { return &slots[index]; }
+		_FORCE_INLINE_ ConstIterator &operator++() {
+			if (slots) {
+				index = FlatHashGroup::next_full(ctrl, capacity, index + 1);
+				if (index == capacity) {
+					*this = ConstIterator();
+				}
+			}
+			return *this;
+		}
+		_FORCE_INLINE_ ConstIterator &operator--() {
+			if (slots) {
+				index = index == 0 ? UINT32_MAX : FlatHashGroup::prev_full(ctrl, index - 1);
+				if (index == UINT32_MAX) {
+					*this = ConstIterator();
+				}
+			}
+			return *this;
+		}
+
+		_FORCE_INLINE_ bool operator==(const ConstIterator &b) const { return slots == b.slots && index == b.index; }
+		_FORCE_INLINE_ bool operator!=(const ConstIterator &b) const { return slots != b.slots || index != b.index; }
+
+		_FORCE_INLINE_ explicit operator bool() const {
+			return slots != nullptr;
+		}
+
+		_FORCE_INLINE_ ConstIterator(const int8_t *p_ctrl, const KeyValue<TKey, TValue> *p_slots, uint32_t p_capacity, uint32_t p_index) {
+			ctrl = p_ctrl;
+			slots = p_slots;
+			capacity = p_capacity;
+			index = p_index;
+		}
+		_FORCE_INLINE_ ConstIterator() {}
+
+	private:
+		const int8_t *ctrl = nullptr;
+		const KeyValue<TKey, TValue> *slots = nullptr;
+		uint32_t capacity = 0;
+		uint32_t index = 0;
+	};
+
+	struct Iterator {
+		_FORCE_INLINE_ KeyValue<TKey, TValue> &operator*() const {
+			return slots[index];
+		}
+		_FORCE_INLINE_ KeyValue<TKey, TValue> *operator->() const { return &slots[index]; }
+		_FORCE_INLINE_ Iterator &operator++() {
+			if (slots) {
+				index = FlatHashGroup::next_full(ctrl, capacity, index + 1);
+				if (index == capacity) {
+					*this = Iterator();
+				}
+			}
+			return *this;
+		}
+		_FORCE_INLINE_ Iterator &operator--() {
+			if (slots) {
+				index = index == 0 ? UINT32_MAX : FlatHashGroup::prev_full(ctrl, index - 1);
+				if (index == UINT32_MAX) {
+					*this = Iterator();
+				}
+			}
+			return *this;
+		}
+
+		_FORCE_INLINE_ bool operator==(const Iterator &b) const { return slots == b.slots && index == b.index; }
+		_FORCE_INLINE_ bool operator!=(const Iterator &b) const { return slots != b.slots || index != b.index; }
+
+		_FORCE_INLINE_ explicit operator bool() const {
+			return slots != nullptr;
+		}
+
+		_FORCE_INLINE_ Iterator(const int8_t *p_ctrl, KeyValue<TKey, TValue> *p_slots, uint32_t p_capacity, uint32_t p_index) {
+			ctrl = p_ctrl;
+			slots = p_slots;
+			capacity = p_capacity;
+			index = p_index;
+		}
+		_FORCE_INLINE_ Iterator() {}
+
+		operator ConstIterator() const {
+			return ConstIterator(ctrl, slots, capacity, index);
+		}
+
+	private:
+		const int8_t *ctrl = nullptr;
+		KeyValue<TKey, TValue> *slots = nullptr;
+		uint32_t capacity = 0;
+		uint32_t index = 0;
+	};
+
+	_FORCE_INLINE_ Iterator begin() {
+		if (table.num_elements == 0) {
+			return Iterator();
+		}
+		return Iterator(table.ctrl, table.slots, table.capacity, table.first_full());
+	}
+	_FORCE_INLINE_ Iterator end() {
+		return Iterator();
+	}
+	_FORCE_INLINE_ Iterator last() {
+		if (table.num_elements == 0) {
+			return Iterator();
+		}
+		return Iterator(table.ctrl, table.slots, table.capacity, table.last_full());
+	}
+
+	_FORCE_INLINE_ Iterator find(const TKey &p_key) {
+		uint32_t pos = 0;
+		bool exists = table.lookup_pos(p_key, pos);
+		if (!exists) {
+			return end();
+		}
+		return Iterator(table.ctrl, table.slots, table.capacity, pos);
+	}
+
+	_FORCE_INLINE_ void remove(const Iterator &p_iter) {
+		if (p_iter) {
+			erase(p_iter->key);
+		}
+	}
+
+	_FORCE_INLINE_ ConstIterator begin() const {
+		if (table.num_elements == 0) {
+			return ConstIterator();
+		}
+		return ConstIterator(table.ctrl, table.slots, table.capacity, table.first_full());
+	}
+	_FORCE_INLINE_ ConstIterator end() const {
+		return ConstIterator();
+	}
+	_FORCE_INLINE_ ConstIterator last() const {
+		if (table.num_elements == 0) {
+			return ConstIterator();
+		}
+		return ConstIterator(table.ctrl, table.slots, table.capacity, table.last_full());
+	}
+
+	_FORCE_INLINE_ ConstIterator find(const TKey &p_key) const {
+		uint32_t pos = 0;
+		bool exists = table.lookup_pos(p_key, pos);
+		if (!exists) {
+			return end();
+		}
+		return ConstIterator(table.ctrl, table.slots, table.capacity, pos);
+	}
+
+	/* Indexing */
+
+	const TValue &operator[](const TKey &p_key) const {
+		uint32_t pos = 0;
+		bool exists = table.lookup_pos(p_key, pos);
+		CRASH_COND(!exists);
+		return table.slots[pos].value;
+	}
+
+	TValue &operator[](const TKey &p_key) {
+		bool exists = false;
+		uint32_t pos = table.prepare_insert(p_key, exists);
+		CRASH_COND(pos == UINT32_MAX);
+		if (!exists) {
+			memnew_placement(&table.slots[pos], Element(p_key, TValue()));
+		}
+		return table.slots[pos].value;
+	}
+
+	/* Insert */
+
+	// p_front_insert is accepted for compatibility with HashMap and ignored, as there is no insertion order.
+	Iterator insert(const TKey &p_key, const TValue &p_value, bool p_front_insert = false) {
+		uint32_t pos = _insert(p_key, p_value);
+		if (pos == UINT32_MAX) {
+			return end();
+		}
+		return Iterator(table.ctrl, table.slots, table.capacity, pos);
+	}
+
+	/* Constructors */
+
+	FlatHashMap(const FlatHashMap &p_other) {
+		table.init_from(p_other.table);
+	}
+
+	void operator=(const FlatHashMap &p_other) {
+		if (this == &p_other) {
+			return; // Ignore self assignment.
+		}
+
+		table.free();
+		table.init_from(p_other.table);
+	}
+
+	FlatHashMap(uint32_t p_initial_capacity) {
+		reserve(p_initial_capacity);
+	}
+	FlatHashMap() {}
+
+	void reset() {
+		table.free();
+		table.capacity = MIN_CAPACITY;
+	}
+
+	~FlatHashMap() {
+		table.free();
+	}
+};
+
+} // namespace godot
+
+#endif // GODOT_FLAT_HASH_MAP_HPP
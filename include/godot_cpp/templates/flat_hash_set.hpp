@@ -0,0 +1,219 @@
+/**************************************************************************/
+/*  flat_hash_set.hpp                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GODOT_FLAT_HASH_SET_HPP
+#define GODOT_FLAT_HASH_SET_HPP
+
+#include <godot_cpp/core/error_macros.hpp>
+#include <godot_cpp/core/memory.hpp>
+#include <godot_cpp/templates/flat_hash_map.hpp>
+#include <godot_cpp/templates/hashfuncs.hpp>
+
+namespace godot {
+
+/**
+ * Set counterpart of FlatHashMap: keys are stored inline in a power of two
+ * sized array of slots and probed in groups of 16 control bytes.
+ *
+ * Use it instead of HashSet for large, lookup heavy sets where iteration
+ * order does not matter. Inserting or erasing invalidates iterators.
+ */
+
+template <class TKey,
+		class Hasher = HashMapHasherDefault,
+		class Comparator = HashMapComparatorDefault<TKey>>
+class FlatHashSet {
+public:
+	static constexpr uint32_t MIN_CAPACITY = FlatHashGroup::SIZE;
+
+private:
+	struct KeyOfKey {
+		static _FORCE_INLINE_ const TKey &get(const TKey &p_key) { return p_key; }
+	};
+
+	FlatHashTable<TKey, TKey, KeyOfKey, Hasher, Comparator> table;
+
+public:
+	_FORCE_INLINE_ uint32_t get_capacity() const { return table.capacity; }
+	_FORCE_INLINE_ uint32_t size() const { return table.num_elements; }
+
+	/* Standard Godot Container API */
+
+	bool is_empty() const {
+		return table.num_elements == 0;
+	}
+
+	void clear() {
+		table.clear();
+	}
+
+	_FORCE_INLINE_ bool has(const TKey &p_key) const {
+		uint32_t _pos = 0;
+		return table.lookup_pos(p_key, _pos);
+	}
+
+	bool erase(const TKey &p_key) {
+		return table.erase(p_key);
+	}
+
+	// Reserves space for a number of elements, useful to avoid many resizes and rehashes.
+	// Unlike HashSet, the argument is the number of elements and not the number of slots.
+	void reserve(uint32_t p_new_capacity) {
+		table.reserve(p_new_capacity);
+	}
+
+	/** Iterator API **/
+
+	struct Iterator {
+		_FORCE_INLINE_ const TKey &operator*() const {
+			return keys[index];
+		}
+		_FORCE_INLINE_ const TKey *operator->() const {
+			return &keys[index];
+		}
+		_FORCE_INLINE_ Iterator &operator++() {
+			if (keys) {
+				index = FlatHashGroup::next_full(ctrl, capacity, index + 1);
+				if (index == capacity) {
+					*this = Iterator();
+				}
+			}
+			return *this;
+		}
+		_FORCE_INLINE_ Iterator &operator--() {
+			if (keys) {
+				index = index == 0 ? UINT32_MAX : FlatHashGroup::prev_full(ctrl, index - 1);
+				if (index == UINT32_MAX) {
+					*this = Iterator();
+				}
+			}
+			return *this;
+		}
+
+		_FORCE_INLINE_ bool operator==(const Iterator &b) const { return keys == b.keys && index == b.index; }
+		_FORCE_INLINE_ bool operator!=(const Iterator &b) const { return keys != b.keys || index != b.index; }
+
+		_FORCE_INLINE_ explicit operator bool() const {
+			return keys != nullptr;
+		}
+
+		_FORCE_INLINE_ Iterator(const int8_t *p_ctrl, const TKey *p_keys, uint32_t p_capacity, uint32_t p_index) {
+			ctrl = p_ctrl;
+			keys = p_keys;
+			capacity = p_capacity;
+			index = p_index;
+		}
+		_FORCE_INLINE_ Iterator() {}
+
+	private:
+		const int8_t *ctrl = nullptr;
+		const TKey *keys = nullptr;
+		uint32_t capacity = 0;
+		uint32_t index = 0;
+	};
+
+	_FORCE_INLINE_ Iterator begin() const {
+		if (table.num_elements == 0) {
+			return Iterator();
+		}
+		return Iterator(table.ctrl, table.slots, table.capacity, table.first_full());
+	}
+	_FORCE_INLINE_ Iterator end() const {
+		return Iterator();
+	}
+	_FORCE_INLINE_ Iterator last() const {
+		if (table.num_elements == 0) {
+			return Iterator();
+		}
+		return Iterator(table.ctrl, table.slots, table.capacity, table.last_full());
+	}
+
+	_FORCE_INLINE_ Iterator find(const TKey &p_key) const {
+		uint32_t pos = 0;
+		bool exists = table.lookup_pos(p_key, pos);
+		if (!exists) {
+			return end();
+		}
+		return Iterator(table.ctrl, table.slots, table.capacity, pos);
+	}
+
+	_FORCE_INLINE_ void remove(const Iterator &p_iter) {
+		if (p_iter) {
+			erase(*p_iter);
+		}
+	}
+
+	/* Insert */
+
+	Iterator insert(const TKey &p_key) {
+		bool exists = false;
+		uint32_t pos = table.prepare_insert(p_key, exists);
+		if (pos == UINT32_MAX) {
+			return end();
+		}
+		if (!exists) {
+			memnew_placement(&table.slots[pos], TKey(p_key));
+		}
+		return Iterator(table.ctrl, table.slots, table.capacity, pos);
+	}
+
+	/* Constructors */
+
+	FlatHashSet(const FlatHashSet &p_other) {
+		table.init_from(p_other.table);
+	}
+
+	void operator=(const FlatHashSet &p_other) {
+		if (this == &p_other) {
+			return; // Ignore self assignment.
+		}
+
+		table.free();
+		table.init_from(p_other.table);
+	}
+
+	FlatHashSet(uint32_t p_initial_capacity) {
+		reserve(p_initial_capacity);
+	}
+	FlatHashSet() {}
+
+	void reset() {
+		table.free();
+		table.capacity = MIN_CAPACITY;
+	}
+
+	~FlatHashSet() {
+		table.free();
+	}
+};
+
+} // namespace godot
+
+#endif // GODOT_FLAT_HASH_SET_HPP
@@ -0,0 +1,303 @@
+/**************************************************************************/
+/*  frozen_hash_table.hpp                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GODOT_FROZEN_HASH_TABLE_HPP
+#define GODOT_FROZEN_HASH_TABLE_HPP
+
+#include <godot_cpp/classes/global_constants.hpp>
+#include <godot_cpp/templates/hashfuncs.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/variant/char_string.hpp>
+#include <godot_cpp/variant/packed_byte_array.hpp>
+#include <godot_cpp/variant/string.hpp>
+
+#include <cstring>
+#include <type_traits>
+
+namespace godot {
+
+/**
+ * Read-only hash table stored as a single position-independent blob, meant
+ * for large static lookup data that would otherwise be parsed into a HashMap
+ * at startup.
+ *
+ * FrozenHashTableBuilder collects key/value byte strings and serializes them.
+ * FrozenHashTable queries a blob in place without copying or parsing it, and
+ * FrozenHashTableFile maps a blob from disk so lookups only touch the pages
+ * they need.
+ *
+ * Layout (all offsets are relative to the start of the blob):
+ *
+ *   FrozenHashTableHeader
+ *   FrozenHashTableSlot[slot_count]   open addressing, linear probing
+ *   key and value bytes               each value aligned to 8 bytes
+ *
+ * Blobs are written in native byte order and rejected on a mismatch.
+ */
+
+static constexpr uint32_t FROZEN_HASH_TABLE_MAGIC = 0x48464447; // "GDFH"
+static constexpr uint16_t FROZEN_HASH_TABLE_VERSION = 1;
+static constexpr uint16_t FROZEN_HASH_TABLE_BYTE_ORDER = 0x0102;
+
+struct FrozenHashTableHeader {
+	uint32_t magic;
+	uint16_t version;
+	uint16_t byte_order;
+	uint32_t entry_count;
+	uint32_t slot_count; // Power of two.
+	uint64_t seed;
+	uint64_t data_offset;
+	uint64_t total_size;
+};
+
+struct FrozenHashTableSlot {
+	uint64_t key_offset; // 0 marks an empty slot.
+	uint32_t hash; // High half of the 64-bit key hash.
+	uint32_t key_length;
+	uint32_t value_length;
+	uint32_t padding;
+
+	_FORCE_INLINE_ uint64_t get_value_offset() const { return (key_offset + key_length + 7) & ~uint64_t(7); }
+};
+
+static_assert(sizeof(FrozenHashTableHeader) == 40, "FrozenHashTableHeader must have a fixed layout.");
+static_assert(sizeof(FrozenHashTableSlot) == 24, "FrozenHashTableSlot must have a fixed layout.");
+
+// Converts keys and values to the bytes stored in the table. Trivially
+// copyable types are stored as-is, strings as UTF-8.
+template <class T>
+struct FrozenHashTableCodec {
+	static_assert(std::is_trivially_copyable<T>::value, "FrozenHashTable can only store trivially copyable types, String and PackedByteArray.");
+
+	const T &value;
+
+	_FORCE_INLINE_ FrozenHashTableCodec(const T &p_value) :
+			value(p_value) {}
+	_FORCE_INLINE_ const void *ptr() const { return &value; }
+	_FORCE_INLINE_ uint32_t size() const { return sizeof(T); }
+
+	static _FORCE_INLINE_ bool decode(const uint8_t *p_data, uint32_t p_length, T &r_value) {
+		if (p_length != sizeof(T)) {
+			return false;
+		}
+		memcpy(&r_value, p_data, sizeof(T));
+		return true;
+	}
+};
+
+template <>
+struct FrozenHashTableCodec<String> {
+	CharString utf8;
+
+	_FORCE_INLINE_ FrozenHashTableCodec(const String &p_value) :
+			utf8(p_value.utf8()) {}
+	_FORCE_INLINE_ const void *ptr() const { return utf8.get_data(); }
+	_FORCE_INLINE_ uint32_t size() const { return utf8.length(); }
+
+	static _FORCE_INLINE_ bool decode(const uint8_t *p_data, uint32_t p_length, String &r_value) {
+		r_value.parse_utf8((const char *)p_data, p_length);
+		return true;
+	}
+};
+
+// String literals, so that has("key") matches a String key.
+template <size_t N>
+struct FrozenHashTableCodec<char[N]> {
+	const char *value;
+
+	_FORCE_INLINE_ FrozenHashTableCodec(const char (&p_value)[N]) :
+			value(p_value) {}
+	_FORCE_INLINE_ const void *ptr() const { return value; }
+	_FORCE_INLINE_ uint32_t size() const { return strnlen(value, N); }
+};
+
+template <>
+struct FrozenHashTableCodec<PackedByteArray> {
+	const PackedByteArray &value;
+
+	_FORCE_INLINE_ FrozenHashTableCodec(const PackedByteArray &p_value) :
+			value(p_value) {}
+	_FORCE_INLINE_ const void *ptr() const { return value.ptr(); }
+	_FORCE_INLINE_ uint32_t size() const { return value.size(); }
+
+	static _FORCE_INLINE_ bool decode(const uint8_t *p_data, uint32_t p_length, PackedByteArray &r_value) {
+		r_value.resize(p_length);
+		if (p_length) {
+			memcpy(r_value.ptrw(), p_data, p_length);
+		}
+		return true;
+	}
+};
+
+class FrozenHashTableBuilder {
+	struct Record {
+		uint64_t hash;
+		uint64_t offset; // Into pool, key bytes followed by value bytes.
+		uint32_t key_length;
+		uint32_t value_length;
+	};
+
+	LocalVector<uint8_t> pool;
+	LocalVector<Record> records;
+	uint64_t seed = HASH_WYHASH_SEED;
+
+public:
+	// Adding a key twice keeps the last value.
+	void add_bytes(const void *p_key, uint32_t p_key_length, const void *p_value, uint32_t p_value_length);
+
+	template <class K, class V>
+	_FORCE_INLINE_ void add(const K &p_key, const V &p_value) {
+		FrozenHashTableCodec<K> key(p_key);
+		FrozenHashTableCodec<V> value(p_value);
+		add_bytes(key.ptr(), key.size(), value.ptr(), value.size());
+	}
+
+	// Changing the seed only affects blobs built afterwards.
+	void set_seed(uint64_t p_seed) { seed = p_seed; }
+	uint64_t get_seed() const { return seed; }
+
+	uint32_t size() const { return records.size(); }
+	bool is_empty() const { return records.is_empty(); }
+	void clear();
+
+	PackedByteArray build() const;
+	Error save(const String &p_path) const;
+};
+
+// Non-owning view of a blob produced by FrozenHashTableBuilder. The memory
+// must outlive the view.
+class FrozenHashTable {
+	const uint8_t *data = nullptr;
+	uint64_t data_size = 0;
+	const FrozenHashTableHeader *header = nullptr;
+	const FrozenHashTableSlot *slots = nullptr;
+	uint32_t slot_mask = 0;
+
+	const FrozenHashTableSlot *_find_slot(const void *p_key, uint32_t p_key_length) const {
+		if (unlikely(!slots)) {
+			return nullptr;
+		}
+		const uint64_t hash = hash_wyhash_buffer(p_key, p_key_length, header->seed);
+		const uint32_t tag = uint32_t(hash >> 32);
+		uint32_t pos = uint32_t(hash) & slot_mask;
+		for (uint32_t probe = 0; probe <= slot_mask; probe++) {
+			const FrozenHashTableSlot &slot = slots[pos];
+			if (slot.key_offset == 0) {
+				return nullptr;
+			}
+			if (slot.hash == tag && slot.key_length == p_key_length) {
+				// Offsets are only trusted after a bounds check, so a
+				// corrupt blob can fail lookups but never read past the end.
+				if (unlikely(slot.key_offset > data_size || data_size - slot.key_offset < slot.key_length)) {
+					return nullptr;
+				}
+				if (memcmp(data + slot.key_offset, p_key, p_key_length) == 0) {
+					const uint64_t value_offset = slot.get_value_offset();
+					if (unlikely(value_offset > data_size || data_size - value_offset < slot.value_length)) {
+						return nullptr;
+					}
+					return &slot;
+				}
+			}
+			pos = (pos + 1) & slot_mask;
+		}
+		return nullptr;
+	}
+
+public:
+	// Validates the header only, so opening is constant time regardless of
+	// the table size.
+	Error open(const uint8_t *p_data, uint64_t p_size);
+	void close();
+
+	_FORCE_INLINE_ bool is_open() const { return slots != nullptr; }
+	_FORCE_INLINE_ uint32_t size() const { return header ? header->entry_count : 0; }
+	_FORCE_INLINE_ bool is_empty() const { return size() == 0; }
+
+	// Zero-copy lookup: r_value points into the blob.
+	bool lookup_bytes(const void *p_key, uint32_t p_key_length, const uint8_t *&r_value, uint32_t &r_value_length) const {
+		const FrozenHashTableSlot *slot = _find_slot(p_key, p_key_length);
+		if (!slot) {
+			return false;
+		}
+		r_value = data + slot->get_value_offset();
+		r_value_length = slot->value_length;
+		return true;
+	}
+
+	template <class K>
+	_FORCE_INLINE_ bool has(const K &p_key) const {
+		FrozenHashTableCodec<K> key(p_key);
+		return _find_slot(key.ptr(), key.size()) != nullptr;
+	}
+
+	template <class K, class V>
+	bool lookup(const K &p_key, V &r_value) const {
+		FrozenHashTableCodec<K> key(p_key);
+		const uint8_t *value;
+		uint32_t value_length;
+		if (!lookup_bytes(key.ptr(), key.size(), value, value_length)) {
+			return false;
+		}
+		return FrozenHashTableCodec<V>::decode(value, value_length, r_value);
+	}
+
+	FrozenHashTable() {}
+	FrozenHashTable(const uint8_t *p_data, uint64_t p_size) { open(p_data, p_size); }
+};
+
+// Owns the memory behind a FrozenHashTable. Files on disk are memory-mapped
+// where the platform supports it; anything else (such as files inside a PCK)
+// is read into memory instead.
+class FrozenHashTableFile {
+	FrozenHashTable table;
+	void *mapping = nullptr;
+	uint64_t mapping_size = 0;
+	PackedByteArray buffer;
+
+	Error _map(const String &p_path);
+
+public:
+	Error open(const String &p_path);
+	void close();
+
+	_FORCE_INLINE_ bool is_open() const { return table.is_open(); }
+	_FORCE_INLINE_ bool is_mapped() const { return mapping != nullptr; }
+	_FORCE_INLINE_ const FrozenHashTable &get_table() const { return table; }
+
+	FrozenHashTableFile() {}
+	FrozenHashTableFile(const FrozenHashTableFile &) = delete;
+	FrozenHashTableFile &operator=(const FrozenHashTableFile &) = delete;
+	~FrozenHashTableFile() { close(); }
+};
+
+} // namespace godot
+
+#endif // GODOT_FROZEN_HASH_TABLE_HPP
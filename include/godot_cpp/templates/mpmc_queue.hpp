@@ -0,0 +1,166 @@
+/**************************************************************************/
+/*  mpmc_queue.hpp                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GODOT_MPMC_QUEUE_HPP
+#define GODOT_MPMC_QUEUE_HPP
+
+#include <godot_cpp/core/error_macros.hpp>
+#include <godot_cpp/core/math.hpp>
+#include <godot_cpp/core/memory.hpp>
+
+#include <atomic>
+#include <type_traits>
+
+namespace godot {
+
+/**
+ * A bounded, lock-free queue for any number of producer and consumer threads,
+ * after Dmitry Vyukov's bounded MPMC queue.
+ *
+ * Every cell carries a sequence number telling whether it is ready to be
+ * written or read for the current lap around the ring. Producers and consumers
+ * only contend on their own index (each on its own cache line) and never wait
+ * on each other: push() fails when the queue is full and pop() when it is
+ * empty.
+ *
+ * Batch operations claim a run of consecutive ready cells with a single
+ * compare-and-swap, so they may move fewer elements than requested.
+ *
+ * The capacity is rounded up to a power of two.
+ */
+template <class T>
+class MPMCQueue {
+	struct Cell {
+		std::atomic<uint32_t> sequence;
+		alignas(T) uint8_t data[sizeof(T)];
+
+		_FORCE_INLINE_ T *value() { return reinterpret_cast<T *>(data); }
+	};
+
+	alignas(64) std::atomic<uint32_t> enqueue_pos = { 0 };
+	alignas(64) std::atomic<uint32_t> dequeue_pos = { 0 };
+	alignas(64) Cell *cells = nullptr;
+	uint32_t capacity = 0;
+	uint32_t mask = 0;
+
+	// Claims up to p_max consecutive cells whose sequence is their position plus
+	// p_offset, and returns the first claimed position in r_pos.
+	_FORCE_INLINE_ uint32_t _claim(std::atomic<uint32_t> &p_pos, uint32_t p_offset, uint32_t p_max, uint32_t &r_pos) {
+		uint32_t pos = p_pos.load(std::memory_order_relaxed);
+		while (true) {
+			int32_t diff = int32_t(cells[pos & mask].sequence.load(std::memory_order_acquire) - (pos + p_offset));
+			if (diff < 0) {
+				return 0; // Full when pushing, empty when popping.
+			}
+			if (diff > 0) {
+				// Another thread claimed this cell already.
+				pos = p_pos.load(std::memory_order_relaxed);
+				continue;
+			}
+
+			uint32_t count = 1;
+			while (count < p_max && cells[(pos + count) & mask].sequence.load(std::memory_order_acquire) == pos + count + p_offset) {
+				count++;
+			}
+			if (p_pos.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed)) {
+				r_pos = pos;
+				return count;
+			}
+		}
+	}
+
+public:
+	bool push(const T &p_value) {
+		return push_batch(&p_value, 1) == 1;
+	}
+
+	// Returns how many elements were pushed, 0 if the queue is full.
+	uint32_t push_batch(const T *p_values, uint32_t p_count) {
+		uint32_t pos;
+		uint32_t count = _claim(enqueue_pos, 0, p_count, pos);
+		for (uint32_t i = 0; i < count; i++) {
+			Cell &cell = cells[(pos + i) & mask];
+			memnew_placement(cell.value(), T(p_values[i]));
+			cell.sequence.store(pos + i + 1, std::memory_order_release);
+		}
+		return count;
+	}
+
+	bool pop(T &r_value) {
+		return pop_batch(&r_value, 1) == 1;
+	}
+
+	// Returns how many elements were written to r_values, 0 if the queue is empty.
+	uint32_t pop_batch(T *r_values, uint32_t p_max) {
+		uint32_t pos;
+		uint32_t count = _claim(dequeue_pos, 1, p_max, pos);
+		for (uint32_t i = 0; i < count; i++) {
+			Cell &cell = cells[(pos + i) & mask];
+			r_values[i] = *cell.value();
+			cell.value()->~T();
+			cell.sequence.store(pos + i + capacity, std::memory_order_release);
+		}
+		return count;
+	}
+
+	// Approximate while other threads are pushing or popping.
+	_FORCE_INLINE_ uint32_t size() const {
+		return enqueue_pos.load(std::memory_order_acquire) - dequeue_pos.load(std::memory_order_acquire);
+	}
+	_FORCE_INLINE_ bool is_empty() const { return size() == 0; }
+	_FORCE_INLINE_ uint32_t get_capacity() const { return capacity; }
+
+	MPMCQueue(const MPMCQueue &) = delete;
+	MPMCQueue &operator=(const MPMCQueue &) = delete;
+
+	explicit MPMCQueue(uint32_t p_capacity) {
+		CRASH_COND_MSG(p_capacity < 2 || p_capacity > (1u << 30), "Invalid MPMCQueue capacity.");
+		capacity = next_power_of_2(p_capacity);
+		mask = capacity - 1;
+		cells = (Cell *)memalloc(sizeof(Cell) * capacity);
+		for (uint32_t i = 0; i < capacity; i++) {
+			memnew_placement(&cells[i].sequence, std::atomic<uint32_t>(i));
+		}
+	}
+
+	~MPMCQueue() {
+		if constexpr (!std::is_trivially_destructible<T>::value) {
+			const uint32_t end = enqueue_pos.load(std::memory_order_acquire);
+			for (uint32_t pos = dequeue_pos.load(std::memory_order_acquire); pos != end; pos++) {
+				cells[pos & mask].value()->~T();
+			}
+		}
+		memfree(cells);
+	}
+};
+
+} // namespace godot
+
+#endif // GODOT_MPMC_QUEUE_HPP
@@ -0,0 +1,238 @@
+/**************************************************************************/
+/*  parallel_for.hpp                                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GODOT_PARALLEL_FOR_HPP
+#define GODOT_PARALLEL_FOR_HPP
+
+#include <godot_cpp/classes/os.hpp>
+#include <godot_cpp/classes/worker_thread_pool.hpp>
+#include <godot_cpp/core/error_macros.hpp>
+#include <godot_cpp/core/math.hpp>
+#include <godot_cpp/core/memory.hpp>
+#include <godot_cpp/templates/thread_work_pool.hpp>
+#include <godot_cpp/templates/work_stealing_pool.hpp>
+
+#include <type_traits>
+
+namespace godot {
+
+/**
+ * Runs p_function over the indices in [p_begin, p_end) in parallel, and
+ * returns once it has been called for all of them.
+ *
+ * The range is cut into chunks of p_grain indices, and each chunk is one
+ * unit of work for the pool; 0 picks a grain giving a few chunks per thread.
+ * p_function is called either once per chunk, as f(chunk_begin, chunk_end),
+ * or once per index, as f(index), depending on which of the two it accepts.
+ *
+ * Work goes to p_pool when given (a ThreadWorkPool or a WorkStealingPool),
+ * otherwise to the engine WorkerThreadPool. A ThreadWorkPool can only run
+ * one job at a time, so parallel_for() calls on it must not be nested.
+ */
+
+template <class F>
+_FORCE_INLINE_ void _parallel_call(const F &p_function, uint32_t p_begin, uint32_t p_end) {
+	if constexpr (std::is_invocable<const F &, uint32_t, uint32_t>::value) {
+		p_function(p_begin, p_end);
+	} else {
+		for (uint32_t i = p_begin; i < p_end; i++) {
+			p_function(i);
+		}
+	}
+}
+
+_FORCE_INLINE_ int _parallel_thread_count(WorkerThreadPool *) {
+	return OS::get_singleton()->get_processor_count();
+}
+
+_FORCE_INLINE_ int _parallel_thread_count(ThreadWorkPool *p_pool) {
+	return p_pool ? p_pool->get_thread_count() : _parallel_thread_count((WorkerThreadPool *)nullptr);
+}
+
+_FORCE_INLINE_ int _parallel_thread_count(WorkStealingPool *p_pool) {
+	// The calling thread works too.
+	return p_pool ? p_pool->get_thread_count() + 1 : _parallel_thread_count((WorkerThreadPool *)nullptr);
+}
+
+// Cuts [p_begin, p_end) in chunks and calls p_job.run_chunk() for each of
+// them on the given pool.
+template <class J>
+struct ParallelChunks {
+	J *job = nullptr;
+	uint32_t begin = 0;
+	uint32_t end = 0;
+	uint32_t grain = 1;
+
+	_FORCE_INLINE_ uint32_t get_chunk_count() const {
+		return uint32_t((uint64_t(end - begin) + grain - 1) / grain);
+	}
+
+	_FORCE_INLINE_ void run_chunk(uint32_t p_chunk, void *) {
+		const uint64_t chunk_begin = begin + uint64_t(p_chunk) * grain;
+		const uint64_t chunk_end = MIN(chunk_begin + grain, uint64_t(end));
+		job->run_chunk(p_chunk, uint32_t(chunk_begin), uint32_t(chunk_end));
+	}
+
+	static void _group_task(void *p_userdata, uint32_t p_chunk) {
+		static_cast<ParallelChunks *>(p_userdata)->run_chunk(p_chunk, nullptr);
+	}
+
+	void dispatch(WorkerThreadPool *p_pool) {
+		if (!p_pool) {
+			p_pool = WorkerThreadPool::get_singleton();
+		}
+		WorkerThreadPool::GroupID group = p_pool->add_native_group_task(&ParallelChunks::_group_task, this, get_chunk_count(), -1, true);
+		p_pool->wait_for_group_task_completion(group);
+	}
+
+	void dispatch(ThreadWorkPool *p_pool) {
+		if (!p_pool) {
+			dispatch((WorkerThreadPool *)nullptr);
+			return;
+		}
+		p_pool->do_work(get_chunk_count(), this, &ParallelChunks::run_chunk, (void *)nullptr);
+	}
+
+	void dispatch(WorkStealingPool *p_pool) {
+		if (!p_pool) {
+			dispatch((WorkerThreadPool *)nullptr);
+			return;
+		}
+		// Chunks are already sized, so the pool should not group them further.
+		p_pool->do_work(get_chunk_count(), this, &ParallelChunks::run_chunk, (void *)nullptr, 1);
+	}
+
+	template <class Pool>
+	void setup(J *p_job, uint32_t p_begin, uint32_t p_end, uint32_t p_grain, Pool *p_pool) {
+		job = p_job;
+		begin = p_begin;
+		end = p_end;
+		if (p_grain == 0) {
+			const uint32_t threads = MAX(1, _parallel_thread_count(p_pool));
+			p_grain = MAX(1u, (p_end - p_begin) / (threads * 4));
+		}
+		grain = p_grain;
+	}
+
+	template <class Pool>
+	void execute(Pool *p_pool) {
+		if (get_chunk_count() > 1) {
+			dispatch(p_pool);
+		} else if (std::is_same<Pool, ThreadWorkPool>::value && p_pool) {
+			// Runs on the calling thread as well, but with the caller scratch
+			// arena of the pool set up for get_thread_scratch().
+			dispatch(p_pool);
+		} else {
+			// Not worth waking up other threads for.
+			run_chunk(0, nullptr);
+		}
+	}
+};
+
+template <class F>
+struct ParallelForJob {
+	const F *function;
+
+	_FORCE_INLINE_ void run_chunk(uint32_t, uint32_t p_begin, uint32_t p_end) {
+		_parallel_call(*function, p_begin, p_end);
+	}
+};
+
+template <class F, class Pool = WorkerThreadPool>
+void parallel_for(uint32_t p_begin, uint32_t p_end, uint32_t p_grain, const F &p_function, Pool *p_pool = nullptr) {
+	if (p_begin >= p_end) {
+		return;
+	}
+	ParallelForJob<F> job{ &p_function };
+	ParallelChunks<ParallelForJob<F>> chunks;
+	chunks.setup(&job, p_begin, p_end, p_grain, p_pool);
+	chunks.execute(p_pool);
+}
+
+/**
+ * Parallel fold of [p_begin, p_end): every chunk is reduced on its own,
+ * starting from p_identity, and the chunk results are then combined in
+ * order on the calling thread.
+ *
+ * p_map returns the value of one index, as map(index), or of a whole chunk,
+ * as map(chunk_begin, chunk_end). p_combine(a, b) merges two values and
+ * must be associative. As the chunks only depend on p_grain, and not on the
+ * threads that ran them, results are reproducible even for floating point
+ * sums as long as the grain is fixed.
+ *
+ * T must be default constructible and copy assignable.
+ */
+
+template <class T, class Map, class Combine>
+struct ParallelReduceJob {
+	const T *identity;
+	const Map *map;
+	const Combine *combine;
+	T *partials;
+
+	void run_chunk(uint32_t p_chunk, uint32_t p_begin, uint32_t p_end) {
+		if constexpr (std::is_invocable<const Map &, uint32_t, uint32_t>::value) {
+			partials[p_chunk] = (*combine)(*identity, (*map)(p_begin, p_end));
+		} else {
+			T value = *identity;
+			for (uint32_t i = p_begin; i < p_end; i++) {
+				value = (*combine)(value, (*map)(i));
+			}
+			partials[p_chunk] = value;
+		}
+	}
+};
+
+template <class T, class Map, class Combine, class Pool = WorkerThreadPool>
+T parallel_reduce(uint32_t p_begin, uint32_t p_end, uint32_t p_grain, const T &p_identity, const Map &p_map, const Combine &p_combine, Pool *p_pool = nullptr) {
+	if (p_begin >= p_end) {
+		return p_identity;
+	}
+
+	typedef ParallelReduceJob<T, Map, Combine> Job;
+	Job job{ &p_identity, &p_map, &p_combine, nullptr };
+	ParallelChunks<Job> chunks;
+	chunks.setup(&job, p_begin, p_end, p_grain, p_pool);
+
+	const uint32_t chunk_count = chunks.get_chunk_count();
+	job.partials = memnew_arr(T, chunk_count);
+	chunks.execute(p_pool);
+
+	T result = job.partials[0];
+	for (uint32_t i = 1; i < chunk_count; i++) {
+		result = p_combine(result, job.partials[i]);
+	}
+	memdelete_arr(job.partials);
+	return result;
+}
+
+} // namespace godot
+
+#endif // GODOT_PARALLEL_FOR_HPP
@@ -0,0 +1,258 @@
+/**************************************************************************/
+/*  parallel_sort_array.hpp                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GODOT_PARALLEL_SORT_ARRAY_HPP
+#define GODOT_PARALLEL_SORT_ARRAY_HPP
+
+#include <godot_cpp/classes/os.hpp>
+#include <godot_cpp/classes/worker_thread_pool.hpp>
+#include <godot_cpp/core/error_macros.hpp>
+#include <godot_cpp/core/memory.hpp>
+#include <godot_cpp/templates/sort_array.hpp>
+#include <godot_cpp/templates/thread_work_pool.hpp>
+
+namespace godot {
+
+/**
+ * Multithreaded counterpart of SortArray, using sample sort.
+ *
+ * A sorted sample of the array picks splitters for one bucket per task.
+ * Elements are then classified and scattered into their buckets in
+ * parallel, and every bucket is sorted by its own task with SortArray.
+ * nth_element() only runs SortArray::nth_element() on the bucket holding
+ * the nth element, as the buckets are already in order.
+ *
+ * Values frequent enough to be picked as several splitters in a row would
+ * otherwise all land in a single bucket; elements equal to such a run are
+ * spread over the buckets the run delimits instead, which only hold that
+ * value, so arrays with many duplicates are still sorted in parallel.
+ *
+ * Work is dispatched to thread_work_pool when set, otherwise to the engine
+ * WorkerThreadPool. Arrays shorter than PARALLEL_THRESHOLD are handled by
+ * SortArray directly on the calling thread.
+ *
+ * A scratch copy of the array is allocated while sorting, so T must be
+ * default constructible and copy assignable.
+ */
+
+template <class T, class Comparator = _DefaultComparator<T>, bool Validate = SORT_ARRAY_VALIDATE_ENABLED>
+class ParallelSortArray {
+public:
+	enum {
+		PARALLEL_THRESHOLD = 1 << 14,
+		OVERSAMPLING = 32,
+		MAX_BUCKETS = 256,
+	};
+
+	Comparator compare;
+	ThreadWorkPool *thread_work_pool = nullptr;
+
+private:
+	struct Context {
+		T *array = nullptr;
+		T *scratch = nullptr;
+		int len = 0;
+		uint32_t bucket_count = 0;
+		T *splitters = nullptr; // bucket_count - 1 of them.
+		uint32_t *splitter_runs = nullptr; // Index of the first splitter equal to each splitter.
+		uint8_t *element_buckets = nullptr;
+		int *chunk_offsets = nullptr; // [chunk * bucket_count + bucket], counts first and then scatter offsets.
+		int *bucket_offsets = nullptr; // bucket_count + 1 of them.
+		int nth = -1;
+		const ParallelSortArray *sorter = nullptr;
+	};
+
+	_FORCE_INLINE_ int _chunk_begin(uint32_t p_chunk, const Context *p_context) const {
+		return (int)((int64_t)p_context->len * p_chunk / p_context->bucket_count);
+	}
+
+	void _classify_chunk(uint32_t p_chunk, Context *p_context) const {
+		int *counts = p_context->chunk_offsets + p_chunk * p_context->bucket_count;
+		int end = _chunk_begin(p_chunk + 1, p_context);
+		for (int i = _chunk_begin(p_chunk, p_context); i < end; i++) {
+			// Number of splitters not greater than the element.
+			uint32_t low = 0;
+			uint32_t high = p_context->bucket_count - 1;
+			while (low < high) {
+				uint32_t mid = (low + high) / 2;
+				if (compare(p_context->array[i], p_context->splitters[mid])) {
+					high = mid;
+				} else {
+					low = mid + 1;
+				}
+			}
+			if (low > 0 && p_context->splitter_runs[low - 1] != low - 1 && !compare(p_context->splitters[low - 1], p_context->array[i])) {
+				// Equal to a run of splitters: buckets run + 1 to low can only hold this value, spread it over them.
+				uint32_t run = p_context->splitter_runs[low - 1];
+				low = run + 1 + (uint32_t)i % (low - run);
+			}
+			p_context->element_buckets[i] = (uint8_t)low;
+			counts[low]++;
+		}
+	}
+
+	void _scatter_chunk(uint32_t p_chunk, Context *p_context) const {
+		int *offsets = p_context->chunk_offsets + p_chunk * p_context->bucket_count;
+		int end = _chunk_begin(p_chunk + 1, p_context);
+		for (int i = _chunk_begin(p_chunk, p_context); i < end; i++) {
+			p_context->scratch[offsets[p_context->element_buckets[i]]++] = p_context->array[i];
+		}
+	}
+
+	void _sort_bucket(uint32_t p_bucket, Context *p_context) const {
+		int begin = p_context->bucket_offsets[p_bucket];
+		int end = p_context->bucket_offsets[p_bucket + 1];
+
+		SortArray<T, Comparator, Validate> sorter{ compare };
+		if (p_context->nth < 0) {
+			sorter.sort(p_context->scratch + begin, end - begin);
+		} else if (p_context->nth >= begin && p_context->nth < end) {
+			sorter.nth_element(0, end - begin, p_context->nth - begin, p_context->scratch + begin);
+		}
+
+		for (int i = begin; i < end; i++) {
+			p_context->array[i] = p_context->scratch[i];
+		}
+	}
+
+	template <void (ParallelSortArray::*M)(uint32_t, Context *) const>
+	static void _group_task(void *p_userdata, uint32_t p_index) {
+		Context *context = static_cast<Context *>(p_userdata);
+		(context->sorter->*M)(p_index, context);
+	}
+
+	template <void (ParallelSortArray::*M)(uint32_t, Context *) const>
+	void _run(uint32_t p_elements, Context *p_context) const {
+		if (thread_work_pool) {
+			thread_work_pool->do_work(p_elements, this, M, p_context);
+		} else {
+			WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+			WorkerThreadPool::GroupID group = pool->add_native_group_task(&ParallelSortArray::_group_task<M>, p_context, p_elements, -1, true);
+			pool->wait_for_group_task_completion(group);
+		}
+	}
+
+	uint32_t _get_bucket_count() const {
+		int threads = thread_work_pool ? thread_work_pool->get_thread_count() : OS::get_singleton()->get_processor_count();
+		// A few buckets per thread, to even out the load when the splitters are uneven.
+		return CLAMP(threads * 4, 2, (int)MAX_BUCKETS);
+	}
+
+	// Leaves the array partitioned in buckets, each one sorted (or selected, if p_nth is set).
+	void _sample_sort(T *p_array, int p_len, int p_nth) const {
+		Context context;
+		context.sorter = this;
+		context.array = p_array;
+		context.len = p_len;
+		context.nth = p_nth;
+		context.bucket_count = _get_bucket_count();
+
+		const uint32_t buckets = context.bucket_count;
+
+		// Pick splitters from a sorted, evenly spaced sample.
+		const int sample_count = buckets * OVERSAMPLING;
+		context.splitters = memnew_arr(T, sample_count);
+		for (int i = 0; i < sample_count; i++) {
+			context.splitters[i] = p_array[(int)((int64_t)p_len * i / sample_count)];
+		}
+		SortArray<T, Comparator, Validate> sample_sorter{ compare };
+		sample_sorter.sort(context.splitters, sample_count);
+		for (uint32_t i = 0; i < buckets - 1; i++) {
+			context.splitters[i] = context.splitters[(i + 1) * OVERSAMPLING];
+		}
+		context.splitter_runs = (uint32_t *)memalloc(sizeof(uint32_t) * (buckets - 1));
+		context.splitter_runs[0] = 0;
+		for (uint32_t i = 1; i < buckets - 1; i++) {
+			// Sorted, so not less than the previous one means equal.
+			bool equal = !compare(context.splitters[i - 1], context.splitters[i]);
+			context.splitter_runs[i] = equal ? context.splitter_runs[i - 1] : i;
+		}
+
+		context.element_buckets = (uint8_t *)memalloc(p_len);
+		context.chunk_offsets = (int *)memalloc(sizeof(int) * buckets * buckets);
+		context.bucket_offsets = (int *)memalloc(sizeof(int) * (buckets + 1));
+		memset(context.chunk_offsets, 0, sizeof(int) * buckets * buckets);
+
+		_run<&ParallelSortArray::_classify_chunk>(buckets, &context);
+
+		// Turn the counts into scatter offsets, bucket by bucket and then chunk by chunk.
+		int offset = 0;
+		for (uint32_t b = 0; b < buckets; b++) {
+			context.bucket_offsets[b] = offset;
+			for (uint32_t c = 0; c < buckets; c++) {
+				int count = context.chunk_offsets[c * buckets + b];
+				context.chunk_offsets[c * buckets + b] = offset;
+				offset += count;
+			}
+		}
+		context.bucket_offsets[buckets] = offset;
+
+		context.scratch = memnew_arr(T, p_len);
+		_run<&ParallelSortArray::_scatter_chunk>(buckets, &context);
+		_run<&ParallelSortArray::_sort_bucket>(buckets, &context);
+
+		memdelete_arr(context.scratch);
+		memdelete_arr(context.splitters);
+		memfree(context.splitter_runs);
+		memfree(context.element_buckets);
+		memfree(context.chunk_offsets);
+		memfree(context.bucket_offsets);
+	}
+
+public:
+	void sort(T *p_array, int p_len) const {
+		if (p_len < PARALLEL_THRESHOLD) {
+			SortArray<T, Comparator, Validate> sorter{ compare };
+			sorter.sort(p_array, p_len);
+			return;
+		}
+		_sample_sort(p_array, p_len, -1);
+	}
+
+	void sort_range(int p_first, int p_last, T *p_array) const {
+		sort(p_array + p_first, p_last - p_first);
+	}
+
+	void nth_element(int p_first, int p_last, int p_nth, T *p_array) const {
+		if (p_first == p_last || p_nth == p_last) {
+			return;
+		}
+		if (p_last - p_first < PARALLEL_THRESHOLD) {
+			SortArray<T, Comparator, Validate> sorter{ compare };
+			sorter.nth_element(p_first, p_last, p_nth, p_array);
+			return;
+		}
+		_sample_sort(p_array + p_first, p_last - p_first, p_nth - p_first);
+	}
+};
+
+} // namespace godot
+
+#endif // GODOT_PARALLEL_SORT_ARRAY_HPP
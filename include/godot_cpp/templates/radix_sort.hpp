@@ -0,0 +1,237 @@
+/**************************************************************************/
+/*  radix_sort.hpp                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GODOT_RADIX_SORT_HPP
+#define GODOT_RADIX_SORT_HPP
+
+#include <godot_cpp/core/error_macros.hpp>
+#include <godot_cpp/core/memory.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/templates/vector.hpp>
+
+#include <cstring>
+
+namespace godot {
+
+// Maps floating point values to unsigned integers with the same ordering:
+// positive values get the sign bit set, negative ones get all their bits flipped.
+static _FORCE_INLINE_ uint32_t radix_sort_key_float(float p_value) {
+	uint32_t bits;
+	memcpy(&bits, &p_value, sizeof(bits));
+	return bits ^ ((uint32_t)(-(int32_t)(bits >> 31)) | 0x80000000u);
+}
+
+static _FORCE_INLINE_ uint64_t radix_sort_key_double(double p_value) {
+	uint64_t bits;
+	memcpy(&bits, &p_value, sizeof(bits));
+	return bits ^ ((uint64_t)(-(int64_t)(bits >> 63)) | 0x8000000000000000ull);
+}
+
+/**
+ * Key extractors for RadixSort. They provide the unsigned Key type and an
+ * operator() returning, for an element, a key with the same ordering.
+ *
+ * To sort other types (e.g. structs by one of their members), write an
+ * extractor with the same shape and pass it as the second template argument.
+ */
+template <class T>
+struct RadixSortKey;
+
+#define RADIX_SORT_KEY_UNSIGNED(m_type)                                                \
+	template <>                                                                        \
+	struct RadixSortKey<m_type> {                                                      \
+		typedef m_type Key;                                                            \
+		_FORCE_INLINE_ Key operator()(const m_type &p_value) const { return p_value; } \
+	};
+
+#define RADIX_SORT_KEY_SIGNED(m_type, m_key_type)                                                                               \
+	template <>                                                                                                                 \
+	struct RadixSortKey<m_type> {                                                                                               \
+		typedef m_key_type Key;                                                                                                 \
+		_FORCE_INLINE_ Key operator()(const m_type &p_value) const { return (Key)p_value ^ ((Key)1 << (sizeof(Key) * 8 - 1)); } \
+	};
+
+RADIX_SORT_KEY_UNSIGNED(uint8_t)
+RADIX_SORT_KEY_UNSIGNED(uint16_t)
+RADIX_SORT_KEY_UNSIGNED(uint32_t)
+RADIX_SORT_KEY_UNSIGNED(uint64_t)
+RADIX_SORT_KEY_SIGNED(int8_t, uint8_t)
+RADIX_SORT_KEY_SIGNED(int16_t, uint16_t)
+RADIX_SORT_KEY_SIGNED(int32_t, uint32_t)
+RADIX_SORT_KEY_SIGNED(int64_t, uint64_t)
+
+#undef RADIX_SORT_KEY_UNSIGNED
+#undef RADIX_SORT_KEY_SIGNED
+
+template <>
+struct RadixSortKey<float> {
+	typedef uint32_t Key;
+	_FORCE_INLINE_ Key operator()(const float &p_value) const { return radix_sort_key_float(p_value); }
+};
+
+template <>
+struct RadixSortKey<double> {
+	typedef uint64_t Key;
+	_FORCE_INLINE_ Key operator()(const double &p_value) const { return radix_sort_key_double(p_value); }
+};
+
+/**
+ * Stable LSD radix sort, one byte of the key per pass.
+ *
+ * It is not comparison based, so it scales linearly and is much faster than
+ * SortArray for large arrays of integer or floating point keys. Passes on
+ * bytes that are identical for every element (e.g. the high bytes of small
+ * values) are skipped.
+ *
+ * A scratch buffer as large as the array is needed; it can be passed in to
+ * reuse it across sorts, otherwise it is allocated for the duration of the
+ * sort. NaN values are ordered by their bit pattern.
+ */
+template <class T, class KeyExtractor = RadixSortKey<T>>
+class RadixSort {
+	typedef typename KeyExtractor::Key Key;
+
+	struct NoValue {};
+
+	template <class V>
+	void _sort(T *p_array, T *p_scratch, V *p_values, V *p_value_scratch, uint32_t p_len) const {
+		constexpr bool HAS_VALUES = !std::is_same<V, NoValue>::value;
+		constexpr uint32_t PASSES = sizeof(Key);
+
+		if (p_len < 2) {
+			return;
+		}
+
+		// Build the histograms of all passes at once.
+		uint32_t histograms[PASSES][256];
+		memset(histograms, 0, sizeof(histograms));
+		for (uint32_t i = 0; i < p_len; i++) {
+			Key k = key(p_array[i]);
+			for (uint32_t pass = 0; pass < PASSES; pass++) {
+				histograms[pass][(k >> (pass * 8)) & 0xFF]++;
+			}
+		}
+
+		T *src = p_array;
+		T *dst = p_scratch;
+		V *value_src = p_values;
+		V *value_dst = p_value_scratch;
+
+		for (uint32_t pass = 0; pass < PASSES; pass++) {
+			const uint32_t shift = pass * 8;
+			uint32_t *offsets = histograms[pass];
+
+			// Every element has the same byte, this pass would not move anything.
+			if (offsets[(key(src[0]) >> shift) & 0xFF] == p_len) {
+				continue;
+			}
+
+			uint32_t offset = 0;
+			for (uint32_t i = 0; i < 256; i++) {
+				uint32_t count = offsets[i];
+				offsets[i] = offset;
+				offset += count;
+			}
+
+			for (uint32_t i = 0; i < p_len; i++) {
+				uint32_t pos = offsets[(key(src[i]) >> shift) & 0xFF]++;
+				dst[pos] = src[i];
+				if constexpr (HAS_VALUES) {
+					value_dst[pos] = value_src[i];
+				}
+			}
+
+			SWAP(src, dst);
+			SWAP(value_src, value_dst);
+		}
+
+		if (src != p_array) {
+			for (uint32_t i = 0; i < p_len; i++) {
+				p_array[i] = src[i];
+				if constexpr (HAS_VALUES) {
+					p_values[i] = value_src[i];
+				}
+			}
+		}
+	}
+
+public:
+	KeyExtractor key;
+
+	// Sorts using p_scratch, which must hold at least p_len elements.
+	void sort(T *p_array, T *p_scratch, uint32_t p_len) const {
+		_sort<NoValue>(p_array, p_scratch, nullptr, nullptr, p_len);
+	}
+
+	void sort(T *p_array, uint32_t p_len) const {
+		if (p_len < 2) {
+			return;
+		}
+		T *scratch = memnew_arr(T, p_len);
+		_sort<NoValue>(p_array, scratch, nullptr, nullptr, p_len);
+		memdelete_arr(scratch);
+	}
+
+	// Sorts p_keys, applying the same permutation to p_values.
+	template <class V>
+	void sort_with_values(T *p_keys, V *p_values, T *p_key_scratch, V *p_value_scratch, uint32_t p_len) const {
+		_sort<V>(p_keys, p_key_scratch, p_values, p_value_scratch, p_len);
+	}
+
+	template <class V>
+	void sort_with_values(T *p_keys, V *p_values, uint32_t p_len) const {
+		if (p_len < 2) {
+			return;
+		}
+		T *key_scratch = memnew_arr(T, p_len);
+		V *value_scratch = memnew_arr(V, p_len);
+		_sort<V>(p_keys, key_scratch, p_values, value_scratch, p_len);
+		memdelete_arr(key_scratch);
+		memdelete_arr(value_scratch);
+	}
+
+	template <class U, bool force_trivial, bool tight>
+	void sort(LocalVector<T, U, force_trivial, tight> &p_vector) const {
+		sort(p_vector.ptr(), p_vector.size());
+	}
+
+	// Works with Vector<T> and with the matching Packed*Array types.
+	template <class TArray>
+	void sort_array(TArray &p_array) const {
+		if (p_array.size() < 2) {
+			return;
+		}
+		sort(p_array.ptrw(), p_array.size());
+	}
+};
+
+} // namespace godot
+
+#endif // GODOT_RADIX_SORT_HPP
@@ -34,22 +34,70 @@
 #include <godot_cpp/core/memory.hpp>
 #include <godot_cpp/godot.hpp>
 #include <godot_cpp/templates/list.hpp>
+#include <godot_cpp/templates/safe_refcount.hpp>
 #include <godot_cpp/templates/spin_lock.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 
+#include <atomic>
 #include <cstdio>
 #include <typeinfo>
 
 namespace godot {
 
+class RID_AllocBase {
+	static inline SafeNumeric<uint64_t> base_id{ 0 };
+	static inline std::atomic<bool> base_id_seeded = { false };
+
+	// The engine hands out its validators from its own counter, starting at 0 too.
+	// Start half the validator range away from where it currently is, so the RIDs
+	// of both sides only collide after about a billion allocations. This can't be
+	// done before the extension is initialized, hence on the first allocation.
+	static void _seed_base_id() {
+		base_id.exchange_if_greater(uint64_t(UtilityFunctions::rid_allocate_id()) + (1u << 30));
+		base_id_seeded.store(true, std::memory_order_release);
+	}
+
+protected:
+	// RIDs are built and read directly, their only data being the 64-bit id.
+	static _FORCE_INLINE_ RID _make_from_id(uint64_t p_id) {
+		static_assert(sizeof(RID) == sizeof(uint64_t));
+		RID rid;
+		memcpy(rid._native_ptr(), &p_id, sizeof(uint64_t));
+		return rid;
+	}
+
+	static _FORCE_INLINE_ uint64_t _get_id(const RID &p_rid) {
+		uint64_t id;
+		memcpy(&id, p_rid._native_ptr(), sizeof(uint64_t));
+		return id;
+	}
+
+	// Validators come from a counter shared by all allocators, so a RID from one
+	// owner is never mistaken for one of another owner using the same index.
+	static _FORCE_INLINE_ uint32_t _gen_validator() {
+		if (unlikely(!base_id_seeded.load(std::memory_order_acquire))) {
+			_seed_base_id();
+		}
+		uint32_t validator;
+		do {
+			validator = uint32_t(base_id.increment() & 0x7FFFFFFF);
+		} while (unlikely(validator == 0 || validator == 0x7FFFFFFF)); // Reserved for the null RID and freed slots.
+		return validator;
+	}
+};
+
 template <class T, bool THREAD_SAFE = false>
-class RID_Alloc {
+class RID_Alloc : public RID_AllocBase {
+	// The chunk tables are allocated once for the maximum amount of elements and
+	// never move, so lookups can read them without taking the lock. Validators
+	// are atomic, and max_alloc is only increased once a new chunk is ready.
 	T **chunks = nullptr;
 	uint32_t **free_list_chunks = nullptr;
-	uint32_t **validator_chunks = nullptr;
+	std::atomic<uint32_t> **validator_chunks = nullptr;
 
 	uint32_t elements_in_chunk;
-	uint32_t max_alloc = 0;
+	uint32_t chunk_limit;
+	std::atomic<uint32_t> max_alloc = { 0 };
 	uint32_t alloc_count = 0;
 
 	const char *description = nullptr;
@@ -61,29 +109,29 @@ class RID_Alloc {
 			spin_lock.lock();
 		}
 
-		if (alloc_count == max_alloc) {
+		uint32_t current_max = max_alloc.load(std::memory_order_relaxed);
+		if (alloc_count == current_max) {
 			// allocate a new chunk
-			uint32_t chunk_count = alloc_count == 0 ? 0 : (max_alloc / elements_in_chunk);
+			uint32_t chunk_count = current_max / elements_in_chunk;
+			if (unlikely(chunk_count == chunk_limit)) {
+				if (THREAD_SAFE) {
+					spin_lock.unlock();
+				}
+				ERR_FAIL_V_MSG(RID(), "Element limit for RID_Alloc reached.");
+			}
 
-			// grow chunks
-			chunks = (T **)memrealloc(chunks, sizeof(T *) * (chunk_count + 1));
 			chunks[chunk_count] = (T *)memalloc(sizeof(T) * elements_in_chunk); // but don't initialize
-
-			// grow validators
-			validator_chunks = (uint32_t **)memrealloc(validator_chunks, sizeof(uint32_t *) * (chunk_count + 1));
-			validator_chunks[chunk_count] = (uint32_t *)memalloc(sizeof(uint32_t) * elements_in_chunk);
-			// grow free lists
-			free_list_chunks = (uint32_t **)memrealloc(free_list_chunks, sizeof(uint32_t *) * (chunk_count + 1));
+			validator_chunks[chunk_count] = (std::atomic<uint32_t> *)memalloc(sizeof(std::atomic<uint32_t>) * elements_in_chunk);
 			free_list_chunks[chunk_count] = (uint32_t *)memalloc(sizeof(uint32_t) * elements_in_chunk);
 
 			// initialize
 			for (uint32_t i = 0; i < elements_in_chunk; i++) {
 				// Don't initialize chunk.
-				validator_chunks[chunk_count][i] = 0xFFFFFFFF;
+				memnew_placement(&validator_chunks[chunk_count][i], std::atomic<uint32_t>(0xFFFFFFFF));
 				free_list_chunks[chunk_count][i] = alloc_count + i;
 			}
 
-			max_alloc += elements_in_chunk;
+			max_alloc.store(current_max + elements_in_chunk, std::memory_order_release);
 		}
 
 		uint32_t free_index = free_list_chunks[alloc_count / elements_in_chunk][alloc_count % elements_in_chunk];
@@ -91,14 +139,12 @@ class RID_Alloc {
 		uint32_t free_chunk = free_index / elements_in_chunk;
 		uint32_t free_element = free_index % elements_in_chunk;
 
-		uint32_t validator = (uint32_t)(UtilityFunctions::rid_allocate_id() & 0x7FFFFFFF);
+		uint32_t validator = _gen_validator();
 		uint64_t id = validator;
 		id <<= 32;
 		id |= free_index;
 
-		validator_chunks[free_chunk][free_element] = validator;
-
-		validator_chunks[free_chunk][free_element] |= 0x80000000; // mark uninitialized bit
+		validator_chunks[free_chunk][free_element].store(validator | 0x80000000, std::memory_order_release); // mark uninitialized bit
 
 		alloc_count++;
 
@@ -106,7 +152,7 @@ class RID_Alloc {
 			spin_lock.unlock();
 		}
 
-		return UtilityFunctions::rid_from_int64(id);
+		return _make_from_id(id);
 	}
 
 public:
@@ -127,19 +173,13 @@ public:
 	}
 
 	_FORCE_INLINE_ T *get_or_null(const RID &p_rid, bool p_initialize = false) {
-		if (p_rid == RID()) {
+		uint64_t id = _get_id(p_rid);
+		if (id == 0) {
 			return nullptr;
 		}
-		if (THREAD_SAFE) {
-			spin_lock.lock();
-		}
 
-		uint64_t id = p_rid.get_id();
 		uint32_t idx = uint32_t(id & 0xFFFFFFFF);
-		if (unlikely(idx >= max_alloc)) {
-			if (THREAD_SAFE) {
-				spin_lock.unlock();
-			}
+		if (unlikely(idx >= max_alloc.load(std::memory_order_acquire))) {
 			return nullptr;
 		}
 
@@ -149,14 +189,20 @@ public:
 		uint32_t validator = uint32_t(id >> 32);
 
 		if (unlikely(p_initialize)) {
-			if (unlikely(!(validator_chunks[idx_chunk][idx_element] & 0x80000000))) {
+			if (THREAD_SAFE) {
+				spin_lock.lock();
+			}
+
+			uint32_t current = validator_chunks[idx_chunk][idx_element].load(std::memory_order_relaxed);
+
+			if (unlikely(!(current & 0x80000000))) {
 				if (THREAD_SAFE) {
 					spin_lock.unlock();
 				}
 				ERR_FAIL_V_MSG(nullptr, "Initializing already initialized RID");
 			}
 
-			if (unlikely((validator_chunks[idx_chunk][idx_element] & 0x7FFFFFFF) != validator)) {
+			if (unlikely((current & 0x7FFFFFFF) != validator)) {
 				if (THREAD_SAFE) {
 					spin_lock.unlock();
 				}
@@ -164,25 +210,23 @@ public:
 				return nullptr;
 			}
 
-			validator_chunks[idx_chunk][idx_element] &= 0x7FFFFFFF; // initialized
+			validator_chunks[idx_chunk][idx_element].store(current & 0x7FFFFFFF, std::memory_order_release); // initialized
 
-		} else if (unlikely(validator_chunks[idx_chunk][idx_element] != validator)) {
 			if (THREAD_SAFE) {
 				spin_lock.unlock();
 			}
-			if ((validator_chunks[idx_chunk][idx_element] & 0x80000000) && validator_chunks[idx_chunk][idx_element] != 0xFFFFFFFF) {
-				ERR_FAIL_V_MSG(nullptr, "Attempting to use an uninitialized RID");
-			}
-			return nullptr;
-		}
-
-		T *ptr = &chunks[idx_chunk][idx_element];
 
-		if (THREAD_SAFE) {
-			spin_lock.unlock();
+		} else {
+			uint32_t current = validator_chunks[idx_chunk][idx_element].load(std::memory_order_acquire);
+			if (unlikely(current != validator)) {
+				if ((current & 0x80000000) && current != 0xFFFFFFFF) {
+					ERR_FAIL_V_MSG(nullptr, "Attempting to use an uninitialized RID");
+				}
+				return nullptr;
+			}
 		}
 
-		return ptr;
+		return &chunks[idx_chunk][idx_element];
 	}
 	void initialize_rid(RID p_rid) {
 		T *mem = get_or_null(p_rid, true);
@@ -196,16 +240,9 @@ public:
 	}
 
 	_FORCE_INLINE_ bool owns(const RID &p_rid) {
-		if (THREAD_SAFE) {
-			spin_lock.lock();
-		}
-
-		uint64_t id = p_rid.get_id();
+		uint64_t id = _get_id(p_rid);
 		uint32_t idx = uint32_t(id & 0xFFFFFFFF);
-		if (unlikely(idx >= max_alloc)) {
-			if (THREAD_SAFE) {
-				spin_lock.unlock();
-			}
+		if (unlikely(idx >= max_alloc.load(std::memory_order_acquire))) {
 			return false;
 		}
 
@@ -214,13 +251,7 @@ public:
 
 		uint32_t validator = uint32_t(id >> 32);
 
-		bool owned = (validator_chunks[idx_chunk][idx_element] & 0x7FFFFFFF) == validator;
-
-		if (THREAD_SAFE) {
-			spin_lock.unlock();
-		}
-
-		return owned;
+		return (validator_chunks[idx_chunk][idx_element].load(std::memory_order_acquire) & 0x7FFFFFFF) == validator;
 	}
 
 	_FORCE_INLINE_ void free(const RID &p_rid) {
@@ -228,9 +259,9 @@ public:
 			spin_lock.lock();
 		}
 
-		uint64_t id = p_rid.get_id();
+		uint64_t id = _get_id(p_rid);
 		uint32_t idx = uint32_t(id & 0xFFFFFFFF);
-		if (unlikely(idx >= max_alloc)) {
+		if (unlikely(idx >= max_alloc.load(std::memory_order_relaxed))) {
 			if (THREAD_SAFE) {
 				spin_lock.unlock();
 			}
@@ -241,12 +272,13 @@ public:
 		uint32_t idx_element = idx % elements_in_chunk;
 
 		uint32_t validator = uint32_t(id >> 32);
-		if (unlikely(validator_chunks[idx_chunk][idx_element] & 0x80000000)) {
+		uint32_t current = validator_chunks[idx_chunk][idx_element].load(std::memory_order_relaxed);
+		if (unlikely(current & 0x80000000)) {
 			if (THREAD_SAFE) {
 				spin_lock.unlock();
 			}
 			ERR_FAIL_MSG("Attempted to free an uninitialized or invalid RID");
-		} else if (unlikely(validator_chunks[idx_chunk][idx_element] != validator)) {
+		} else if (unlikely(current != validator)) {
 			if (THREAD_SAFE) {
 				spin_lock.unlock();
 			}
@@ -254,7 +286,7 @@ public:
 		}
 
 		chunks[idx_chunk][idx_element].~T();
-		validator_chunks[idx_chunk][idx_element] = 0xFFFFFFFF; // go invalid
+		validator_chunks[idx_chunk][idx_element].store(0xFFFFFFFF, std::memory_order_release); // go invalid
 
 		alloc_count--;
 		free_list_chunks[alloc_count / elements_in_chunk][alloc_count % elements_in_chunk] = idx;
@@ -272,10 +304,11 @@ public:
 		if (THREAD_SAFE) {
 			spin_lock.lock();
 		}
-		for (size_t i = 0; i < max_alloc; i++) {
-			uint64_t validator = validator_chunks[i / elements_in_chunk][i % elements_in_chunk];
+		uint32_t current_max = max_alloc.load(std::memory_order_relaxed);
+		for (size_t i = 0; i < current_max; i++) {
+			uint64_t validator = validator_chunks[i / elements_in_chunk][i % elements_in_chunk].load(std::memory_order_relaxed);
 			if (validator != 0xFFFFFFFF) {
-				p_owned->push_back(UtilityFunctions::rid_from_int64((validator << 32) | i));
+				p_owned->push_back(_make_from_id((validator << 32) | i));
 			}
 		}
 		if (THREAD_SAFE) {
@@ -289,10 +322,11 @@ public:
 			spin_lock.lock();
 		}
 		uint32_t idx = 0;
-		for (size_t i = 0; i < max_alloc; i++) {
-			uint64_t validator = validator_chunks[i / elements_in_chunk][i % elements_in_chunk];
+		uint32_t current_max = max_alloc.load(std::memory_order_relaxed);
+		for (size_t i = 0; i < current_max; i++) {
+			uint64_t validator = validator_chunks[i / elements_in_chunk][i % elements_in_chunk].load(std::memory_order_relaxed);
 			if (validator != 0xFFFFFFFF) {
-				p_rid_buffer[idx] = UtilityFunctions::rid_from_int64((validator << 32) | i);
+				p_rid_buffer[idx] = _make_from_id((validator << 32) | i);
 				idx++;
 			}
 		}
@@ -305,11 +339,17 @@ public:
 		description = p_descrption;
 	}
 
-	RID_Alloc(uint32_t p_target_chunk_byte_size = 65536) {
+	RID_Alloc(uint32_t p_target_chunk_byte_size = 65536, uint32_t p_maximum_number_of_elements = 262144) {
 		elements_in_chunk = sizeof(T) > p_target_chunk_byte_size ? 1 : (p_target_chunk_byte_size / sizeof(T));
+		chunk_limit = (p_maximum_number_of_elements + elements_in_chunk - 1) / elements_in_chunk;
+		chunks = (T **)memalloc(sizeof(T *) * chunk_limit);
+		validator_chunks = (std::atomic<uint32_t> **)memalloc(sizeof(std::atomic<uint32_t> *) * chunk_limit);
+		free_list_chunks = (uint32_t **)memalloc(sizeof(uint32_t *) * chunk_limit);
 	}
 
 	~RID_Alloc() {
+		uint32_t current_max = max_alloc.load(std::memory_order_relaxed);
+
 		if (alloc_count) {
 			if (description) {
 				printf("ERROR: %d  RID allocations of type '%s' were leaked at exit.", alloc_count, description);
@@ -321,8 +361,8 @@ public:
 #endif
 			}
 
-			for (size_t i = 0; i < max_alloc; i++) {
-				uint64_t validator = validator_chunks[i / elements_in_chunk][i % elements_in_chunk];
+			for (size_t i = 0; i < current_max; i++) {
+				uint64_t validator = validator_chunks[i / elements_in_chunk][i % elements_in_chunk].load(std::memory_order_relaxed);
 				if (validator & 0x80000000) {
 					continue; // uninitialized
 				}
@@ -332,18 +372,16 @@ public:
 			}
 		}
 
-		uint32_t chunk_count = max_alloc / elements_in_chunk;
+		uint32_t chunk_count = current_max / elements_in_chunk;
 		for (uint32_t i = 0; i < chunk_count; i++) {
 			memfree(chunks[i]);
 			memfree(validator_chunks[i]);
 			memfree(free_list_chunks[i]);
 		}
 
-		if (chunks) {
-			memfree(chunks);
-			memfree(free_list_chunks);
-			memfree(validator_chunks);
-		}
+		memfree(chunks);
+		memfree(free_list_chunks);
+		memfree(validator_chunks);
 	}
 };
 
@@ -402,8 +440,8 @@ public:
 		alloc.set_description(p_descrption);
 	}
 
-	RID_PtrOwner(uint32_t p_target_chunk_byte_size = 65536) :
-			alloc(p_target_chunk_byte_size) {}
+	RID_PtrOwner(uint32_t p_target_chunk_byte_size = 65536, uint32_t p_maximum_number_of_elements = 262144) :
+			alloc(p_target_chunk_byte_size, p_maximum_number_of_elements) {}
 };
 
 template <class T, bool THREAD_SAFE = false>
@@ -456,8 +494,8 @@ public:
 	void set_description(const char *p_descrption) {
 		alloc.set_description(p_descrption);
 	}
-	RID_Owner(uint32_t p_target_chunk_byte_size = 65536) :
-			alloc(p_target_chunk_byte_size) {}
+	RID_Owner(uint32_t p_target_chunk_byte_size = 65536, uint32_t p_maximum_number_of_elements = 262144) :
+			alloc(p_target_chunk_byte_size, p_maximum_number_of_elements) {}
 };
 
 } // namespace godot
@@ -0,0 +1,181 @@
+/**************************************************************************/
+/*  scratch_arena.hpp                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GODOT_SCRATCH_ARENA_HPP
+#define GODOT_SCRATCH_ARENA_HPP
+
+#include <godot_cpp/core/error_macros.hpp>
+#include <godot_cpp/core/math.hpp>
+#include <godot_cpp/core/memory.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace godot {
+
+/**
+ * Bump allocator for temporary memory, released all at once.
+ *
+ * Allocations are carved from blocks obtained with memalloc(). When a block
+ * is full, a bigger one is chained. reset() frees everything, and sizes the
+ * next block so that the same workload then fits in a single block, after
+ * which allocating is only a pointer increment.
+ *
+ * Nothing is destroyed on reset, so only trivially destructible types can
+ * be created in the arena. It is not thread-safe: each thread uses its own
+ * (see ThreadWorkPool::get_thread_scratch()).
+ */
+class ScratchArena {
+	struct alignas(16) Block {
+		Block *previous;
+		size_t size; // Usable bytes after the header.
+
+		_FORCE_INLINE_ uint8_t *get_data() { return reinterpret_cast<uint8_t *>(this + 1); }
+	};
+
+	static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+	Block *current = nullptr;
+	uint8_t *position = nullptr;
+	uint8_t *end = nullptr;
+	size_t capacity = 0; // Usable bytes of all the blocks.
+	size_t next_block_size = DEFAULT_BLOCK_SIZE;
+
+	static _FORCE_INLINE_ uint8_t *_align(uint8_t *p_pointer, size_t p_align) {
+		return reinterpret_cast<uint8_t *>((reinterpret_cast<uintptr_t>(p_pointer) + p_align - 1) & ~uintptr_t(p_align - 1));
+	}
+
+	void *_alloc_block(size_t p_size, size_t p_align) {
+		const size_t size = MAX(next_block_size, p_size + p_align);
+		Block *block = (Block *)memalloc(sizeof(Block) + size);
+		ERR_FAIL_NULL_V(block, nullptr);
+		block->previous = current;
+		block->size = size;
+		current = block;
+		capacity += size;
+		next_block_size = MAX(next_block_size, size * 2);
+
+		uint8_t *result = _align(block->get_data(), p_align);
+		position = result + p_size;
+		end = block->get_data() + size;
+		return result;
+	}
+
+	void _free_blocks_after(Block *p_block) {
+		while (current != p_block) {
+			Block *previous = current->previous;
+			capacity -= current->size;
+			memfree(current);
+			current = previous;
+		}
+	}
+
+public:
+	struct Marker {
+		Block *block = nullptr;
+		uint8_t *position = nullptr;
+	};
+
+	// p_align must be a power of two.
+	_FORCE_INLINE_ void *alloc(size_t p_size, size_t p_align = alignof(std::max_align_t)) {
+		uint8_t *result = _align(position, p_align);
+		if (likely(current && result + p_size <= end)) {
+			position = result + p_size;
+			return result;
+		}
+		return _alloc_block(p_size, p_align);
+	}
+
+	// Default-constructs p_count elements, unless T is trivially constructible.
+	template <class T>
+	T *alloc_array(size_t p_count) {
+		static_assert(std::is_trivially_destructible<T>::value, "ScratchArena never runs destructors.");
+		T *array = static_cast<T *>(alloc(sizeof(T) * p_count, alignof(T)));
+		if constexpr (!std::is_trivially_constructible<T>::value) {
+			for (size_t i = 0; i < p_count; i++) {
+				memnew_placement(&array[i], T);
+			}
+		}
+		return array;
+	}
+
+	template <class T, class... Args>
+	T *create(Args &&...p_args) {
+		static_assert(std::is_trivially_destructible<T>::value, "ScratchArena never runs destructors.");
+		return memnew_placement(alloc(sizeof(T), alignof(T)), T(std::forward<Args>(p_args)...));
+	}
+
+	// Allocations made after get_marker() can be released with rewind(), to
+	// reuse memory in a loop, while keeping earlier ones.
+	_FORCE_INLINE_ Marker get_marker() const { return Marker{ current, position }; }
+
+	void rewind(const Marker &p_marker) {
+		if (current != p_marker.block) {
+			_free_blocks_after(p_marker.block);
+			end = current ? current->get_data() + current->size : nullptr;
+		}
+		position = p_marker.position;
+	}
+
+	// Releases all the allocations.
+	void reset() {
+		if (current && current->previous) {
+			// Several blocks were needed, replace them by one the size of all
+			// of them on the next allocation.
+			next_block_size = capacity;
+			_free_blocks_after(nullptr);
+			position = nullptr;
+			end = nullptr;
+		} else if (current) {
+			position = current->get_data();
+		}
+	}
+
+	// Frees the memory, including the block kept by reset().
+	void clear() {
+		_free_blocks_after(nullptr);
+		position = nullptr;
+		end = nullptr;
+		next_block_size = DEFAULT_BLOCK_SIZE;
+	}
+
+	_FORCE_INLINE_ size_t get_capacity() const { return capacity; }
+
+	ScratchArena() {}
+	ScratchArena(const ScratchArena &) = delete;
+	ScratchArena &operator=(const ScratchArena &) = delete;
+	~ScratchArena() { clear(); }
+};
+
+} // namespace godot
+
+#endif // GODOT_SCRATCH_ARENA_HPP
@@ -33,36 +33,123 @@
 
 #include <godot_cpp/templates/sort_array.hpp>
 
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GODOT_SEARCH_ARRAY_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define GODOT_SEARCH_ARRAY_NEON
+#include <arm_neon.h>
+#endif
+
 namespace godot {
 
+// Sorted int32_t and float arrays up to this size are scanned with SIMD instead of bisected.
+constexpr int SEARCH_ARRAY_LINEAR_THRESHOLD = 32;
+
+_FORCE_INLINE_ void search_array_prefetch(const void *p_ptr) {
+#if defined(GODOT_SEARCH_ARRAY_SSE2)
+	_mm_prefetch((const char *)p_ptr, _MM_HINT_T0);
+#elif defined(__GNUC__)
+	__builtin_prefetch(p_ptr);
+#endif
+}
+
+// Returns the number of leading elements of p_array for which p_pred is true.
+// p_pred must hold for a prefix of the array and fail for the rest.
+// The loop has no data dependent branches, the next probe is selected with a
+// conditional move, and both candidate probes are prefetched on large arrays.
+template <class T, class Pred>
+_FORCE_INLINE_ int search_partition_point(const T *p_array, int p_len, const Pred &p_pred) {
+	if (p_len <= 0) {
+		return 0;
+	}
+	const T *base = p_array;
+	int n = p_len;
+	while (n > 1) {
+		const int half = n / 2;
+		if (n > 64) {
+			search_array_prefetch(base + half / 2);
+			search_array_prefetch(base + half + half / 2);
+		}
+		base = p_pred(base[half]) ? base + half : base;
+		n -= half;
+	}
+	return int(base - p_array) + (p_pred(*base) ? 1 : 0);
+}
+
+#if defined(GODOT_SEARCH_ARRAY_SSE2)
+_FORCE_INLINE_ int _search_popcount4(int p_bits) {
+	return (p_bits & 1) + ((p_bits >> 1) & 1) + ((p_bits >> 2) & 1) + ((p_bits >> 3) & 1);
+}
+#endif
+
+// Counts the elements smaller than p_value (or not greater when p_upper is
+// true), which is the bisection point of a sorted array.
+template <class T>
+_FORCE_INLINE_ int search_linear_count(const T *p_array, int p_len, T p_value, bool p_upper) {
+	static_assert(std::is_same<T, int32_t>::value || std::is_same<T, float>::value);
+	int count = 0;
+	int i = 0;
+#if defined(GODOT_SEARCH_ARRAY_SSE2)
+	if constexpr (std::is_same<T, int32_t>::value) {
+		const __m128i v = _mm_set1_epi32(p_value);
+		for (; i + 4 <= p_len; i += 4) {
+			const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p_array + i));
+			if (p_upper) {
+				// SSE2 has no integer less-or-equal, count the greater elements instead.
+				count += 4 - _search_popcount4(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(x, v))));
+			} else {
+				count += _search_popcount4(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(x, v))));
+			}
+		}
+	} else {
+		const __m128 v = _mm_set1_ps(p_value);
+		for (; i + 4 <= p_len; i += 4) {
+			const __m128 x = _mm_loadu_ps(p_array + i);
+			count += _search_popcount4(_mm_movemask_ps(p_upper ? _mm_cmple_ps(x, v) : _mm_cmplt_ps(x, v)));
+		}
+	}
+#elif defined(GODOT_SEARCH_ARRAY_NEON)
+	if constexpr (std::is_same<T, int32_t>::value) {
+		const int32x4_t v = vdupq_n_s32(p_value);
+		for (; i + 4 <= p_len; i += 4) {
+			const int32x4_t x = vld1q_s32(p_array + i);
+			const uint32x4_t mask = p_upper ? vcleq_s32(x, v) : vcltq_s32(x, v);
+			count += (int)vaddvq_u32(vshrq_n_u32(mask, 31));
+		}
+	} else {
+		const float32x4_t v = vdupq_n_f32(p_value);
+		for (; i + 4 <= p_len; i += 4) {
+			const float32x4_t x = vld1q_f32(p_array + i);
+			const uint32x4_t mask = p_upper ? vcleq_f32(x, v) : vcltq_f32(x, v);
+			count += (int)vaddvq_u32(vshrq_n_u32(mask, 31));
+		}
+	}
+#endif
+	for (; i < p_len; i++) {
+		count += p_upper ? !(p_value < p_array[i]) : p_array[i] < p_value;
+	}
+	return count;
+}
+
 template <class T, class Comparator = _DefaultComparator<T>>
 class SearchArray {
 public:
 	Comparator compare;
 
 	inline int bisect(const T *p_array, int p_len, const T &p_value, bool p_before) const {
-		int lo = 0;
-		int hi = p_len;
-		if (p_before) {
-			while (lo < hi) {
-				const int mid = (lo + hi) / 2;
-				if (compare(p_array[mid], p_value)) {
-					lo = mid + 1;
-				} else {
-					hi = mid;
-				}
+		if constexpr (std::is_same<Comparator, _DefaultComparator<T>>::value && (std::is_same<T, int32_t>::value || std::is_same<T, float>::value)) {
+			if (p_len <= SEARCH_ARRAY_LINEAR_THRESHOLD) {
+				return search_linear_count(p_array, p_len, p_value, !p_before);
 			}
+		}
+		if (p_before) {
+			return search_partition_point(p_array, p_len, [this, &p_value](const T &p_element) { return compare(p_element, p_value); });
 		} else {
-			while (lo < hi) {
-				const int mid = (lo + hi) / 2;
-				if (compare(p_value, p_array[mid])) {
-					hi = mid;
-				} else {
-					lo = mid + 1;
-				}
-			}
+			return search_partition_point(p_array, p_len, [this, &p_value](const T &p_element) { return !compare(p_value, p_element); });
 		}
-		return lo;
 	}
 };
 
@@ -0,0 +1,232 @@
+/**************************************************************************/
+/*  slot_map.hpp                                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GODOT_SLOT_MAP_HPP
+#define GODOT_SLOT_MAP_HPP
+
+#include <godot_cpp/core/error_macros.hpp>
+#include <godot_cpp/templates/hashfuncs.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+
+namespace godot {
+
+// 64-bit handle into a SlotMap: the slot index in the low half, the
+// generation of the slot in the high half. A zero handle is always null.
+class SlotMapHandle {
+	uint64_t id = 0;
+
+public:
+	_FORCE_INLINE_ bool operator==(const SlotMapHandle &p_handle) const { return id == p_handle.id; }
+	_FORCE_INLINE_ bool operator!=(const SlotMapHandle &p_handle) const { return id != p_handle.id; }
+	_FORCE_INLINE_ bool operator<(const SlotMapHandle &p_handle) const { return id < p_handle.id; }
+
+	_FORCE_INLINE_ bool is_valid() const { return id != 0; }
+	_FORCE_INLINE_ bool is_null() const { return id == 0; }
+
+	_FORCE_INLINE_ uint64_t get_id() const { return id; }
+	_FORCE_INLINE_ uint32_t get_index() const { return uint32_t(id); }
+	_FORCE_INLINE_ uint32_t get_generation() const { return uint32_t(id >> 32); }
+	_FORCE_INLINE_ uint32_t hash() const { return hash_one_uint64(id); }
+
+	_FORCE_INLINE_ static SlotMapHandle from_id(uint64_t p_id) {
+		SlotMapHandle handle;
+		handle.id = p_id;
+		return handle;
+	}
+
+	_FORCE_INLINE_ SlotMapHandle() {}
+	_FORCE_INLINE_ SlotMapHandle(uint32_t p_index, uint32_t p_generation) :
+			id((uint64_t(p_generation) << 32) | p_index) {}
+};
+
+struct HashMapHasherSlotMapHandle {
+	static _FORCE_INLINE_ uint32_t hash(const SlotMapHandle &p_handle) { return p_handle.hash(); }
+};
+
+/**
+ * Container handing out generational handles to its elements.
+ *
+ * Elements are kept packed in insertion order (until something is erased),
+ * so iterating a SlotMap is iterating a plain array. Erasing moves the last
+ * element into the hole; handles go through an indirection table and stay
+ * valid when that happens.
+ *
+ * Each slot has a generation that is odd while it holds an element and is
+ * bumped on insert and erase, so a handle to an erased element never matches
+ * again, even after its slot is reused. Generations are 32-bit: a slot has to
+ * be reused about two billion times before an old handle can alias a new
+ * element.
+ */
+template <class T>
+class SlotMap {
+	static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+	struct Slot {
+		uint32_t index; // Into values while in use, next free slot otherwise.
+		uint32_t generation; // Odd while in use.
+	};
+
+	LocalVector<T> values;
+	LocalVector<uint32_t> value_slots; // Slot of each element in values.
+	LocalVector<Slot> slots;
+	uint32_t free_head = INVALID_INDEX;
+
+	_FORCE_INLINE_ const Slot *_get_slot(const SlotMapHandle &p_handle) const {
+		const uint32_t slot_index = p_handle.get_index();
+		if (unlikely(slot_index >= slots.size())) {
+			return nullptr;
+		}
+		const Slot &slot = slots[slot_index];
+		// Handles always carry an odd generation, so a free slot never matches.
+		return slot.generation == p_handle.get_generation() ? &slot : nullptr;
+	}
+
+	SlotMapHandle _allocate_slot() {
+		uint32_t slot_index;
+		if (free_head != INVALID_INDEX) {
+			slot_index = free_head;
+			free_head = slots[slot_index].index;
+		} else {
+			CRASH_COND_MSG(slots.size() == INVALID_INDEX, "SlotMap is full.");
+			slot_index = slots.size();
+			slots.push_back({ INVALID_INDEX, 0 });
+		}
+		Slot &slot = slots[slot_index];
+		slot.index = values.size();
+		slot.generation++;
+		value_slots.push_back(slot_index);
+		return SlotMapHandle(slot_index, slot.generation);
+	}
+
+public:
+	SlotMapHandle insert(const T &p_value) {
+		SlotMapHandle handle = _allocate_slot();
+		values.push_back(p_value);
+		return handle;
+	}
+
+	bool erase(const SlotMapHandle &p_handle) {
+		const Slot *slot = _get_slot(p_handle);
+		if (!slot) {
+			return false;
+		}
+		const uint32_t index = slot->index;
+		const uint32_t last = values.size() - 1;
+		if (index != last) {
+			slots[value_slots[last]].index = index;
+			value_slots[index] = value_slots[last];
+		}
+		values.remove_at_unordered(index);
+		value_slots.resize(last);
+
+		Slot &freed = slots[p_handle.get_index()];
+		freed.generation++;
+		freed.index = free_head;
+		free_head = p_handle.get_index();
+		return true;
+	}
+
+	_FORCE_INLINE_ bool has(const SlotMapHandle &p_handle) const {
+		return _get_slot(p_handle) != nullptr;
+	}
+
+	_FORCE_INLINE_ T *get_or_null(const SlotMapHandle &p_handle) {
+		const Slot *slot = _get_slot(p_handle);
+		return slot ? &values[slot->index] : nullptr;
+	}
+
+	_FORCE_INLINE_ const T *get_or_null(const SlotMapHandle &p_handle) const {
+		const Slot *slot = _get_slot(p_handle);
+		return slot ? &values[slot->index] : nullptr;
+	}
+
+	_FORCE_INLINE_ T &get(const SlotMapHandle &p_handle) {
+		const Slot *slot = _get_slot(p_handle);
+		CRASH_COND_MSG(!slot, "SlotMap handle is invalid or its element was erased.");
+		return values[slot->index];
+	}
+
+	_FORCE_INLINE_ const T &get(const SlotMapHandle &p_handle) const {
+		const Slot *slot = _get_slot(p_handle);
+		CRASH_COND_MSG(!slot, "SlotMap handle is invalid or its element was erased.");
+		return values[slot->index];
+	}
+
+	_FORCE_INLINE_ T &operator[](const SlotMapHandle &p_handle) { return get(p_handle); }
+	_FORCE_INLINE_ const T &operator[](const SlotMapHandle &p_handle) const { return get(p_handle); }
+
+	// Position of the element in the packed array, valid until the next erase.
+	_FORCE_INLINE_ int64_t get_index(const SlotMapHandle &p_handle) const {
+		const Slot *slot = _get_slot(p_handle);
+		return slot ? int64_t(slot->index) : -1;
+	}
+
+	// Handle of the element at a position of the packed array.
+	_FORCE_INLINE_ SlotMapHandle get_handle(uint32_t p_index) const {
+		CRASH_BAD_UNSIGNED_INDEX(p_index, values.size());
+		const uint32_t slot_index = value_slots[p_index];
+		return SlotMapHandle(slot_index, slots[slot_index].generation);
+	}
+
+	_FORCE_INLINE_ uint32_t size() const { return values.size(); }
+	_FORCE_INLINE_ bool is_empty() const { return values.is_empty(); }
+
+	void reserve(uint32_t p_size) {
+		values.reserve(p_size);
+		value_slots.reserve(p_size);
+		slots.reserve(p_size);
+	}
+
+	// Erases every element. Slots are kept and their generations bumped, so
+	// handles from before the clear stay invalid.
+	void clear() {
+		for (uint32_t i = 0; i < value_slots.size(); i++) {
+			Slot &slot = slots[value_slots[i]];
+			slot.generation++;
+			slot.index = free_head;
+			free_head = value_slots[i];
+		}
+		values.clear();
+		value_slots.clear();
+	}
+
+	// Packed element storage, in no particular order.
+	_FORCE_INLINE_ T *ptr() { return values.ptr(); }
+	_FORCE_INLINE_ const T *ptr() const { return values.ptr(); }
+
+	_FORCE_INLINE_ typename LocalVector<T>::Iterator begin() { return values.begin(); }
+	_FORCE_INLINE_ typename LocalVector<T>::Iterator end() { return values.end(); }
+	_FORCE_INLINE_ typename LocalVector<T>::ConstIterator begin() const { return values.begin(); }
+	_FORCE_INLINE_ typename LocalVector<T>::ConstIterator end() const { return values.end(); }
+};
+
+} // namespace godot
+
+#endif // GODOT_SLOT_MAP_HPP
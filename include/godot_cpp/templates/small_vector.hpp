@@ -0,0 +1,364 @@
+/**************************************************************************/
+/*  small_vector.hpp                                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GODOT_SMALL_VECTOR_HPP
+#define GODOT_SMALL_VECTOR_HPP
+
+#include "godot_cpp/core/error_macros.hpp"
+#include "godot_cpp/core/memory.hpp"
+#include "godot_cpp/templates/sort_array.hpp"
+#include "godot_cpp/templates/vector.hpp"
+
+#include <initializer_list>
+#include <type_traits>
+
+namespace godot {
+
+// A LocalVector that keeps its first N elements in inline storage, and only
+// allocates once it grows beyond that. Use it for short lived vectors that
+// almost always stay small, to avoid the heap allocation altogether.
+// Like LocalVector, elements are relocated with memcpy/memrealloc when growing.
+// No pointer to the inline storage is kept, so a SmallVector can itself be
+// relocated that way, e.g. when stored in a LocalVector or a Vector.
+template <class T, uint32_t N, class U = uint32_t, bool force_trivial = false>
+class SmallVector {
+	static_assert(N > 0, "SmallVector needs an inline capacity of at least one element.");
+
+private:
+	U count = 0;
+	// Never below N, and only above N once the elements moved to the heap.
+	U capacity = N;
+	union {
+		T *heap_data;
+		alignas(T) uint8_t inline_data[sizeof(T) * N];
+	};
+
+	_FORCE_INLINE_ bool _is_inline() const {
+		return capacity <= N;
+	}
+
+	void _grow(U p_capacity) {
+		if (_is_inline()) {
+			T *heap = (T *)memalloc(p_capacity * sizeof(T));
+			CRASH_COND_MSG(!heap, "Out of memory");
+			memcpy((void *)heap, (const void *)inline_data, count * sizeof(T));
+			heap_data = heap;
+		} else {
+			heap_data = (T *)memrealloc(heap_data, p_capacity * sizeof(T));
+			CRASH_COND_MSG(!heap_data, "Out of memory");
+		}
+		capacity = p_capacity;
+	}
+
+public:
+	_FORCE_INLINE_ T *ptr() {
+		return _is_inline() ? reinterpret_cast<T *>(inline_data) : heap_data;
+	}
+
+	_FORCE_INLINE_ const T *ptr() const {
+		return _is_inline() ? reinterpret_cast<const T *>(inline_data) : heap_data;
+	}
+
+	_FORCE_INLINE_ bool is_inline() const { return _is_inline(); }
+
+	_FORCE_INLINE_ void push_back(T p_elem) {
+		if (unlikely(count == capacity)) {
+			_grow(capacity << 1);
+		}
+
+		if constexpr (!std::is_trivially_constructible<T>::value && !force_trivial) {
+			memnew_placement(&ptr()[count++], T(p_elem));
+		} else {
+			ptr()[count++] = p_elem;
+		}
+	}
+
+	void remove_at(U p_index) {
+		ERR_FAIL_UNSIGNED_INDEX(p_index, count);
+		T *data = ptr();
+		count--;
+		for (U i = p_index; i < count; i++) {
+			data[i] = data[i + 1];
+		}
+		if constexpr (!std::is_trivially_destructible<T>::value && !force_trivial) {
+			data[count].~T();
+		}
+	}
+
+	/// Removes the item copying the last value into the position of the one to
+	/// remove. It's generally faster than `remove`.
+	void remove_at_unordered(U p_index) {
+		ERR_FAIL_INDEX(p_index, count);
+		T *data = ptr();
+		count--;
+		if (count > p_index) {
+			data[p_index] = data[count];
+		}
+		if constexpr (!std::is_trivially_destructible<T>::value && !force_trivial) {
+			data[count].~T();
+		}
+	}
+
+	void erase(const T &p_val) {
+		int64_t idx = find(p_val);
+		if (idx >= 0) {
+			remove_at(idx);
+		}
+	}
+
+	void invert() {
+		T *data = ptr();
+		for (U i = 0; i < count / 2; i++) {
+			SWAP(data[i], data[count - i - 1]);
+		}
+	}
+
+	_FORCE_INLINE_ void clear() { resize(0); }
+	// Also releases the heap allocation, if any, going back to inline storage.
+	_FORCE_INLINE_ void reset() {
+		clear();
+		if (!_is_inline()) {
+			memfree(heap_data);
+			capacity = N;
+		}
+	}
+	_FORCE_INLINE_ bool is_empty() const { return count == 0; }
+	_FORCE_INLINE_ U get_capacity() const { return capacity; }
+	_FORCE_INLINE_ void reserve(U p_size) {
+		if (p_size > capacity) {
+			_grow(nearest_power_of_2_templated(p_size));
+		}
+	}
+
+	_FORCE_INLINE_ U size() const { return count; }
+	void resize(U p_size) {
+		if (p_size < count) {
+			if constexpr (!std::is_trivially_destructible<T>::value && !force_trivial) {
+				T *data = ptr();
+				for (U i = p_size; i < count; i++) {
+					data[i].~T();
+				}
+			}
+			count = p_size;
+		} else if (p_size > count) {
+			if (unlikely(p_size > capacity)) {
+				U new_capacity = capacity;
+				while (new_capacity < p_size) {
+					new_capacity <<= 1;
+				}
+				_grow(new_capacity);
+			}
+			if constexpr (!std::is_trivially_constructible<T>::value && !force_trivial) {
+				T *data = ptr();
+				for (U i = count; i < p_size; i++) {
+					memnew_placement(&data[i], T);
+				}
+			}
+			count = p_size;
+		}
+	}
+	_FORCE_INLINE_ const T &operator[](U p_index) const {
+		CRASH_BAD_UNSIGNED_INDEX(p_index, count);
+		return ptr()[p_index];
+	}
+	_FORCE_INLINE_ T &operator[](U p_index) {
+		CRASH_BAD_UNSIGNED_INDEX(p_index, count);
+		return ptr()[p_index];
+	}
+
+	struct Iterator {
+		_FORCE_INLINE_ T &operator*() const {
+			return *elem_ptr;
+		}
+		_FORCE_INLINE_ T *operator->() const { return elem_ptr; }
+		_FORCE_INLINE_ Iterator &operator++() {
+			elem_ptr++;
+			return *this;
+		}
+		_FORCE_INLINE_ Iterator &operator--() {
+			elem_ptr--;
+			return *this;
+		}
+
+		_FORCE_INLINE_ bool operator==(const Iterator &b) const { return elem_ptr == b.elem_ptr; }
+		_FORCE_INLINE_ bool operator!=(const Iterator &b) const { return elem_ptr != b.elem_ptr; }
+
+		Iterator(T *p_ptr) { elem_ptr = p_ptr; }
+		Iterator() {}
+		Iterator(const Iterator &p_it) { elem_ptr = p_it.elem_ptr; }
+
+	private:
+		T *elem_ptr = nullptr;
+	};
+
+	struct ConstIterator {
+		_FORCE_INLINE_ const T &operator*() const {
+			return *elem_ptr;
+		}
+		_FORCE_INLINE_ const T *operator->() const { return elem_ptr; }
+		_FORCE_INLINE_ ConstIterator &operator++() {
+			elem_ptr++;
+			return *this;
+		}
+		_FORCE_INLINE_ ConstIterator &operator--() {
+			elem_ptr--;
+			return *this;
+		}
+
+		_FORCE_INLINE_ bool operator==(const ConstIterator &b) const { return elem_ptr == b.elem_ptr; }
+		_FORCE_INLINE_ bool operator!=(const ConstIterator &b) const { return elem_ptr != b.elem_ptr; }
+
+		ConstIterator(const T *p_ptr) { elem_ptr = p_ptr; }
+		ConstIterator() {}
+		ConstIterator(const ConstIterator &p_it) { elem_ptr = p_it.elem_ptr; }
+
+	private:
+		const T *elem_ptr = nullptr;
+	};
+
+	_FORCE_INLINE_ Iterator begin() {
+		return Iterator(ptr());
+	}
+	_FORCE_INLINE_ Iterator end() {
+		return Iterator(ptr() + size());
+	}
+
+	_FORCE_INLINE_ ConstIterator begin() const {
+		return ConstIterator(ptr());
+	}
+	_FORCE_INLINE_ ConstIterator end() const {
+		return ConstIterator(ptr() + size());
+	}
+
+	void insert(U p_pos, T p_val) {
+		ERR_FAIL_UNSIGNED_INDEX(p_pos, count + 1);
+		if (p_pos == count) {
+			push_back(p_val);
+		} else {
+			resize(count + 1);
+			T *data = ptr();
+			for (U i = count - 1; i > p_pos; i--) {
+				data[i] = data[i - 1];
+			}
+			data[p_pos] = p_val;
+		}
+	}
+
+	int64_t find(const T &p_val, U p_from = 0) const {
+		const T *data = ptr();
+		for (U i = p_from; i < count; i++) {
+			if (data[i] == p_val) {
+				return int64_t(i);
+			}
+		}
+		return -1;
+	}
+
+	template <class C>
+	void sort_custom() {
+		U len = count;
+		if (len == 0) {
+			return;
+		}
+
+		SortArray<T, C> sorter;
+		sorter.sort(ptr(), len);
+	}
+
+	void sort() {
+		sort_custom<_DefaultComparator<T>>();
+	}
+
+	void ordered_insert(T p_val) {
+		const T *data = ptr();
+		U i;
+		for (i = 0; i < count; i++) {
+			if (p_val < data[i]) {
+				break;
+			}
+		}
+		insert(i, p_val);
+	}
+
+	operator Vector<T>() const {
+		Vector<T> ret;
+		ret.resize(size());
+		T *w = ret.ptrw();
+		memcpy(w, ptr(), sizeof(T) * count);
+		return ret;
+	}
+
+	Vector<uint8_t> to_byte_array() const { //useful to pass stuff to gpu or variant
+		Vector<uint8_t> ret;
+		ret.resize(count * sizeof(T));
+		uint8_t *w = ret.ptrw();
+		memcpy(w, ptr(), sizeof(T) * count);
+		return ret;
+	}
+
+	_FORCE_INLINE_ SmallVector() {}
+	_FORCE_INLINE_ SmallVector(std::initializer_list<T> p_init) {
+		reserve(p_init.size());
+		for (const T &element : p_init) {
+			push_back(element);
+		}
+	}
+	_FORCE_INLINE_ SmallVector(const SmallVector &p_from) {
+		resize(p_from.size());
+		T *data = ptr();
+		const T *from = p_from.ptr();
+		for (U i = 0; i < p_from.count; i++) {
+			data[i] = from[i];
+		}
+	}
+	inline void operator=(const SmallVector &p_from) {
+		resize(p_from.size());
+		T *data = ptr();
+		const T *from = p_from.ptr();
+		for (U i = 0; i < p_from.count; i++) {
+			data[i] = from[i];
+		}
+	}
+	inline void operator=(const Vector<T> &p_from) {
+		resize(p_from.size());
+		T *data = ptr();
+		for (U i = 0; i < count; i++) {
+			data[i] = p_from[i];
+		}
+	}
+
+	_FORCE_INLINE_ ~SmallVector() {
+		reset();
+	}
+};
+
+} // namespace godot
+
+#endif // GODOT_SMALL_VECTOR_HPP
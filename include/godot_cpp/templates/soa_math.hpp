@@ -0,0 +1,152 @@
+/**************************************************************************/
+/*  soa_math.hpp                                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GODOT_SOA_MATH_HPP
+#define GODOT_SOA_MATH_HPP
+
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/variant/packed_float32_array.hpp>
+#include <godot_cpp/variant/packed_vector3_array.hpp>
+#include <godot_cpp/variant/quaternion.hpp>
+#include <godot_cpp/variant/transform3d.hpp>
+
+namespace godot {
+
+struct QuaternionSoA;
+
+// Structure of arrays containers for bulk math (particles, flocks, ...):
+// each component lives in its own array, so the batch operations below
+// process four elements per SIMD instruction instead of one, with the same
+// results as the per element Vector3, Quaternion and Transform3D methods.
+// Batch operations that take another container require the same size.
+
+struct Vector3SoA {
+	LocalVector<real_t> x;
+	LocalVector<real_t> y;
+	LocalVector<real_t> z;
+
+	_FORCE_INLINE_ uint32_t size() const { return x.size(); }
+	_FORCE_INLINE_ bool is_empty() const { return x.is_empty(); }
+	// New elements are zero vectors.
+	void resize(uint32_t p_size);
+	void clear();
+
+	_FORCE_INLINE_ Vector3 get(uint32_t p_index) const {
+		return Vector3(x[p_index], y[p_index], z[p_index]);
+	}
+	_FORCE_INLINE_ void set(uint32_t p_index, const Vector3 &p_value) {
+		x[p_index] = p_value.x;
+		y[p_index] = p_value.y;
+		z[p_index] = p_value.z;
+	}
+	void push_back(const Vector3 &p_value);
+
+	void add(const Vector3SoA &p_other);
+	void add(const Vector3 &p_offset);
+	// Adds p_other * p_scale, e.g. velocities times the frame delta.
+	void add_scaled(const Vector3SoA &p_other, real_t p_scale);
+	void scale(real_t p_scale);
+	// Zero vectors stay zero, as with Vector3::normalize().
+	void normalize();
+	void rotate(const Quaternion &p_rotation);
+	void rotate(const QuaternionSoA &p_rotations);
+
+	void from_packed_array(const PackedVector3Array &p_array);
+	PackedVector3Array to_packed_array() const;
+	// Three floats (x, y, z) per vector.
+	void from_float32_array(const PackedFloat32Array &p_array);
+	PackedFloat32Array to_float32_array() const;
+};
+
+struct QuaternionSoA {
+	LocalVector<real_t> x;
+	LocalVector<real_t> y;
+	LocalVector<real_t> z;
+	LocalVector<real_t> w;
+
+	_FORCE_INLINE_ uint32_t size() const { return x.size(); }
+	_FORCE_INLINE_ bool is_empty() const { return x.is_empty(); }
+	// New elements are identity quaternions.
+	void resize(uint32_t p_size);
+	void clear();
+
+	_FORCE_INLINE_ Quaternion get(uint32_t p_index) const {
+		return Quaternion(x[p_index], y[p_index], z[p_index], w[p_index]);
+	}
+	_FORCE_INLINE_ void set(uint32_t p_index, const Quaternion &p_value) {
+		x[p_index] = p_value.x;
+		y[p_index] = p_value.y;
+		z[p_index] = p_value.z;
+		w[p_index] = p_value.w;
+	}
+	void push_back(const Quaternion &p_value);
+
+	void normalize();
+	// Each element becomes element * p_other[i], as with Quaternion::operator*=().
+	void multiply(const QuaternionSoA &p_other);
+	void multiply(const Quaternion &p_rotation);
+
+	// Four floats (x, y, z, w) per quaternion.
+	void from_float32_array(const PackedFloat32Array &p_array);
+	PackedFloat32Array to_float32_array() const;
+};
+
+struct TransformSoA {
+	Vector3SoA basis[3]; // Rows of the bases.
+	Vector3SoA origin;
+
+	_FORCE_INLINE_ uint32_t size() const { return origin.size(); }
+	_FORCE_INLINE_ bool is_empty() const { return origin.is_empty(); }
+	// New elements are identity transforms.
+	void resize(uint32_t p_size);
+	void clear();
+
+	Transform3D get(uint32_t p_index) const;
+	void set(uint32_t p_index, const Transform3D &p_value);
+	void push_back(const Transform3D &p_value);
+	// Rotation from p_rotations (normalized), translation from p_origins.
+	void set_rotations_and_origins(const QuaternionSoA &p_rotations, const Vector3SoA &p_origins);
+
+	// Each element becomes element * p_other[i], as with Transform3D::operator*=().
+	void compose(const TransformSoA &p_other);
+	// Each element becomes p_parent * element.
+	void compose_parent(const Transform3D &p_parent);
+	// Transforms the points in place, p_points[i] = element.xform(p_points[i]).
+	void xform(Vector3SoA &p_points) const;
+
+	// Twelve floats per transform, in the MultiMesh buffer layout:
+	// basis row 0, origin.x, basis row 1, origin.y, basis row 2, origin.z.
+	void from_float32_array(const PackedFloat32Array &p_array);
+	PackedFloat32Array to_float32_array() const;
+};
+
+} // namespace godot
+
+#endif // GODOT_SOA_MATH_HPP
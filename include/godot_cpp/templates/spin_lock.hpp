@@ -31,21 +31,236 @@
 #ifndef GODOT_SPIN_LOCK_HPP
 #define GODOT_SPIN_LOCK_HPP
 
+#include <godot_cpp/core/defs.hpp>
+
 #include <atomic>
+#include <cstdint>
+#include <thread>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <emmintrin.h>
+#elif defined(_M_ARM64) || defined(_M_ARM)
+#include <intrin.h>
+#endif
+
+// Define SPIN_LOCK_PARKING_ENABLED to have SpinLock put waiting threads to sleep
+// on a futex once spinning and yielding didn't get the lock (Linux only), and
+// SPIN_LOCK_STATS_ENABLED to count how often locks were found already taken.
+#if defined(SPIN_LOCK_PARKING_ENABLED) && defined(__linux__)
+#define GODOT_SPIN_LOCK_FUTEX
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 namespace godot {
 
+// Waits a little longer each time wait() is called: spins with a pause hint
+// for 1, 2, 4... up to 64 iterations, then starts yielding the thread.
+class SpinBackoff {
+	static constexpr uint32_t MAX_SPINS = 64;
+	uint32_t spins = 1;
+
+public:
+	// Tells the CPU this is a spin-wait loop.
+	static _ALWAYS_INLINE_ void pause() {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+		_mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+		__asm__ __volatile__("yield");
+#elif defined(_M_ARM64) || defined(_M_ARM)
+		__yield();
+#endif
+	}
+
+	_ALWAYS_INLINE_ void wait() {
+		if (spins <= MAX_SPINS) {
+			for (uint32_t i = 0; i < spins; i++) {
+				pause();
+			}
+			spins <<= 1;
+		} else {
+			std::this_thread::yield();
+		}
+	}
+
+	_ALWAYS_INLINE_ bool is_yielding() const {
+		return spins > MAX_SPINS;
+	}
+};
+
+// Test-and-test-and-set lock: waiting threads spin on a plain load, so the
+// cache line is only written when the lock looks free.
 class SpinLock {
-	std::atomic_flag locked = ATOMIC_FLAG_INIT;
+	// 0: unlocked, 1: locked, 2: locked and some thread may be parked.
+	std::atomic<uint32_t> state = { 0 };
+#ifdef SPIN_LOCK_STATS_ENABLED
+	std::atomic<uint32_t> contention_count = { 0 };
+#endif
+
+#ifdef GODOT_SPIN_LOCK_FUTEX
+	_FORCE_INLINE_ void _futex_wait(uint32_t p_value) {
+		syscall(SYS_futex, reinterpret_cast<uint32_t *>(&state), FUTEX_WAIT_PRIVATE, p_value, nullptr, nullptr, 0);
+	}
+	_FORCE_INLINE_ void _futex_wake() {
+		syscall(SYS_futex, reinterpret_cast<uint32_t *>(&state), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+	}
+#endif
+
+	void _lock_contended() {
+#ifdef SPIN_LOCK_STATS_ENABLED
+		contention_count.fetch_add(1, std::memory_order_relaxed);
+#endif
+		SpinBackoff backoff;
+		while (true) {
+			while (state.load(std::memory_order_relaxed) != 0) {
+#ifdef GODOT_SPIN_LOCK_FUTEX
+				if (backoff.is_yielding()) {
+					// Park until the owner wakes us. Taking the lock this way leaves it marked
+					// as contended, so our unlock() wakes the next parked thread.
+					while (state.exchange(2, std::memory_order_acquire) != 0) {
+						_futex_wait(2);
+					}
+					return;
+				}
+#endif
+				backoff.wait();
+			}
+			uint32_t expected = 0;
+			if (state.compare_exchange_weak(expected, 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+				return;
+			}
+		}
+	}
 
 public:
 	_ALWAYS_INLINE_ void lock() {
-		while (locked.test_and_set(std::memory_order_acquire)) {
-			;
+		uint32_t expected = 0;
+		if (likely(state.compare_exchange_weak(expected, 1, std::memory_order_acquire, std::memory_order_relaxed))) {
+			return;
 		}
+		_lock_contended();
 	}
+
+	_ALWAYS_INLINE_ bool try_lock() {
+		uint32_t expected = 0;
+		return state.load(std::memory_order_relaxed) == 0 && state.compare_exchange_strong(expected, 1, std::memory_order_acquire, std::memory_order_relaxed);
+	}
+
 	_ALWAYS_INLINE_ void unlock() {
-		locked.clear(std::memory_order_release);
+#ifdef GODOT_SPIN_LOCK_FUTEX
+		if (unlikely(state.exchange(0, std::memory_order_release) == 2)) {
+			_futex_wake();
+		}
+#else
+		state.store(0, std::memory_order_release);
+#endif
+	}
+
+#ifdef SPIN_LOCK_STATS_ENABLED
+	// Number of lock() calls that found the lock taken.
+	_ALWAYS_INLINE_ uint32_t get_contention_count() const {
+		return contention_count.load(std::memory_order_relaxed);
+	}
+#endif
+};
+
+// Reader-writer spin lock for read-mostly data. Any number of readers can hold
+// it at once. A waiting writer blocks new readers, so writers can't starve.
+class RWSpinLock {
+	static constexpr uint32_t WRITER = 1u << 31;
+	static constexpr uint32_t WRITER_WAITING = 1u << 30;
+	static constexpr uint32_t READERS_MASK = WRITER_WAITING - 1;
+
+	std::atomic<uint32_t> state = { 0 };
+#ifdef SPIN_LOCK_STATS_ENABLED
+	std::atomic<uint32_t> read_contention_count = { 0 };
+	std::atomic<uint32_t> write_contention_count = { 0 };
+#endif
+
+public:
+	_ALWAYS_INLINE_ bool try_read_lock() {
+		uint32_t current = state.load(std::memory_order_relaxed);
+		return !(current & (WRITER | WRITER_WAITING)) && state.compare_exchange_weak(current, current + 1, std::memory_order_acquire, std::memory_order_relaxed);
+	}
+
+	void read_lock() {
+		if (likely(try_read_lock())) {
+			return;
+		}
+#ifdef SPIN_LOCK_STATS_ENABLED
+		read_contention_count.fetch_add(1, std::memory_order_relaxed);
+#endif
+		SpinBackoff backoff;
+		while (!try_read_lock()) {
+			backoff.wait();
+		}
+	}
+
+	_ALWAYS_INLINE_ void read_unlock() {
+		state.fetch_sub(1, std::memory_order_release);
+	}
+
+	_ALWAYS_INLINE_ bool try_write_lock() {
+		uint32_t current = state.load(std::memory_order_relaxed);
+		// Taking the lock clears our own waiting flag, other waiting writers set it again.
+		return !(current & (WRITER | READERS_MASK)) && state.compare_exchange_weak(current, WRITER, std::memory_order_acquire, std::memory_order_relaxed);
+	}
+
+	void write_lock() {
+		if (likely(try_write_lock())) {
+			return;
+		}
+#ifdef SPIN_LOCK_STATS_ENABLED
+		write_contention_count.fetch_add(1, std::memory_order_relaxed);
+#endif
+		SpinBackoff backoff;
+		while (!try_write_lock()) {
+			uint32_t current = state.load(std::memory_order_relaxed);
+			if (!(current & WRITER_WAITING)) {
+				state.fetch_or(WRITER_WAITING, std::memory_order_relaxed);
+			}
+			backoff.wait();
+		}
+	}
+
+	_ALWAYS_INLINE_ void write_unlock() {
+		state.fetch_and(~WRITER, std::memory_order_release);
+	}
+
+#ifdef SPIN_LOCK_STATS_ENABLED
+	_ALWAYS_INLINE_ uint32_t get_read_contention_count() const {
+		return read_contention_count.load(std::memory_order_relaxed);
+	}
+	_ALWAYS_INLINE_ uint32_t get_write_contention_count() const {
+		return write_contention_count.load(std::memory_order_relaxed);
+	}
+#endif
+};
+
+class RWSpinLockRead {
+	RWSpinLock &lock;
+
+public:
+	_ALWAYS_INLINE_ explicit RWSpinLockRead(RWSpinLock &p_lock) :
+			lock(p_lock) {
+		lock.read_lock();
+	}
+	_ALWAYS_INLINE_ ~RWSpinLockRead() {
+		lock.read_unlock();
+	}
+};
+
+class RWSpinLockWrite {
+	RWSpinLock &lock;
+
+public:
+	_ALWAYS_INLINE_ explicit RWSpinLockWrite(RWSpinLock &p_lock) :
+			lock(p_lock) {
+		lock.write_lock();
+	}
+	_ALWAYS_INLINE_ ~RWSpinLockWrite() {
+		lock.write_unlock();
 	}
 };
 
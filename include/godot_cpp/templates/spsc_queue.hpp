@@ -0,0 +1,171 @@
+/**************************************************************************/
+/*  spsc_queue.hpp                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GODOT_SPSC_QUEUE_HPP
+#define GODOT_SPSC_QUEUE_HPP
+
+#include <godot_cpp/core/error_macros.hpp>
+#include <godot_cpp/core/math.hpp>
+#include <godot_cpp/core/memory.hpp>
+
+#include <atomic>
+#include <type_traits>
+
+namespace godot {
+
+/**
+ * A bounded, lock-free queue for exactly one producer thread and one consumer
+ * thread, implemented as a ring buffer.
+ *
+ * push() may only be called from the producer thread and pop() from the
+ * consumer thread. The two indices live on separate cache lines, and each side
+ * keeps a cached copy of the other side's index so that it only reads the
+ * shared one when the queue looks full (or empty).
+ *
+ * The capacity is rounded up to a power of two. Batch operations move as many
+ * elements as fit with a single index update.
+ */
+template <class T>
+class SPSCQueue {
+	// Written by the consumer.
+	alignas(64) std::atomic<uint32_t> head = { 0 };
+	uint32_t cached_tail = 0;
+
+	// Written by the producer.
+	alignas(64) std::atomic<uint32_t> tail = { 0 };
+	uint32_t cached_head = 0;
+
+	alignas(64) T *buffer = nullptr;
+	uint32_t capacity = 0;
+	uint32_t mask = 0;
+
+	_FORCE_INLINE_ uint32_t _free_for_push(uint32_t p_tail, uint32_t p_wanted) {
+		uint32_t free_slots = capacity - (p_tail - cached_head);
+		if (free_slots < p_wanted) {
+			cached_head = head.load(std::memory_order_acquire);
+			free_slots = capacity - (p_tail - cached_head);
+		}
+		return free_slots;
+	}
+
+	_FORCE_INLINE_ uint32_t _available_for_pop(uint32_t p_head, uint32_t p_wanted) {
+		uint32_t available = cached_tail - p_head;
+		if (available < p_wanted) {
+			cached_tail = tail.load(std::memory_order_acquire);
+			available = cached_tail - p_head;
+		}
+		return available;
+	}
+
+public:
+	// Producer side.
+	bool push(const T &p_value) {
+		const uint32_t t = tail.load(std::memory_order_relaxed);
+		if (_free_for_push(t, 1) == 0) {
+			return false;
+		}
+		memnew_placement(&buffer[t & mask], T(p_value));
+		tail.store(t + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Producer side. Returns how many elements were pushed, which is less than
+	// p_count if the queue filled up.
+	uint32_t push_batch(const T *p_values, uint32_t p_count) {
+		const uint32_t t = tail.load(std::memory_order_relaxed);
+		const uint32_t count = MIN(p_count, _free_for_push(t, p_count));
+		for (uint32_t i = 0; i < count; i++) {
+			memnew_placement(&buffer[(t + i) & mask], T(p_values[i]));
+		}
+		if (count) {
+			tail.store(t + count, std::memory_order_release);
+		}
+		return count;
+	}
+
+	// Consumer side.
+	bool pop(T &r_value) {
+		const uint32_t h = head.load(std::memory_order_relaxed);
+		if (_available_for_pop(h, 1) == 0) {
+			return false;
+		}
+		T &slot = buffer[h & mask];
+		r_value = slot;
+		slot.~T();
+		head.store(h + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Consumer side. Returns how many elements were written to r_values, at most p_max.
+	uint32_t pop_batch(T *r_values, uint32_t p_max) {
+		const uint32_t h = head.load(std::memory_order_relaxed);
+		const uint32_t count = MIN(p_max, _available_for_pop(h, p_max));
+		for (uint32_t i = 0; i < count; i++) {
+			T &slot = buffer[(h + i) & mask];
+			r_values[i] = slot;
+			slot.~T();
+		}
+		if (count) {
+			head.store(h + count, std::memory_order_release);
+		}
+		return count;
+	}
+
+	// Only exact when neither side is running concurrently.
+	_FORCE_INLINE_ uint32_t size() const {
+		return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+	}
+	_FORCE_INLINE_ bool is_empty() const { return size() == 0; }
+	_FORCE_INLINE_ uint32_t get_capacity() const { return capacity; }
+
+	SPSCQueue(const SPSCQueue &) = delete;
+	SPSCQueue &operator=(const SPSCQueue &) = delete;
+
+	explicit SPSCQueue(uint32_t p_capacity) {
+		CRASH_COND_MSG(p_capacity == 0 || p_capacity > (1u << 31), "Invalid SPSCQueue capacity.");
+		capacity = next_power_of_2(p_capacity);
+		mask = capacity - 1;
+		buffer = (T *)memalloc(sizeof(T) * capacity);
+	}
+
+	~SPSCQueue() {
+		if constexpr (!std::is_trivially_destructible<T>::value) {
+			const uint32_t t = tail.load(std::memory_order_acquire);
+			for (uint32_t h = head.load(std::memory_order_acquire); h != t; h++) {
+				buffer[h & mask].~T();
+			}
+		}
+		memfree(buffer);
+	}
+};
+
+} // namespace godot
+
+#endif // GODOT_SPSC_QUEUE_HPP
@@ -0,0 +1,285 @@
+/**************************************************************************/
+/*  task_graph.hpp                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GODOT_TASK_GRAPH_HPP
+#define GODOT_TASK_GRAPH_HPP
+
+#include <godot_cpp/classes/global_constants.hpp>
+#include <godot_cpp/core/error_macros.hpp>
+#include <godot_cpp/core/memory.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/templates/parallel_for.hpp>
+#include <godot_cpp/templates/spin_lock.hpp>
+#include <godot_cpp/variant/string.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+namespace godot {
+
+/**
+ * Graph of jobs built once and executed any number of times, typically once
+ * per frame.
+ *
+ * Each node runs a callable, either once, or split over an index range like
+ * parallel_for() (fan-out). A node starts as soon as all the nodes it depends
+ * on are done, so independent branches overlap instead of being separated by
+ * barriers. Executing the graph does not allocate: the dependency counters
+ * are reset from counts computed once by compile().
+ *
+ * Ready nodes are picked by critical path first: the longest chain of work,
+ * as timed on the previous execution, that still has to run after them.
+ *
+ * On the engine WorkerThreadPool, the calling thread runs chunks too, and
+ * pool runners are started as chunks become ready. They hand their thread
+ * back to the pool as soon as nothing is ready (after a short spin), and one
+ * engine thread is always left to other work, so nodes can call
+ * parallel_for() or wait for TaskFutures on the engine pool.
+ *
+ * On a ThreadWorkPool or a WorkStealingPool, runners keep their thread for
+ * the whole execution and sleep while nothing is ready, so nodes must not
+ * wait for work queued on that same pool.
+ *
+ * With tracing enabled, the start and end of every node (and chunk) are
+ * recorded on each execution. save_trace() writes them in the Chrome trace
+ * event format, readable by chrome://tracing or Perfetto. Only the most
+ * recent events are kept, up to the trace capacity.
+ */
+class TaskGraph {
+public:
+	typedef uint32_t NodeID;
+
+	enum {
+		DEFAULT_CHUNKS = 32,
+		DEFAULT_TRACE_CAPACITY = 1 << 16,
+	};
+
+private:
+	struct NodeFunction {
+		virtual void call(uint32_t p_begin, uint32_t p_end) = 0;
+		virtual ~NodeFunction() {}
+	};
+
+	template <class F>
+	struct NodeFunctionImpl : public NodeFunction {
+		F function;
+
+		virtual void call(uint32_t p_begin, uint32_t p_end) override {
+			_parallel_call(function, p_begin, p_end);
+		}
+
+		NodeFunctionImpl(F &&p_function) :
+				function(std::move(p_function)) {}
+	};
+
+	template <class F>
+	struct SingleFunctionImpl : public NodeFunction {
+		F function;
+
+		virtual void call(uint32_t, uint32_t) override {
+			function();
+		}
+
+		SingleFunctionImpl(F &&p_function) :
+				function(std::move(p_function)) {}
+	};
+
+	struct Node {
+		String name;
+		NodeFunction *function = nullptr;
+		uint32_t elements = 1;
+		uint32_t grain = 1;
+		uint32_t chunk_count = 1;
+		LocalVector<NodeID> successors;
+		uint32_t dependency_count = 0;
+
+		// Longest path of work from the start of this node to the end of
+		// the graph, in microseconds.
+		uint64_t priority = 0;
+		uint64_t duration_usec = 1;
+
+		std::atomic<uint32_t> pending_dependencies = { 0 };
+		std::atomic<uint32_t> pending_chunks = { 0 };
+		std::atomic<uint64_t> start_usec = { 0 };
+		uint64_t end_usec = 0;
+	};
+
+	struct ReadyChunk {
+		uint64_t priority;
+		NodeID node;
+		uint32_t chunk;
+	};
+
+	struct TraceEvent {
+		NodeID node;
+		uint32_t chunk;
+		uint32_t thread;
+		uint32_t frame;
+		uint64_t start_usec;
+		uint64_t end_usec;
+	};
+
+	LocalVector<Node *> nodes;
+	LocalVector<NodeID> order; // Topological order, set by compile().
+	uint32_t total_chunks = 0;
+	bool compiled = false;
+
+	// Binary max-heap on priority.
+	SpinLock ready_lock;
+	LocalVector<ReadyChunk> ready;
+	uint32_t ready_count = 0;
+	std::atomic<uint32_t> remaining_nodes = { 0 };
+
+	static constexpr uint32_t IDLE_SPINS = 16;
+	std::mutex idle_mutex;
+	std::condition_variable idle_condition;
+	std::atomic<uint32_t> idle_runners = { 0 };
+	std::atomic<uint32_t> ready_epoch = { 0 };
+
+	// Runners on the engine WorkerThreadPool, see _execute_on_engine().
+	WorkerThreadPool *engine_pool = nullptr;
+	std::mutex runner_mutex;
+	uint32_t max_engine_runners = 0;
+	uint32_t active_runners = 0;
+	LocalVector<WorkerThreadPool::TaskID> runner_tasks;
+	// Trace thread ids not in use by a runner; the calling thread is 0.
+	LocalVector<uint32_t> free_runner_ids;
+	uint32_t free_runner_count = 0;
+
+	bool tracing = false;
+	uint32_t frame = 0;
+	LocalVector<TraceEvent> frame_events;
+	std::atomic<uint32_t> frame_event_count = { 0 };
+	// Ring of the last trace_capacity events, oldest at trace_start once full.
+	LocalVector<TraceEvent> trace;
+	uint32_t trace_start = 0;
+	uint32_t trace_capacity = DEFAULT_TRACE_CAPACITY;
+
+	static uint64_t _get_ticks_usec();
+
+	void _push_ready(NodeID p_node);
+	bool _pop_ready(ReadyChunk &r_chunk);
+	bool _spin_ready(ReadyChunk &r_chunk);
+	bool _wait_ready(ReadyChunk &r_chunk);
+	void _wake_runners(bool p_all);
+	void _request_runners(uint32_t p_ready, uint32_t p_pushed);
+	static void _engine_runner(void *p_graph);
+	void _execute_on_engine(WorkerThreadPool *p_pool);
+	void _run_ready(uint32_t p_runner, const ReadyChunk &p_chunk);
+	void _complete_node(Node *p_node);
+	void _begin_execution();
+	void _end_execution();
+	void _update_priorities();
+
+	NodeID _add_node(const String &p_name, NodeFunction *p_function, uint32_t p_elements, uint32_t p_grain);
+
+public:
+	// Runs p_function() once.
+	template <class F>
+	NodeID add_node(const String &p_name, F p_function) {
+		typedef SingleFunctionImpl<F> Impl;
+		return _add_node(p_name, memnew(Impl(std::move(p_function))), 1, 1);
+	}
+
+	// Runs p_function over [0, p_elements), in chunks of p_grain indices
+	// that may run on different threads (0 cuts the range in about
+	// DEFAULT_CHUNKS chunks). p_function takes either an index or a
+	// (chunk_begin, chunk_end) pair, as with parallel_for().
+	template <class F>
+	NodeID add_parallel_node(const String &p_name, uint32_t p_elements, uint32_t p_grain, F p_function) {
+		typedef NodeFunctionImpl<F> Impl;
+		return _add_node(p_name, memnew(Impl(std::move(p_function))), p_elements, p_grain);
+	}
+
+	// p_after only starts once p_before is done.
+	void add_dependency(NodeID p_before, NodeID p_after);
+
+	// Validates the graph and prepares it for execution. Called by execute()
+	// after the graph has been modified.
+	Error compile();
+
+	// Runs every node once and returns when all are done. Work goes to
+	// p_pool when given (a ThreadWorkPool or a WorkStealingPool),
+	// otherwise to the engine WorkerThreadPool.
+	template <class Pool = WorkerThreadPool>
+	Error execute(Pool *p_pool = nullptr) {
+		if (!compiled) {
+			Error err = compile();
+			if (err != OK) {
+				return err;
+			}
+		}
+		if (nodes.is_empty()) {
+			return OK;
+		}
+
+		if constexpr (std::is_same<Pool, WorkerThreadPool>::value) {
+			_execute_on_engine(p_pool ? p_pool : WorkerThreadPool::get_singleton());
+		} else {
+			_begin_execution();
+			// Every runner pulls ready chunks until the whole graph is done.
+			const uint32_t runners = MIN(total_chunks, (uint32_t)MAX(1, _parallel_thread_count(p_pool)));
+			ParallelChunks<TaskGraph> chunks;
+			chunks.setup(this, 0, runners, 1, p_pool);
+			chunks.execute(p_pool);
+			_end_execution();
+		}
+		return OK;
+	}
+
+	// Used by the runners started in execute().
+	void run_chunk(uint32_t p_runner, uint32_t p_begin, uint32_t p_end);
+
+	_FORCE_INLINE_ uint32_t get_node_count() const { return nodes.size(); }
+	String get_node_name(NodeID p_node) const;
+	// Wall time of the node during the last execution.
+	uint64_t get_node_time_usec(NodeID p_node) const;
+
+	void set_tracing_enabled(bool p_enabled) { tracing = p_enabled; }
+	bool is_tracing_enabled() const { return tracing; }
+	// Number of events kept by the trace; older ones are dropped. Clears
+	// the trace.
+	void set_trace_capacity(uint32_t p_events);
+	uint32_t get_trace_capacity() const { return trace_capacity; }
+	Error save_trace(const String &p_path) const;
+	void clear_trace();
+
+	void clear();
+
+	TaskGraph() {}
+	TaskGraph(const TaskGraph &) = delete;
+	TaskGraph &operator=(const TaskGraph &) = delete;
+	~TaskGraph() { clear(); }
+};
+
+} // namespace godot
+
+#endif // GODOT_TASK_GRAPH_HPP
@@ -35,10 +35,14 @@
 #include <godot_cpp/classes/semaphore.hpp>
 #include <godot_cpp/core/error_macros.hpp>
 #include <godot_cpp/core/memory.hpp>
+#include <godot_cpp/templates/cpu_topology.hpp>
+#include <godot_cpp/templates/scratch_arena.hpp>
 
 #include <thread>
 
 #include <atomic>
+#include <chrono>
+#include <cstdio>
 
 namespace godot {
 
@@ -48,7 +52,8 @@ class ThreadWorkPool {
 	struct BaseWork {
 		std::atomic<uint32_t> *index = nullptr;
 		uint32_t max_elements = 0;
-		virtual void work() = 0;
+		// Returns how many elements were processed.
+		virtual uint32_t work() = 0;
 		virtual ~BaseWork() = default;
 	};
 
@@ -57,14 +62,17 @@ class ThreadWorkPool {
 		C *instance;
 		M method;
 		U userdata;
-		virtual void work() {
+		virtual uint32_t work() {
+			uint32_t processed = 0;
 			while (true) {
 				uint32_t work_index = index->fetch_add(1, std::memory_order_relaxed);
 				if (work_index >= max_elements) {
 					break;
 				}
 				(instance->*method)(work_index, userdata);
+				processed++;
 			}
+			return processed;
 		}
 	};
 
@@ -74,6 +82,13 @@ class ThreadWorkPool {
 		Semaphore completed;
 		std::atomic<bool> exit;
 		BaseWork *work;
+
+		char name[16] = {};
+		LocalVector<uint32_t> cpus; // Empty when not pinned.
+		std::atomic<uint64_t> busy_usec = { 0 };
+		std::atomic<uint64_t> items_processed = { 0 };
+
+		ScratchArena scratch;
 	};
 
 	ThreadData *threads = nullptr;
@@ -81,19 +96,38 @@ class ThreadWorkPool {
 	uint32_t threads_working = 0;
 	BaseWork *current_work = nullptr;
 
+	// Used when do_work() runs a single element on the calling thread.
+	ScratchArena caller_scratch;
+	static inline thread_local ScratchArena *current_scratch = nullptr;
+
 	static void _thread_function(void *p_user) {
 		ThreadData *thread = static_cast<ThreadData *>(p_user);
+		current_scratch = &thread->scratch;
+		CPUTopology::set_current_thread_name(thread->name);
+		if (!thread->cpus.is_empty()) {
+			CPUTopology::set_current_thread_affinity(thread->cpus);
+		}
 		while (true) {
 			thread->start.wait();
 			if (thread->exit.load()) {
 				break;
 			}
-			thread->work->work();
+			const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			const uint32_t processed = thread->work->work();
+			const uint64_t busy = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+			thread->busy_usec.fetch_add(busy, std::memory_order_relaxed);
+			thread->items_processed.fetch_add(processed, std::memory_order_relaxed);
+			thread->scratch.reset();
 			thread->completed.post();
 		}
 	}
 
 public:
+	struct WorkerStats {
+		uint64_t busy_usec = 0; // Time spent running work, not waiting for it.
+		uint64_t items_processed = 0;
+	};
+
 	template <class C, class M, class U>
 	void begin_work(uint32_t p_elements, C *p_instance, M p_method, U p_userdata) {
 		ERR_FAIL_NULL(threads); // Never initialized.
@@ -154,7 +188,13 @@ public:
 			case 1:
 				// No value in pushing the work to another thread if it's a single job
 				// and we're going to wait for it to finish. Just run it right here.
-				(p_instance->*p_method)(0, p_userdata);
+				{
+					ScratchArena *previous_scratch = current_scratch;
+					current_scratch = &caller_scratch;
+					(p_instance->*p_method)(0, p_userdata);
+					caller_scratch.reset();
+					current_scratch = previous_scratch;
+				}
 				break;
 			default:
 				// Multiple jobs to do; commence threaded business.
@@ -164,7 +204,35 @@ public:
 	}
 
 	_FORCE_INLINE_ int get_thread_count() const { return thread_count; }
-	void init(int p_thread_count = -1) {
+
+	// Scratch memory of the worker running the current work item, for
+	// temporaries that don't outlive the work: every worker's arena is reset
+	// before end_work() returns. Only valid from inside the work method.
+	static ScratchArena &get_thread_scratch() {
+		CRASH_COND_MSG(current_scratch == nullptr, "ThreadWorkPool::get_thread_scratch() called outside of a work item.");
+		return *current_scratch;
+	}
+
+	// Stats accumulate until reset_worker_stats(). Only exact once end_work()
+	// returned.
+	WorkerStats get_worker_stats(uint32_t p_thread) const {
+		ERR_FAIL_UNSIGNED_INDEX_V(p_thread, thread_count, WorkerStats());
+		WorkerStats stats;
+		stats.busy_usec = threads[p_thread].busy_usec.load(std::memory_order_relaxed);
+		stats.items_processed = threads[p_thread].items_processed.load(std::memory_order_relaxed);
+		return stats;
+	}
+
+	void reset_worker_stats() {
+		for (uint32_t i = 0; i < thread_count; i++) {
+			threads[i].busy_usec.store(0, std::memory_order_relaxed);
+			threads[i].items_processed.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	// Threads are named "<p_name> <index>" for profilers and debuggers, and
+	// pinned to CPUs according to p_placement (see CPUTopology).
+	void init(int p_thread_count = -1, CPUTopology::Placement p_placement = CPUTopology::PLACEMENT_NONE, const char *p_name = "WorkPool") {
 		ERR_FAIL_COND(threads != nullptr);
 		if (p_thread_count < 0) {
 			p_thread_count = OS::get_singleton()->get_processor_count();
@@ -175,6 +243,10 @@ public:
 
 		for (uint32_t i = 0; i < thread_count; i++) {
 			threads[i].exit.store(false);
+			snprintf(threads[i].name, sizeof(threads[i].name), "%s %u", p_name, i);
+			if (p_placement != CPUTopology::PLACEMENT_NONE) {
+				CPUTopology::get_singleton().get_thread_cpus(p_placement, i, threads[i].cpus);
+			}
 			threads[i].thread = std::thread(&ThreadWorkPool::_thread_function, &threads[i]);
 		}
 	}
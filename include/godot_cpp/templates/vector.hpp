@@ -34,6 +34,10 @@
 /**
  * @class Vector
  * Vector container. Regular Vector Container. Use with care and for smaller arrays when possible. Use Vector for large arrays.
+ *
+ * Copies share their data (see CowData), so every write checks the reference count first.
+ * In hot loops, call ptrw() once before the loop and write through the returned pointer.
+ * For data that is never shared, LocalVector has no reference count or atomics at all.
  */
 
 #include <godot_cpp/core/error_macros.hpp>
@@ -295,9 +299,10 @@ public:
 
 template <class T>
 void Vector<T>::reverse() {
-	for (Size i = 0; i < size() / 2; i++) {
-		T *p = ptrw();
-		SWAP(p[i], p[size() - i - 1]);
+	const Size s = size();
+	T *p = ptrw();
+	for (Size i = 0; i < s / 2; i++) {
+		SWAP(p[i], p[s - i - 1]);
 	}
 }
 
@@ -309,8 +314,9 @@ void Vector<T>::append_array(Vector<T> p_other) {
 	}
 	const Size bs = size();
 	resize(bs + ds);
+	T *w = ptrw();
 	for (Size i = 0; i < ds; ++i) {
-		ptrw()[bs + i] = p_other[i];
+		w[bs + i] = p_other[i];
 	}
 }
 
@@ -32,6 +32,7 @@
 #define GODOT_VMAP_HPP
 
 #include <godot_cpp/templates/cowdata.hpp>
+#include <godot_cpp/templates/search_array.hpp>
 
 namespace godot {
 
@@ -53,65 +54,19 @@ public:
 private:
 	CowData<Pair> _cowdata;
 
+	// Branchless lower bound, see search_partition_point().
 	_FORCE_INLINE_ int _find(const T &p_val, bool &r_exact) const {
-		r_exact = false;
-		if (_cowdata.is_empty()) {
-			return 0;
-		}
-
-		int low = 0;
-		int high = _cowdata.size() - 1;
 		const Pair *a = _cowdata.ptr();
-		int middle = 0;
-
-#ifdef DEBUG_ENABLED
-		if (low > high) {
-			ERR_PRINT("low > high, this may be a bug");
-		}
-#endif
-		while (low <= high) {
-			middle = (low + high) / 2;
-
-			if (p_val < a[middle].key) {
-				high = middle - 1; // search low end of array
-			} else if (a[middle].key < p_val) {
-				low = middle + 1; // search high end of array
-			} else {
-				r_exact = true;
-				return middle;
-			}
-		}
-
-		// return the position where this would be inserted
-		if (a[middle].key < p_val) {
-			middle++;
-		}
-		return middle;
+		const int size = _cowdata.size();
+		int pos = search_partition_point(a, size, [&p_val](const Pair &p_pair) { return p_pair.key < p_val; });
+		r_exact = pos < size && !(p_val < a[pos].key);
+		return pos;
 	}
 
 	_FORCE_INLINE_ int _find_exact(const T &p_val) const {
-		if (_cowdata.is_empty()) {
-			return -1;
-		}
-
-		int low = 0;
-		int high = _cowdata.size() - 1;
-		int middle;
-		const Pair *a = _cowdata.ptr();
-
-		while (low <= high) {
-			middle = (low + high) / 2;
-
-			if (p_val < a[middle].key) {
-				high = middle - 1; // search low end of array
-			} else if (a[middle].key < p_val) {
-				low = middle + 1; // search high end of array
-			} else {
-				return middle;
-			}
-		}
-
-		return -1;
+		bool exact;
+		int pos = _find(p_val, exact);
+		return exact ? pos : -1;
 	}
 
 public:
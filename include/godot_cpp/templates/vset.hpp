@@ -31,6 +31,7 @@
 #ifndef GODOT_VSET_HPP
 #define GODOT_VSET_HPP
 
+#include <godot_cpp/templates/search_array.hpp>
 #include <godot_cpp/templates/vector.hpp>
 
 namespace godot {
@@ -39,66 +40,29 @@ template <class T>
 class VSet {
 	Vector<T> _data;
 
+	// Branchless lower bound, see search_partition_point(). Small sets of
+	// int32_t or float are scanned with SIMD instead.
 	_FORCE_INLINE_ int _find(const T &p_val, bool &r_exact) const {
-		r_exact = false;
-		if (_data.is_empty()) {
-			return 0;
-		}
-
-		int low = 0;
-		int high = _data.size() - 1;
-		const T *a = &_data[0];
-		int middle = 0;
-
-#ifdef DEBUG_ENABLED
-		if (low > high) {
-			ERR_PRINT("low > high, this may be a bug");
-		}
-#endif
-
-		while (low <= high) {
-			middle = (low + high) / 2;
-
-			if (p_val < a[middle]) {
-				high = middle - 1; // search low end of array
-			} else if (a[middle] < p_val) {
-				low = middle + 1; // search high end of array
+		const T *a = _data.ptr();
+		const int size = _data.size();
+		int pos;
+		if constexpr (std::is_same<T, int32_t>::value || std::is_same<T, float>::value) {
+			if (size <= SEARCH_ARRAY_LINEAR_THRESHOLD) {
+				pos = search_linear_count(a, size, p_val, false);
 			} else {
-				r_exact = true;
-				return middle;
+				pos = search_partition_point(a, size, [&p_val](const T &p_elem) { return p_elem < p_val; });
 			}
+		} else {
+			pos = search_partition_point(a, size, [&p_val](const T &p_elem) { return p_elem < p_val; });
 		}
-
-		// return the position where this would be inserted
-		if (a[middle] < p_val) {
-			middle++;
-		}
-		return middle;
+		r_exact = pos < size && !(p_val < a[pos]);
+		return pos;
 	}
 
 	_FORCE_INLINE_ int _find_exact(const T &p_val) const {
-		if (_data.is_empty()) {
-			return -1;
-		}
-
-		int low = 0;
-		int high = _data.size() - 1;
-		int middle;
-		const T *a = &_data[0];
-
-		while (low <= high) {
-			middle = (low + high) / 2;
-
-			if (p_val < a[middle]) {
-				high = middle - 1; // search low end of array
-			} else if (a[middle] < p_val) {
-				low = middle + 1; // search high end of array
-			} else {
-				return middle;
-			}
-		}
-
-		return -1;
+		bool exact;
+		int pos = _find(p_val, exact);
+		return exact ? pos : -1;
 	}
 
 public:
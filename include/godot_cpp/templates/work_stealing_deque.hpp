@@ -0,0 +1,174 @@
+/**************************************************************************/
+/*  work_stealing_deque.hpp                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GODOT_WORK_STEALING_DEQUE_HPP
+#define GODOT_WORK_STEALING_DEQUE_HPP
+
+#include <godot_cpp/core/error_macros.hpp>
+#include <godot_cpp/core/math.hpp>
+#include <godot_cpp/core/memory.hpp>
+
+#include <atomic>
+#include <type_traits>
+
+namespace godot {
+
+/**
+ * Chase-Lev work-stealing deque.
+ *
+ * One owner thread pushes and pops at the bottom, like a stack, while any
+ * number of other threads steal from the top. The owner only synchronizes
+ * with thieves when the deque is down to its last element.
+ *
+ * The ring buffer grows when full. Old buffers may still be read by a thief
+ * that is about to lose its race, so they are kept until the deque is
+ * destroyed; since each buffer is twice the size of the previous one, this
+ * at most doubles the memory used.
+ *
+ * T must be a small trivially copyable type, typically a pointer.
+ */
+template <class T>
+class WorkStealingDeque {
+	static_assert(std::is_trivially_copyable<T>::value && sizeof(T) <= sizeof(void *), "WorkStealingDeque stores pointer-sized values.");
+
+	struct Buffer {
+		int64_t mask = 0;
+		std::atomic<T> *items = nullptr;
+		Buffer *previous = nullptr;
+
+		_FORCE_INLINE_ T get(int64_t p_index) const { return items[p_index & mask].load(std::memory_order_relaxed); }
+		_FORCE_INLINE_ void put(int64_t p_index, T p_value) { items[p_index & mask].store(p_value, std::memory_order_relaxed); }
+	};
+
+	alignas(64) std::atomic<int64_t> top = { 0 };
+	alignas(64) std::atomic<int64_t> bottom = { 0 };
+	alignas(64) std::atomic<Buffer *> buffer = { nullptr };
+
+	static Buffer *_create_buffer(int64_t p_capacity) {
+		Buffer *b = memnew(Buffer);
+		b->mask = p_capacity - 1;
+		b->items = (std::atomic<T> *)memalloc(sizeof(std::atomic<T>) * p_capacity);
+		for (int64_t i = 0; i < p_capacity; i++) {
+			memnew_placement(&b->items[i], std::atomic<T>{});
+		}
+		return b;
+	}
+
+	Buffer *_grow(Buffer *p_buffer, int64_t p_top, int64_t p_bottom) {
+		Buffer *b = _create_buffer((p_buffer->mask + 1) * 2);
+		for (int64_t i = p_top; i < p_bottom; i++) {
+			b->put(i, p_buffer->get(i));
+		}
+		b->previous = p_buffer;
+		buffer.store(b, std::memory_order_release);
+		return b;
+	}
+
+public:
+	// Owner only.
+	void push(T p_value) {
+		const int64_t b = bottom.load(std::memory_order_relaxed);
+		const int64_t t = top.load(std::memory_order_acquire);
+		Buffer *buf = buffer.load(std::memory_order_relaxed);
+		if (unlikely(b - t > buf->mask)) {
+			buf = _grow(buf, t, b);
+		}
+		buf->put(b, p_value);
+		bottom.store(b + 1, std::memory_order_release);
+	}
+
+	// Owner only. Takes the most recently pushed element.
+	bool pop(T &r_value) {
+		const int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+		Buffer *buf = buffer.load(std::memory_order_relaxed);
+		// Publishing the new bottom before reading top is what makes the owner
+		// and a thief agree on who gets the last element.
+		bottom.store(b, std::memory_order_seq_cst);
+		int64_t t = top.load(std::memory_order_seq_cst);
+		if (t > b) {
+			bottom.store(b + 1, std::memory_order_relaxed);
+			return false;
+		}
+		r_value = buf->get(b);
+		if (t == b) {
+			const bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+			bottom.store(b + 1, std::memory_order_relaxed);
+			return won;
+		}
+		return true;
+	}
+
+	// Any thread. Takes the oldest element; fails when the deque is empty or
+	// another thread took the element first.
+	bool steal(T &r_value) {
+		int64_t t = top.load(std::memory_order_seq_cst);
+		const int64_t b = bottom.load(std::memory_order_seq_cst);
+		if (t >= b) {
+			return false;
+		}
+		Buffer *buf = buffer.load(std::memory_order_acquire);
+		const T value = buf->get(t);
+		if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+			return false;
+		}
+		r_value = value;
+		return true;
+	}
+
+	// Approximate while other threads are stealing.
+	_FORCE_INLINE_ int64_t size() const {
+		const int64_t b = bottom.load(std::memory_order_relaxed);
+		const int64_t t = top.load(std::memory_order_relaxed);
+		return b > t ? b - t : 0;
+	}
+	_FORCE_INLINE_ bool is_empty() const { return size() == 0; }
+
+	WorkStealingDeque(const WorkStealingDeque &) = delete;
+	WorkStealingDeque &operator=(const WorkStealingDeque &) = delete;
+
+	explicit WorkStealingDeque(uint32_t p_capacity = 256) {
+		CRASH_COND_MSG(p_capacity < 2 || p_capacity > (1u << 30), "Invalid WorkStealingDeque capacity.");
+		buffer.store(_create_buffer(next_power_of_2(p_capacity)), std::memory_order_relaxed);
+	}
+
+	~WorkStealingDeque() {
+		Buffer *b = buffer.load(std::memory_order_relaxed);
+		while (b) {
+			Buffer *previous = b->previous;
+			memfree(b->items);
+			memdelete(b);
+			b = previous;
+		}
+	}
+};
+
+} // namespace godot
+
+#endif // GODOT_WORK_STEALING_DEQUE_HPP
@@ -0,0 +1,378 @@
+/**************************************************************************/
+/*  work_stealing_pool.hpp                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GODOT_WORK_STEALING_POOL_HPP
+#define GODOT_WORK_STEALING_POOL_HPP
+
+#include <godot_cpp/classes/os.hpp>
+#include <godot_cpp/core/error_macros.hpp>
+#include <godot_cpp/core/memory.hpp>
+#include <godot_cpp/templates/mpmc_queue.hpp>
+#include <godot_cpp/templates/spin_lock.hpp>
+#include <godot_cpp/templates/work_stealing_deque.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace godot {
+
+/**
+ * Thread pool with one work-stealing deque per worker.
+ *
+ * do_work() has the same signature as in ThreadWorkPool, but any number of
+ * jobs can run at once, from any thread, including from inside another job.
+ * The calling thread takes part in the work instead of just waiting for it.
+ *
+ * A job starts out as a single index range on the calling thread. Ranges are
+ * processed in chunks of p_grain elements (picked from the job and thread
+ * counts when 0), and a thread only splits off the upper half of its range
+ * when its own deque is empty, so idle threads can steal it. Busy pools thus
+ * split little, and imbalanced jobs are split further as threads run dry.
+ *
+ * Threads outside the pool share a bounded injection queue in place of a
+ * deque. Workers spin for a short while when out of work, then sleep until
+ * more is pushed.
+ */
+class WorkStealingPool {
+	static constexpr uint32_t INJECTOR_CAPACITY = 1024;
+	static constexpr uint32_t INLINE_TASKS = 16;
+	static constexpr uint32_t IDLE_SPINS = 16;
+
+	struct Job;
+
+	struct Task {
+		Job *job;
+		uint32_t begin;
+		uint32_t end;
+	};
+
+	struct Job {
+		std::atomic<uint32_t> pending; // Elements not processed yet.
+		uint32_t grain = 1;
+		std::atomic<uint32_t> task_count = { 0 };
+		uint32_t task_capacity = INLINE_TASKS;
+		Task *tasks = inline_tasks;
+		Task inline_tasks[INLINE_TASKS];
+
+		virtual void execute(uint32_t p_begin, uint32_t p_end) = 0;
+
+		// Every pushed task covers at least grain elements of its own, so
+		// elements / grain tasks are always enough.
+		void setup(uint32_t p_elements, uint32_t p_grain) {
+			pending.store(p_elements, std::memory_order_relaxed);
+			grain = p_grain;
+			const uint32_t needed = p_elements / p_grain + 1;
+			if (needed > INLINE_TASKS) {
+				task_capacity = needed;
+				tasks = (Task *)memalloc(sizeof(Task) * needed);
+			}
+		}
+
+		_FORCE_INLINE_ Task *alloc_task(uint32_t p_begin, uint32_t p_end) {
+			const uint32_t index = task_count.fetch_add(1, std::memory_order_relaxed);
+			if (unlikely(index >= task_capacity)) {
+				return nullptr;
+			}
+			Task *task = &tasks[index];
+			task->job = this;
+			task->begin = p_begin;
+			task->end = p_end;
+			return task;
+		}
+
+		virtual ~Job() {
+			if (tasks != inline_tasks) {
+				memfree(tasks);
+			}
+		}
+	};
+
+	template <class C, class M, class U>
+	struct MethodJob : public Job {
+		C *instance;
+		M method;
+		U userdata;
+
+		virtual void execute(uint32_t p_begin, uint32_t p_end) override {
+			for (uint32_t i = p_begin; i < p_end; i++) {
+				(instance->*method)(i, userdata);
+			}
+		}
+	};
+
+	struct Worker {
+		WorkStealingPool *pool = nullptr;
+		uint32_t index = 0;
+		uint32_t random_state = 0;
+		WorkStealingDeque<Task *> deque;
+		std::thread thread;
+	};
+
+	Worker *workers = nullptr;
+	uint32_t thread_count = 0;
+	// Allocated in init(), so that a pool can be a static or global before
+	// memory is set up.
+	MPMCQueue<Task *> *injector = nullptr;
+
+	std::atomic<bool> exit = { false };
+	std::mutex sleep_mutex;
+	std::condition_variable sleep_condition;
+	std::atomic<uint32_t> sleepers = { 0 };
+	std::atomic<uint32_t> wake_epoch = { 0 };
+
+	static inline thread_local Worker *current_worker = nullptr;
+
+	_FORCE_INLINE_ Worker *_get_current_worker() const {
+		Worker *worker = current_worker;
+		return (worker && worker->pool == this) ? worker : nullptr;
+	}
+
+	void _notify() {
+		// Pairs with the sleeper count and epoch checks in _thread_function():
+		// either this sees the sleeper, or the sleeper sees the new epoch.
+		wake_epoch.fetch_add(1, std::memory_order_seq_cst);
+		if (sleepers.load(std::memory_order_seq_cst) > 0) {
+			std::lock_guard<std::mutex> lock(sleep_mutex);
+			sleep_condition.notify_one();
+		}
+	}
+
+	bool _push(Worker *p_self, Task *p_task) {
+		if (p_self) {
+			p_self->deque.push(p_task);
+		} else if (!injector->push(p_task)) {
+			return false;
+		}
+		_notify();
+		return true;
+	}
+
+	bool _find_task(Worker *p_self, Task *&r_task) {
+		if (p_self && p_self->deque.pop(r_task)) {
+			return true;
+		}
+		if (injector->pop(r_task)) {
+			return true;
+		}
+		if (thread_count == 0) {
+			return false;
+		}
+		// Start at a random victim so that thieves spread out.
+		uint32_t start;
+		if (p_self) {
+			uint32_t x = p_self->random_state;
+			x ^= x << 13;
+			x ^= x >> 17;
+			x ^= x << 5;
+			p_self->random_state = x;
+			start = x % thread_count;
+		} else {
+			start = wake_epoch.load(std::memory_order_relaxed) % thread_count;
+		}
+		for (uint32_t i = 0; i < thread_count; i++) {
+			Worker &victim = workers[(start + i) % thread_count];
+			if (&victim != p_self && victim.deque.steal(r_task)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void _execute(Worker *p_self, Task *p_task) {
+		Job *job = p_task->job;
+		uint32_t begin = p_task->begin;
+		uint32_t end = p_task->end;
+		const uint32_t grain = job->grain;
+		uint32_t done = 0;
+
+		while (begin < end) {
+			if (end - begin >= grain * 2 && (p_self ? p_self->deque.is_empty() : injector->is_empty())) {
+				const uint32_t middle = begin + (end - begin) / 2;
+				Task *task = job->alloc_task(middle, end);
+				if (task && _push(p_self, task)) {
+					end = middle;
+					continue;
+				}
+			}
+			const uint32_t chunk_end = begin + MIN(grain, end - begin);
+			job->execute(begin, chunk_end);
+			done += chunk_end - begin;
+			begin = chunk_end;
+		}
+
+		// The job may be destroyed as soon as pending reaches zero, so it
+		// must not be touched after this.
+		job->pending.fetch_sub(done, std::memory_order_acq_rel);
+	}
+
+	void _wait(Worker *p_self, Job &p_job) {
+		SpinBackoff backoff;
+		while (p_job.pending.load(std::memory_order_acquire) != 0) {
+			Task *task;
+			if (_find_task(p_self, task)) {
+				_execute(p_self, task);
+				backoff = SpinBackoff();
+			} else {
+				backoff.wait();
+			}
+		}
+	}
+
+	void _run(Job &p_job, uint32_t p_elements, uint32_t p_grain) {
+		if (p_grain == 0) {
+			// Roughly eight chunks per thread: enough for stealing to even
+			// out the load, few enough to keep the per-chunk cost low.
+			p_grain = MAX(1u, p_elements / ((thread_count + 1) * 8));
+		}
+		p_job.setup(p_elements, p_grain);
+		Worker *self = _get_current_worker();
+		_execute(self, p_job.alloc_task(0, p_elements));
+		_wait(self, p_job);
+	}
+
+	static void _thread_function(Worker *p_worker) {
+		current_worker = p_worker;
+		WorkStealingPool *pool = p_worker->pool;
+
+		while (!pool->exit.load(std::memory_order_acquire)) {
+			Task *task;
+			bool found = pool->_find_task(p_worker, task);
+			SpinBackoff backoff;
+			for (uint32_t i = 0; !found && i < IDLE_SPINS; i++) {
+				backoff.wait();
+				found = pool->_find_task(p_worker, task);
+			}
+			if (found) {
+				pool->_execute(p_worker, task);
+				continue;
+			}
+
+			const uint32_t epoch = pool->wake_epoch.load(std::memory_order_seq_cst);
+			pool->sleepers.fetch_add(1, std::memory_order_seq_cst);
+			if (pool->_find_task(p_worker, task)) {
+				pool->sleepers.fetch_sub(1, std::memory_order_relaxed);
+				pool->_execute(p_worker, task);
+				continue;
+			}
+			{
+				std::unique_lock<std::mutex> lock(pool->sleep_mutex);
+				pool->sleep_condition.wait(lock, [pool, epoch]() {
+					return pool->wake_epoch.load(std::memory_order_seq_cst) != epoch || pool->exit.load(std::memory_order_acquire);
+				});
+			}
+			pool->sleepers.fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		current_worker = nullptr;
+	}
+
+public:
+	// Calls p_method on p_instance for every index below p_elements and
+	// returns once all calls are done.
+	template <class C, class M, class U>
+	void do_work(uint32_t p_elements, C *p_instance, M p_method, U p_userdata, uint32_t p_grain = 0) {
+		if (p_elements == 0) {
+			return;
+		}
+		if (p_elements == 1 || workers == nullptr) {
+			for (uint32_t i = 0; i < p_elements; i++) {
+				(p_instance->*p_method)(i, p_userdata);
+			}
+			return;
+		}
+
+		MethodJob<C, M, U> job;
+		job.instance = p_instance;
+		job.method = p_method;
+		job.userdata = p_userdata;
+		_run(job, p_elements, p_grain);
+	}
+
+	_FORCE_INLINE_ int get_thread_count() const { return thread_count; }
+
+	// Index of the calling thread in this pool, or -1 if it is not one of its
+	// workers.
+	_FORCE_INLINE_ int get_current_thread_index() const {
+		Worker *worker = _get_current_worker();
+		return worker ? int(worker->index) : -1;
+	}
+
+	void init(int p_thread_count = -1) {
+		ERR_FAIL_COND(workers != nullptr);
+		if (p_thread_count < 0) {
+			p_thread_count = OS::get_singleton()->get_processor_count();
+		}
+
+		thread_count = p_thread_count;
+		exit.store(false, std::memory_order_relaxed);
+		injector = memnew(MPMCQueue<Task *>(INJECTOR_CAPACITY));
+		workers = new Worker[thread_count];
+
+		for (uint32_t i = 0; i < thread_count; i++) {
+			workers[i].pool = this;
+			workers[i].index = i;
+			workers[i].random_state = 0x9E3779B9u * (i + 1);
+		}
+		for (uint32_t i = 0; i < thread_count; i++) {
+			workers[i].thread = std::thread(&WorkStealingPool::_thread_function, &workers[i]);
+		}
+	}
+
+	void finish() {
+		if (workers == nullptr) {
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(sleep_mutex);
+			exit.store(true, std::memory_order_release);
+			sleep_condition.notify_all();
+		}
+		for (uint32_t i = 0; i < thread_count; i++) {
+			workers[i].thread.join();
+		}
+
+		delete[] workers;
+		workers = nullptr;
+		memdelete(injector);
+		injector = nullptr;
+		thread_count = 0;
+	}
+
+	~WorkStealingPool() {
+		finish();
+	}
+};
+
+} // namespace godot
+
+#endif // GODOT_WORK_STEALING_POOL_HPP
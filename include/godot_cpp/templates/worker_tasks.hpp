@@ -0,0 +1,496 @@
+/**************************************************************************/
+/*  worker_tasks.hpp                                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GODOT_WORKER_TASKS_HPP
+#define GODOT_WORKER_TASKS_HPP
+
+#include <godot_cpp/classes/worker_thread_pool.hpp>
+#include <godot_cpp/core/error_macros.hpp>
+#include <godot_cpp/core/memory.hpp>
+#include <godot_cpp/templates/local_vector.hpp>
+#include <godot_cpp/templates/safe_refcount.hpp>
+#include <godot_cpp/templates/small_vector.hpp>
+#include <godot_cpp/templates/spin_lock.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace godot {
+
+/**
+ * Typed layer over WorkerThreadPool::add_native_task().
+ *
+ * WorkerTasks::submit() runs a callable on the engine worker threads and
+ * returns a TaskFuture for its result. Futures can be chained with then(),
+ * and a TaskGroup runs a task once all of its members are done, so task
+ * graphs can be expressed without blocking any worker on a dependency: a
+ * task is only handed to the engine once everything it depends on has
+ * finished.
+ *
+ * The engine expects every task to be waited for exactly once. A TaskFuture
+ * or TaskGroup does that when wait() is called, or when it is destroyed,
+ * so dropping one blocks until its task is done. Futures consumed by then()
+ * are waited for by the continuation instead.
+ */
+
+// Recycles the memory of task states (the captured callable and the
+// result), which would otherwise be allocated and freed for every task.
+// States too large for a block are allocated directly.
+class TaskStateAllocator {
+	static constexpr size_t BLOCK_SIZE = 256;
+	static constexpr uint32_t BLOCKS_PER_PAGE = 64;
+
+	struct FreeBlock {
+		FreeBlock *next;
+	};
+
+	// Pages are never released, the blocks are reused for the lifetime of
+	// the process.
+	static inline SpinLock lock;
+	static inline FreeBlock *free_list = nullptr;
+
+public:
+	static void *alloc(size_t p_size) {
+		if (p_size > BLOCK_SIZE) {
+			return memalloc(p_size);
+		}
+		lock.lock();
+		if (unlikely(!free_list)) {
+			uint8_t *page = (uint8_t *)memalloc(BLOCK_SIZE * BLOCKS_PER_PAGE);
+			for (uint32_t i = 0; i < BLOCKS_PER_PAGE; i++) {
+				FreeBlock *block = (FreeBlock *)(page + i * BLOCK_SIZE);
+				block->next = free_list;
+				free_list = block;
+			}
+		}
+		FreeBlock *block = free_list;
+		free_list = block->next;
+		lock.unlock();
+		return block;
+	}
+
+	static void free(void *p_memory, size_t p_size) {
+		if (p_size > BLOCK_SIZE) {
+			memfree(p_memory);
+			return;
+		}
+		FreeBlock *block = (FreeBlock *)p_memory;
+		lock.lock();
+		block->next = free_list;
+		free_list = block;
+		lock.unlock();
+	}
+};
+
+class TaskStateBase {
+	friend class WorkerTasks;
+	friend class TaskGroup;
+	template <class T>
+	friend class TaskFuture;
+
+	SafeRefCount refcount;
+	size_t alloc_size = 0;
+	bool high_priority = false;
+	WorkerThreadPool::TaskID task_id = -1;
+
+	std::atomic<bool> submitted = { false };
+	std::atomic<bool> waited = { false };
+	std::atomic<bool> done = { false };
+
+	// Unfinished dependencies, plus one until the task is fully set up.
+	std::atomic<uint32_t> blockers = { 1 };
+
+	// Guards dependents, done and dependencies_released. Most tasks have one
+	// or two dependents and dependencies, so those are kept inline.
+	SpinLock lock;
+	SmallVector<TaskStateBase *, 2> dependents;
+	// Referenced until this task has run, then waited for and released.
+	SmallVector<TaskStateBase *, 2> dependencies;
+	bool dependencies_released = false;
+
+	static void _native_task(void *p_userdata) {
+		TaskStateBase *state = static_cast<TaskStateBase *>(p_userdata);
+		state->_execute();
+		state->_release_dependencies();
+		state->_complete();
+		state->unref(); // Reference held by the engine task.
+	}
+
+	void _submit() {
+		ref();
+		task_id = WorkerThreadPool::get_singleton()->add_native_task(&TaskStateBase::_native_task, this, high_priority);
+		submitted.store(true, std::memory_order_release);
+	}
+
+	void _complete() {
+		lock.lock();
+		done.store(true, std::memory_order_release);
+		lock.unlock();
+
+		// No dependents can be added once done is set.
+		for (TaskStateBase *dependent : dependents) {
+			dependent->_release_blocker();
+			dependent->unref();
+		}
+		dependents.clear();
+	}
+
+	// Makes p_dependent wait for this task, taking over a reference to it.
+	// p_dependent is only held back if this task is not done yet.
+	void _add_dependent(TaskStateBase *p_dependent) {
+		p_dependent->dependencies.push_back(this);
+		lock.lock();
+		if (!done.load(std::memory_order_acquire)) {
+			p_dependent->ref();
+			p_dependent->blockers.fetch_add(1, std::memory_order_relaxed);
+			dependents.push_back(p_dependent);
+		}
+		lock.unlock();
+	}
+
+	// The dependencies are all done by now. Some of them may be consumed
+	// futures nobody else waits for, so the engine tasks are waited here.
+	void _release_dependencies() {
+		lock.lock();
+		dependencies_released = true;
+		lock.unlock();
+		for (TaskStateBase *dependency : dependencies) {
+			dependency->wait();
+			dependency->unref();
+		}
+		dependencies.reset();
+	}
+
+	// A referenced dependency that is not done yet, or nullptr.
+	TaskStateBase *_ref_pending_dependency() {
+		TaskStateBase *pending = nullptr;
+		lock.lock();
+		if (!dependencies_released) {
+			for (TaskStateBase *dependency : dependencies) {
+				if (!dependency->is_completed()) {
+					pending = dependency;
+					pending->ref();
+					break;
+				}
+			}
+		}
+		lock.unlock();
+		return pending;
+	}
+
+	void _release_blocker() {
+		if (blockers.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			_submit();
+		}
+	}
+
+protected:
+	virtual void _execute() = 0;
+
+public:
+	_FORCE_INLINE_ void ref() { refcount.ref(); }
+
+	void unref() {
+		if (refcount.unref()) {
+			const size_t size = alloc_size;
+			this->~TaskStateBase();
+			TaskStateAllocator::free(this, size);
+		}
+	}
+
+	_FORCE_INLINE_ bool is_completed() const { return done.load(std::memory_order_acquire); }
+
+	void wait() {
+		// Tasks with pending dependencies have not been handed to the engine
+		// yet. Waiting for those dependencies instead lets the engine run
+		// other tasks on this thread meanwhile, so waiters never hold up the
+		// workers that would finish them. Only the hand-off after the last
+		// dependency completes is spun on.
+		SpinBackoff backoff;
+		while (!submitted.load(std::memory_order_acquire)) {
+			TaskStateBase *dependency = _ref_pending_dependency();
+			if (dependency) {
+				dependency->wait();
+				dependency->unref();
+				backoff = SpinBackoff();
+			} else {
+				backoff.wait();
+			}
+		}
+		if (!waited.exchange(true, std::memory_order_acq_rel)) {
+			WorkerThreadPool::get_singleton()->wait_for_task_completion(task_id);
+		}
+		// Someone else is waiting on the engine, or the task is wrapping up.
+		backoff = SpinBackoff();
+		while (!done.load(std::memory_order_acquire)) {
+			backoff.wait();
+		}
+	}
+
+	TaskStateBase() {
+		refcount.init();
+	}
+	virtual ~TaskStateBase() {}
+};
+
+template <class T>
+class TaskState : public TaskStateBase {
+	alignas(T) uint8_t result[sizeof(T)];
+	bool has_result = false;
+
+protected:
+	template <class F>
+	_FORCE_INLINE_ void _store(F &p_function) {
+		memnew_placement(result, T(p_function()));
+		has_result = true;
+	}
+
+public:
+	_FORCE_INLINE_ T &get_result() { return *reinterpret_cast<T *>(result); }
+
+	~TaskState() {
+		if (has_result) {
+			get_result().~T();
+		}
+	}
+};
+
+template <>
+class TaskState<void> : public TaskStateBase {
+protected:
+	template <class F>
+	_FORCE_INLINE_ void _store(F &p_function) {
+		p_function();
+	}
+};
+
+template <class T, class F>
+class TaskStateImpl : public TaskState<T> {
+	F function;
+
+protected:
+	virtual void _execute() override {
+		this->_store(function);
+	}
+
+public:
+	TaskStateImpl(F &&p_function) :
+			function(std::move(p_function)) {}
+};
+
+template <class T>
+class TaskFuture {
+	friend class WorkerTasks;
+	friend class TaskGroup;
+	template <class U>
+	friend class TaskFuture;
+
+	TaskState<T> *state = nullptr;
+
+	explicit TaskFuture(TaskState<T> *p_state) :
+			state(p_state) {}
+
+public:
+	_FORCE_INLINE_ bool is_valid() const { return state != nullptr; }
+	_FORCE_INLINE_ bool is_completed() const { return state && state->is_completed(); }
+
+	void wait() {
+		ERR_FAIL_NULL(state);
+		state->wait();
+	}
+
+	// Waits for the task, then returns its result.
+	template <class U = T, typename std::enable_if<!std::is_void<U>::value, int>::type = 0>
+	U &get() {
+		CRASH_COND_MSG(!state, "Getting the result of an invalid TaskFuture.");
+		state->wait();
+		return state->get_result();
+	}
+
+	// Runs p_function with the result of this task (or with no argument, for
+	// TaskFuture<void>) once it is done. This future becomes invalid.
+	template <class F>
+	auto then(F p_function, bool p_high_priority = false);
+
+	TaskFuture() {}
+	TaskFuture(const TaskFuture &) = delete;
+	TaskFuture &operator=(const TaskFuture &) = delete;
+
+	TaskFuture(TaskFuture &&p_other) :
+			state(p_other.state) {
+		p_other.state = nullptr;
+	}
+
+	TaskFuture &operator=(TaskFuture &&p_other) {
+		if (this != &p_other) {
+			if (state) {
+				state->wait();
+				state->unref();
+			}
+			state = p_other.state;
+			p_other.state = nullptr;
+		}
+		return *this;
+	}
+
+	~TaskFuture() {
+		if (state) {
+			state->wait();
+			state->unref();
+		}
+	}
+};
+
+class WorkerTasks {
+	template <class T>
+	friend class TaskFuture;
+	friend class TaskGroup;
+
+	template <class T, class F>
+	static TaskState<T> *_create(F p_function, bool p_high_priority) {
+		typedef TaskStateImpl<T, F> Impl;
+		static_assert(alignof(Impl) <= alignof(std::max_align_t), "Task callables can't be over-aligned.");
+		void *memory = TaskStateAllocator::alloc(sizeof(Impl));
+		Impl *state = memnew_placement(memory, Impl(std::move(p_function)));
+		state->alloc_size = sizeof(Impl);
+		state->high_priority = p_high_priority;
+		return state;
+	}
+
+public:
+	// Runs p_function on the engine worker threads.
+	template <class F>
+	static auto submit(F p_function, bool p_high_priority = false) {
+		typedef decltype(p_function()) R;
+		TaskState<R> *state = _create<R>(std::move(p_function), p_high_priority);
+		state->_release_blocker();
+		return TaskFuture<R>(state);
+	}
+};
+
+template <class T>
+template <class F>
+auto TaskFuture<T>::then(F p_function, bool p_high_priority) {
+	CRASH_COND_MSG(!state, "Calling then() on an invalid TaskFuture.");
+	TaskState<T> *parent = state;
+	state = nullptr;
+
+	if constexpr (std::is_void<T>::value) {
+		typedef decltype(p_function()) R;
+		TaskState<R> *next = WorkerTasks::_create<R>(std::move(p_function), p_high_priority);
+		parent->_add_dependent(next); // Takes over the reference of this future.
+		next->_release_blocker();
+		return TaskFuture<R>(next);
+	} else {
+		typedef decltype(p_function(parent->get_result())) R;
+		auto continuation = [parent, function = std::move(p_function)]() mutable { return function(parent->get_result()); };
+		TaskState<R> *next = WorkerTasks::_create<R>(std::move(continuation), p_high_priority);
+		parent->_add_dependent(next); // Takes over the reference of this future.
+		next->_release_blocker();
+		return TaskFuture<R>(next);
+	}
+}
+
+// A set of tasks that can be waited for together, or used as the
+// dependencies of another task.
+class TaskGroup {
+	LocalVector<TaskStateBase *> tasks;
+
+public:
+	template <class F>
+	void add(F p_function, bool p_high_priority = false) {
+		typedef decltype(p_function()) R;
+		TaskState<R> *state = WorkerTasks::_create<R>(std::move(p_function), p_high_priority);
+		state->_release_blocker();
+		tasks.push_back(state);
+	}
+
+	// Takes over an existing future, which becomes invalid.
+	template <class T>
+	void add(TaskFuture<T> &&p_future) {
+		ERR_FAIL_NULL(p_future.state);
+		tasks.push_back(p_future.state);
+		p_future.state = nullptr;
+	}
+
+	// Runs p_function once every task currently in the group is done. The
+	// group keeps its tasks, and can still be waited for.
+	template <class F>
+	auto then(F p_function, bool p_high_priority = false) {
+		typedef decltype(p_function()) R;
+		TaskState<R> *next = WorkerTasks::_create<R>(std::move(p_function), p_high_priority);
+		for (TaskStateBase *task : tasks) {
+			task->ref();
+			task->_add_dependent(next);
+		}
+		next->_release_blocker();
+		return TaskFuture<R>(next);
+	}
+
+	bool is_completed() const {
+		for (const TaskStateBase *task : tasks) {
+			if (!task->is_completed()) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void wait() {
+		for (TaskStateBase *task : tasks) {
+			task->wait();
+		}
+	}
+
+	_FORCE_INLINE_ uint32_t size() const { return tasks.size(); }
+
+	// Waits for and releases every task.
+	void clear() {
+		for (TaskStateBase *task : tasks) {
+			task->wait();
+			task->unref();
+		}
+		tasks.clear();
+	}
+
+	TaskGroup() {}
+	TaskGroup(const TaskGroup &) = delete;
+	TaskGroup &operator=(const TaskGroup &) = delete;
+
+	~TaskGroup() {
+		clear();
+	}
+};
+
+} // namespace godot
+
+#endif // GODOT_WORKER_TASKS_HPP
@@ -92,9 +92,15 @@ struct _NO_DISCARD_ Quaternion {
 #ifdef MATH_CHECKS
 		ERR_FAIL_COND_V_MSG(!is_normalized(), v, "The quaternion must be normalized.");
 #endif
+#ifdef GODOT_SIMD_ENABLED
+		Vector3 ret;
+		Simd::store3(ret.coord, Simd::quaternion_xform(Simd::load4(components), Simd::load3(v.coord)));
+		return ret;
+#else
 		Vector3 u(x, y, z);
 		Vector3 uv = u.cross(v);
 		return v + ((uv * w) + u.cross(uv)) * ((real_t)2);
+#endif
 	}
 
 	_FORCE_INLINE_ Vector3 xform_inv(const Vector3 &v) const {
@@ -165,7 +171,11 @@ struct _NO_DISCARD_ Quaternion {
 };
 
 real_t Quaternion::dot(const Quaternion &p_q) const {
+#ifdef GODOT_SIMD_ENABLED
+	return Simd::dot4(Simd::load4(components), Simd::load4(p_q.components));
+#else
 	return x * p_q.x + y * p_q.y + z * p_q.z + w * p_q.w;
+#endif
 }
 
 real_t Quaternion::length_squared() const {
@@ -33,6 +33,7 @@
 
 #include <godot_cpp/core/error_macros.hpp>
 #include <godot_cpp/core/math.hpp>
+#include <godot_cpp/core/simd.hpp>
 
 namespace godot {
 
@@ -79,11 +80,23 @@ struct _NO_DISCARD_ Vector3 {
 	}
 
 	Vector3 min(const Vector3 &p_vector3) const {
+#ifdef GODOT_SIMD_ENABLED
+		Vector3 ret;
+		Simd::store3(ret.coord, Simd::min(Simd::load3(coord), Simd::load3(p_vector3.coord)));
+		return ret;
+#else
 		return Vector3(MIN(x, p_vector3.x), MIN(y, p_vector3.y), MIN(z, p_vector3.z));
+#endif
 	}
 
 	Vector3 max(const Vector3 &p_vector3) const {
+#ifdef GODOT_SIMD_ENABLED
+		Vector3 ret;
+		Simd::store3(ret.coord, Simd::max(Simd::load3(coord), Simd::load3(p_vector3.coord)));
+		return ret;
+#else
 		return Vector3(MAX(x, p_vector3.x), MAX(y, p_vector3.y), MAX(z, p_vector3.z));
+#endif
 	}
 
 	_FORCE_INLINE_ real_t length() const;
@@ -184,16 +197,25 @@ struct _NO_DISCARD_ Vector3 {
 };
 
 Vector3 Vector3::cross(const Vector3 &p_with) const {
+#ifdef GODOT_SIMD_ENABLED
+	Vector3 ret;
+	Simd::store3(ret.coord, Simd::cross3(Simd::load3(coord), Simd::load3(p_with.coord)));
+#else
 	Vector3 ret(
 			(y * p_with.z) - (z * p_with.y),
 			(z * p_with.x) - (x * p_with.z),
 			(x * p_with.y) - (y * p_with.x));
+#endif
 
 	return ret;
 }
 
 real_t Vector3::dot(const Vector3 &p_with) const {
+#ifdef GODOT_SIMD_ENABLED
+	return Simd::dot3(Simd::load3(coord), Simd::load3(p_with.coord));
+#else
 	return x * p_with.x + y * p_with.y + z * p_with.z;
+#endif
 }
 
 Vector3 Vector3::abs() const {
@@ -205,11 +227,23 @@ Vector3 Vector3::sign() const {
 }
 
 Vector3 Vector3::floor() const {
+#ifdef GODOT_SIMD_ROUNDING
+	Vector3 ret;
+	Simd::store3(ret.coord, Simd::floor(Simd::load3(coord)));
+	return ret;
+#else
 	return Vector3(Math::floor(x), Math::floor(y), Math::floor(z));
+#endif
 }
 
 Vector3 Vector3::ceil() const {
+#ifdef GODOT_SIMD_ROUNDING
+	Vector3 ret;
+	Simd::store3(ret.coord, Simd::ceil(Simd::load3(coord)));
+	return ret;
+#else
 	return Vector3(Math::ceil(x), Math::ceil(y), Math::ceil(z));
+#endif
 }
 
 Vector3 Vector3::round() const {
@@ -217,10 +251,16 @@ Vector3 Vector3::round() const {
 }
 
 Vector3 Vector3::lerp(const Vector3 &p_to, const real_t p_weight) const {
+#ifdef GODOT_SIMD_ENABLED
+	Vector3 ret;
+	Simd::store3(ret.coord, Simd::lerp(Simd::load3(coord), Simd::load3(p_to.coord), p_weight));
+	return ret;
+#else
 	return Vector3(
 			x + (p_weight * (p_to.x - x)),
 			y + (p_weight * (p_to.y - y)),
 			z + (p_weight * (p_to.z - z)));
+#endif
 }
 
 Vector3 Vector3::slerp(const Vector3 &p_to, const real_t p_weight) const {
@@ -459,22 +499,41 @@ _FORCE_INLINE_ real_t vec3_dot(const Vector3 &p_a, const Vector3 &p_b) {
 }
 
 real_t Vector3::length() const {
+#ifdef GODOT_SIMD_ENABLED
+	Simd::Float4 v = Simd::load3(coord);
+	return Math::sqrt(Simd::dot3(v, v));
+#else
 	real_t x2 = x * x;
 	real_t y2 = y * y;
 	real_t z2 = z * z;
 
 	return Math::sqrt(x2 + y2 + z2);
+#endif
 }
 
 real_t Vector3::length_squared() const {
+#ifdef GODOT_SIMD_ENABLED
+	Simd::Float4 v = Simd::load3(coord);
+	return Simd::dot3(v, v);
+#else
 	real_t x2 = x * x;
 	real_t y2 = y * y;
 	real_t z2 = z * z;
 
 	return x2 + y2 + z2;
+#endif
 }
 
 void Vector3::normalize() {
+#ifdef GODOT_SIMD_ENABLED
+	Simd::Float4 v = Simd::load3(coord);
+	real_t lengthsq = Simd::dot3(v, v);
+	if (lengthsq == 0) {
+		x = y = z = 0;
+	} else {
+		Simd::store3(coord, Simd::div(v, Simd::splat(Math::sqrt(lengthsq))));
+	}
+#else
 	real_t lengthsq = length_squared();
 	if (lengthsq == 0) {
 		x = y = z = 0;
@@ -484,6 +543,7 @@ void Vector3::normalize() {
 		y /= length;
 		z /= length;
 	}
+#endif
 }
 
 Vector3 Vector3::normalized() const {
@@ -33,6 +33,7 @@
 
 #include <godot_cpp/core/error_macros.hpp>
 #include <godot_cpp/core/math.hpp>
+#include <godot_cpp/core/simd.hpp>
 
 namespace godot {
 
@@ -71,11 +72,23 @@ struct _NO_DISCARD_ Vector4 {
 	Vector4::Axis max_axis_index() const;
 
 	Vector4 min(const Vector4 &p_vector4) const {
+#ifdef GODOT_SIMD_ENABLED
+		Vector4 ret;
+		Simd::store4(ret.components, Simd::min(Simd::load4(components), Simd::load4(p_vector4.components)));
+		return ret;
+#else
 		return Vector4(MIN(x, p_vector4.x), MIN(y, p_vector4.y), MIN(z, p_vector4.z), MIN(w, p_vector4.w));
+#endif
 	}
 
 	Vector4 max(const Vector4 &p_vector4) const {
+#ifdef GODOT_SIMD_ENABLED
+		Vector4 ret;
+		Simd::store4(ret.components, Simd::max(Simd::load4(components), Simd::load4(p_vector4.components)));
+		return ret;
+#else
 		return Vector4(MAX(x, p_vector4.x), MAX(y, p_vector4.y), MAX(z, p_vector4.z), MAX(w, p_vector4.w));
+#endif
 	}
 
 	_FORCE_INLINE_ real_t length_squared() const;
@@ -156,7 +169,11 @@ struct _NO_DISCARD_ Vector4 {
 };
 
 real_t Vector4::dot(const Vector4 &p_vec4) const {
+#ifdef GODOT_SIMD_ENABLED
+	return Simd::dot4(Simd::load4(components), Simd::load4(p_vec4.components));
+#else
 	return x * p_vec4.x + y * p_vec4.y + z * p_vec4.z + w * p_vec4.w;
+#endif
 }
 
 real_t Vector4::length_squared() const {
@@ -0,0 +1,198 @@
+/**************************************************************************/
+/*  engine_command_buffer.cpp                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include <godot_cpp/core/engine_command_buffer.hpp>
+
+#include <godot_cpp/godot.hpp>
+
+namespace godot {
+
+static std::atomic<uint64_t> command_buffer_next_serial = { 1 };
+
+// Buffer of the last EngineCommandBuffer this thread recorded into.
+static thread_local struct {
+	uint64_t serial = 0;
+	void *buffer = nullptr;
+} command_buffer_thread_cache;
+
+void *EngineCommandBuffer::Storage::alloc(size_t p_size) {
+	p_size = (p_size + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+	if (likely(position && position + p_size <= end)) {
+		void *result = position;
+		position += p_size;
+		return result;
+	}
+
+	if (p_size > CHUNK_SIZE) {
+		uint8_t *chunk = (uint8_t *)memalloc(p_size);
+		large_chunks.push_back(chunk);
+		return chunk;
+	}
+
+	// Reuse the chunks kept from earlier flushes before allocating.
+	if (position) {
+		chunk_index++;
+	}
+	if (chunk_index == chunks.size()) {
+		chunks.push_back((uint8_t *)memalloc(CHUNK_SIZE));
+	}
+	position = chunks[chunk_index] + p_size;
+	end = chunks[chunk_index] + CHUNK_SIZE;
+	return chunks[chunk_index];
+}
+
+void EngineCommandBuffer::Storage::append(Command *p_command) {
+	if (last) {
+		last->next = p_command;
+	} else {
+		first = p_command;
+	}
+	last = p_command;
+	count++;
+}
+
+void EngineCommandBuffer::Storage::release(bool p_execute) {
+	Command *command = first;
+	while (command) {
+		Command *next = command->next;
+		if (p_execute) {
+			command->execute();
+		}
+		command->~Command();
+		command = next;
+	}
+	first = nullptr;
+	last = nullptr;
+	count = 0;
+
+	// Keep the regular chunks for the next commands.
+	chunk_index = 0;
+	position = nullptr;
+	end = nullptr;
+	for (uint8_t *chunk : large_chunks) {
+		memfree(chunk);
+	}
+	large_chunks.clear();
+}
+
+EngineCommandBuffer::ThreadBuffer *EngineCommandBuffer::_get_thread_buffer() {
+	if (likely(command_buffer_thread_cache.serial == serial)) {
+		return static_cast<ThreadBuffer *>(command_buffer_thread_cache.buffer);
+	}
+
+	const std::thread::id thread = std::this_thread::get_id();
+	ThreadBuffer *buffer = nullptr;
+	threads_lock.lock();
+	for (ThreadBuffer *existing : threads) {
+		if (existing->thread == thread) {
+			buffer = existing;
+			break;
+		}
+	}
+	if (!buffer) {
+		buffer = memnew(ThreadBuffer);
+		buffer->thread = thread;
+		threads.push_back(buffer);
+	}
+	threads_lock.unlock();
+
+	command_buffer_thread_cache.serial = serial;
+	command_buffer_thread_cache.buffer = buffer;
+	return buffer;
+}
+
+GDExtensionMethodBindPtr EngineCommandBuffer::get_method_bind(const StringName &p_class, const StringName &p_method, int64_t p_hash) {
+	GDExtensionMethodBindPtr method_bind = internal::gdextension_interface_classdb_get_method_bind(p_class._native_ptr(), p_method._native_ptr(), p_hash);
+	ERR_FAIL_NULL_V_MSG(method_bind, nullptr, "Method '" + String(p_class) + "::" + String(p_method) + "' not found with hash " + String::num_int64(p_hash) + ".");
+	return method_bind;
+}
+
+uint32_t EngineCommandBuffer::flush() {
+	// Only one flush at a time, each owns the storages it swapped out.
+	flush_lock.lock();
+
+	threads_lock.lock();
+	const uint32_t thread_count = threads.size();
+	threads_lock.unlock();
+
+	uint32_t executed = 0;
+	for (uint32_t i = 0; i < thread_count; i++) {
+		threads_lock.lock();
+		ThreadBuffer *buffer = threads[i];
+		threads_lock.unlock();
+
+		buffer->lock.lock();
+		Storage &storage = buffer->storages[buffer->recording];
+		buffer->recording ^= 1;
+		buffer->lock.unlock();
+
+		// Commands recorded while running, including by the commands
+		// themselves, go to the other storage.
+		executed += storage.count;
+		storage.release(true);
+	}
+
+	flush_lock.unlock();
+	return executed;
+}
+
+void EngineCommandBuffer::clear() {
+	flush_lock.lock();
+	threads_lock.lock();
+	for (ThreadBuffer *buffer : threads) {
+		buffer->lock.lock();
+		buffer->storages[buffer->recording].release(false);
+		buffer->lock.unlock();
+	}
+	threads_lock.unlock();
+	flush_lock.unlock();
+}
+
+EngineCommandBuffer::EngineCommandBuffer() :
+		serial(command_buffer_next_serial.fetch_add(1, std::memory_order_relaxed)) {
+}
+
+EngineCommandBuffer::~EngineCommandBuffer() {
+	for (ThreadBuffer *buffer : threads) {
+		for (Storage &storage : buffer->storages) {
+			storage.release(false);
+			for (uint8_t *chunk : storage.chunks) {
+				memfree(chunk);
+			}
+		}
+		memdelete(buffer);
+	}
+	if (command_buffer_thread_cache.serial == serial) {
+		command_buffer_thread_cache.serial = 0;
+		command_buffer_thread_cache.buffer = nullptr;
+	}
+}
+
+} // namespace godot
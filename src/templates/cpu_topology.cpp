@@ -0,0 +1,264 @@
+/**************************************************************************/
+/*  cpu_topology.cpp                                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include <godot_cpp/templates/cpu_topology.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <pthread.h>
+#endif
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace godot {
+
+#ifdef __linux__
+static bool _read_sysfs_line(const char *p_path, char *r_buffer, size_t p_size) {
+	FILE *file = fopen(p_path, "r");
+	if (!file) {
+		return false;
+	}
+	bool ok = fgets(r_buffer, p_size, file) != nullptr;
+	fclose(file);
+	return ok;
+}
+
+static bool _read_sysfs_uint(const char *p_path, uint32_t &r_value) {
+	char buffer[32];
+	if (!_read_sysfs_line(p_path, buffer, sizeof(buffer))) {
+		return false;
+	}
+	r_value = (uint32_t)strtoul(buffer, nullptr, 10);
+	return true;
+}
+
+// Parses lists such as "0-3,8,10-11".
+static bool _parse_cpu_list(const char *p_text, LocalVector<uint32_t> &r_cpus) {
+	r_cpus.clear();
+	const char *c = p_text;
+	while (*c >= '0' && *c <= '9') {
+		char *end;
+		uint32_t first = (uint32_t)strtoul(c, &end, 10);
+		uint32_t last = first;
+		if (*end == '-') {
+			last = (uint32_t)strtoul(end + 1, &end, 10);
+		}
+		for (uint32_t cpu = first; cpu <= last; cpu++) {
+			r_cpus.push_back(cpu);
+		}
+		c = *end == ',' ? end + 1 : end;
+	}
+	return !r_cpus.is_empty();
+}
+#endif
+
+// Index of p_key in r_keys, appended if missing.
+static uint32_t _get_dense_index(LocalVector<uint64_t> &r_keys, uint64_t p_key) {
+	for (uint32_t i = 0; i < r_keys.size(); i++) {
+		if (r_keys[i] == p_key) {
+			return i;
+		}
+	}
+	r_keys.push_back(p_key);
+	return r_keys.size() - 1;
+}
+
+const CPUTopology &CPUTopology::get_singleton() {
+	static CPUTopology topology;
+	return topology;
+}
+
+void CPUTopology::_discover_fallback() {
+	cpus.resize(MAX(1u, std::thread::hardware_concurrency()));
+	for (uint32_t i = 0; i < cpus.size(); i++) {
+		cpus[i] = CPU();
+		cpus[i].id = i;
+		cpus[i].core = i;
+	}
+}
+
+void CPUTopology::_discover() {
+#ifdef __linux__
+	char buffer[1024];
+	LocalVector<uint32_t> online;
+	if (!_read_sysfs_line("/sys/devices/system/cpu/online", buffer, sizeof(buffer)) || !_parse_cpu_list(buffer, online)) {
+		_discover_fallback();
+	} else {
+		LocalVector<uint64_t> packages;
+		LocalVector<uint64_t> cores;
+		LocalVector<uint64_t> l3_groups;
+		LocalVector<uint32_t> shared;
+		cpus.resize(online.size());
+		for (uint32_t i = 0; i < online.size(); i++) {
+			CPU &cpu = cpus[i];
+			cpu = CPU();
+			cpu.id = online[i];
+
+			uint32_t package_id = 0;
+			uint32_t core_id = cpu.id;
+			snprintf(buffer, sizeof(buffer), "/sys/devices/system/cpu/cpu%u/topology/physical_package_id", cpu.id);
+			_read_sysfs_uint(buffer, package_id);
+			snprintf(buffer, sizeof(buffer), "/sys/devices/system/cpu/cpu%u/topology/core_id", cpu.id);
+			_read_sysfs_uint(buffer, core_id);
+			cpu.package = _get_dense_index(packages, package_id);
+			cpu.core = _get_dense_index(cores, (uint64_t(package_id) << 32) | core_id);
+
+			// CPUs sharing an L3 cache are keyed by the first of them. Without
+			// L3 information, the package is used instead.
+			uint64_t l3_key = (uint64_t(1) << 32) | package_id;
+			for (uint32_t index = 0; index < 16; index++) {
+				uint32_t level;
+				snprintf(buffer, sizeof(buffer), "/sys/devices/system/cpu/cpu%u/cache/index%u/level", cpu.id, index);
+				if (!_read_sysfs_uint(buffer, level)) {
+					break;
+				}
+				if (level != 3) {
+					continue;
+				}
+				snprintf(buffer, sizeof(buffer), "/sys/devices/system/cpu/cpu%u/cache/index%u/shared_cpu_list", cpu.id, index);
+				char list[1024];
+				if (_read_sysfs_line(buffer, list, sizeof(list)) && _parse_cpu_list(list, shared)) {
+					l3_key = shared[0];
+				}
+				break;
+			}
+			cpu.l3_group = _get_dense_index(l3_groups, l3_key);
+
+			for (uint32_t j = 0; j < i; j++) {
+				if (cpus[j].core == cpu.core) {
+					cpu.smt_index++;
+				}
+			}
+		}
+	}
+#else
+	_discover_fallback();
+#endif
+
+	core_count = 0;
+	l3_group_count = 0;
+	package_count = 0;
+	for (const CPU &cpu : cpus) {
+		core_count = MAX(core_count, cpu.core + 1);
+		l3_group_count = MAX(l3_group_count, cpu.l3_group + 1);
+		package_count = MAX(package_count, cpu.package + 1);
+	}
+
+	// Sort keys: three 16-bit fields, then the CPU index.
+	LocalVector<uint64_t> compact_keys;
+	LocalVector<uint64_t> scatter_keys;
+	for (uint32_t i = 0; i < cpus.size(); i++) {
+		const CPU &cpu = cpus[i];
+		// Rank of the core within its L3 group, so that scattering visits
+		// the first core of every group, then the second, and so on.
+		uint32_t core_rank = 0;
+		for (uint32_t j = 0; j < cpus.size(); j++) {
+			if (cpus[j].l3_group == cpu.l3_group && cpus[j].smt_index == 0 && cpus[j].core < cpu.core) {
+				core_rank++;
+			}
+		}
+		compact_keys.push_back((uint64_t(cpu.l3_group) << 48) | (uint64_t(cpu.core) << 32) | (uint64_t(cpu.smt_index) << 16) | i);
+		scatter_keys.push_back((uint64_t(cpu.smt_index) << 48) | (uint64_t(core_rank) << 32) | (uint64_t(cpu.l3_group) << 16) | i);
+	}
+	compact_keys.sort();
+	scatter_keys.sort();
+	compact_order.resize(cpus.size());
+	scatter_order.resize(cpus.size());
+	for (uint32_t i = 0; i < cpus.size(); i++) {
+		compact_order[i] = compact_keys[i] & 0xFFFF;
+		scatter_order[i] = scatter_keys[i] & 0xFFFF;
+	}
+}
+
+void CPUTopology::get_thread_cpus(Placement p_placement, uint32_t p_thread, LocalVector<uint32_t> &r_cpus) const {
+	r_cpus.clear();
+	switch (p_placement) {
+		case PLACEMENT_NONE:
+			break;
+		case PLACEMENT_COMPACT:
+			r_cpus.push_back(cpus[compact_order[p_thread % cpus.size()]].id);
+			break;
+		case PLACEMENT_SCATTER:
+			r_cpus.push_back(cpus[scatter_order[p_thread % cpus.size()]].id);
+			break;
+		case PLACEMENT_L3_GROUPS: {
+			const uint32_t group = p_thread % l3_group_count;
+			for (const CPU &cpu : cpus) {
+				if (cpu.l3_group == group) {
+					r_cpus.push_back(cpu.id);
+				}
+			}
+		} break;
+	}
+}
+
+bool CPUTopology::set_current_thread_affinity(const LocalVector<uint32_t> &p_cpus) {
+#ifdef __linux__
+	if (p_cpus.is_empty()) {
+		return false;
+	}
+	uint32_t max_cpu = 0;
+	for (uint32_t cpu : p_cpus) {
+		max_cpu = MAX(max_cpu, cpu);
+	}
+	cpu_set_t *set = CPU_ALLOC(max_cpu + 1);
+	ERR_FAIL_NULL_V(set, false);
+	const size_t size = CPU_ALLOC_SIZE(max_cpu + 1);
+	CPU_ZERO_S(size, set);
+	for (uint32_t cpu : p_cpus) {
+		CPU_SET_S(cpu, size, set);
+	}
+	const bool ok = pthread_setaffinity_np(pthread_self(), size, set) == 0;
+	CPU_FREE(set);
+	return ok;
+#else
+	return false;
+#endif
+}
+
+bool CPUTopology::set_current_thread_name(const char *p_name) {
+#if defined(__linux__)
+	char name[16];
+	strncpy(name, p_name, sizeof(name) - 1);
+	name[sizeof(name) - 1] = '\0';
+	return pthread_setname_np(pthread_self(), name) == 0;
+#elif defined(__APPLE__)
+	return pthread_setname_np(p_name) == 0;
+#else
+	return false;
+#endif
+}
+
+} // namespace godot
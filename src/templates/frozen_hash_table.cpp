@@ -0,0 +1,269 @@
+/**************************************************************************/
+/*  frozen_hash_table.cpp                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include <godot_cpp/templates/frozen_hash_table.hpp>
+
+#include <godot_cpp/classes/file_access.hpp>
+#include <godot_cpp/classes/project_settings.hpp>
+#include <godot_cpp/core/error_macros.hpp>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define FROZEN_HASH_TABLE_MMAP
+#endif
+
+namespace godot {
+
+static _FORCE_INLINE_ uint64_t _frozen_hash_table_align(uint64_t p_offset) {
+	return (p_offset + 7) & ~uint64_t(7);
+}
+
+void FrozenHashTableBuilder::add_bytes(const void *p_key, uint32_t p_key_length, const void *p_value, uint32_t p_value_length) {
+	Record record;
+	record.hash = 0;
+	record.offset = pool.size();
+	record.key_length = p_key_length;
+	record.value_length = p_value_length;
+
+	pool.resize(pool.size() + p_key_length + p_value_length);
+	if (p_key_length) {
+		memcpy(pool.ptr() + record.offset, p_key, p_key_length);
+	}
+	if (p_value_length) {
+		memcpy(pool.ptr() + record.offset + p_key_length, p_value, p_value_length);
+	}
+	records.push_back(record);
+}
+
+void FrozenHashTableBuilder::clear() {
+	pool.reset();
+	records.reset();
+}
+
+PackedByteArray FrozenHashTableBuilder::build() const {
+	ERR_FAIL_COND_V_MSG(records.size() > (1u << 30), PackedByteArray(), "Too many entries for a frozen hash table.");
+
+	// Keep the load factor between 1/3 and 2/3, so probe sequences stay short
+	// and there is always an empty slot to stop at.
+	const uint32_t slot_count = next_power_of_2(records.size() + records.size() / 2 + 1);
+	const uint32_t slot_mask = slot_count - 1;
+
+	LocalVector<uint64_t> hashes;
+	hashes.resize(records.size());
+	LocalVector<uint32_t> slot_records;
+	slot_records.resize(slot_count);
+	for (uint32_t i = 0; i < slot_count; i++) {
+		slot_records[i] = UINT32_MAX;
+	}
+
+	uint32_t entry_count = 0;
+	for (uint32_t i = 0; i < records.size(); i++) {
+		const Record &record = records[i];
+		const uint8_t *key = pool.ptr() + record.offset;
+		hashes[i] = hash_wyhash_buffer(key, record.key_length, seed);
+
+		uint32_t pos = uint32_t(hashes[i]) & slot_mask;
+		while (true) {
+			const uint32_t other = slot_records[pos];
+			if (other == UINT32_MAX) {
+				slot_records[pos] = i;
+				entry_count++;
+				break;
+			}
+			if (hashes[other] == hashes[i] && records[other].key_length == record.key_length && memcmp(pool.ptr() + records[other].offset, key, record.key_length) == 0) {
+				slot_records[pos] = i;
+				break;
+			}
+			pos = (pos + 1) & slot_mask;
+		}
+	}
+
+	// Key and value bytes follow the slots in slot order, so a hit usually
+	// reads data close to the ones probed before it.
+	const uint64_t data_offset = sizeof(FrozenHashTableHeader) + uint64_t(slot_count) * sizeof(FrozenHashTableSlot);
+	uint64_t total_size = data_offset;
+	for (uint32_t i = 0; i < slot_count; i++) {
+		if (slot_records[i] != UINT32_MAX) {
+			const Record &record = records[slot_records[i]];
+			total_size = _frozen_hash_table_align(total_size + record.key_length) + record.value_length;
+			total_size = _frozen_hash_table_align(total_size);
+		}
+	}
+
+	PackedByteArray blob;
+	ERR_FAIL_COND_V_MSG(blob.resize(total_size) != OK, PackedByteArray(), "Not enough memory to build a frozen hash table.");
+	uint8_t *w = blob.ptrw();
+	memset(w, 0, total_size);
+
+	FrozenHashTableHeader header;
+	header.magic = FROZEN_HASH_TABLE_MAGIC;
+	header.version = FROZEN_HASH_TABLE_VERSION;
+	header.byte_order = FROZEN_HASH_TABLE_BYTE_ORDER;
+	header.entry_count = entry_count;
+	header.slot_count = slot_count;
+	header.seed = seed;
+	header.data_offset = data_offset;
+	header.total_size = total_size;
+	memcpy(w, &header, sizeof(header));
+
+	FrozenHashTableSlot *slots = (FrozenHashTableSlot *)(w + sizeof(FrozenHashTableHeader));
+	uint64_t offset = data_offset;
+	for (uint32_t i = 0; i < slot_count; i++) {
+		if (slot_records[i] == UINT32_MAX) {
+			continue;
+		}
+		const Record &record = records[slot_records[i]];
+		FrozenHashTableSlot &slot = slots[i];
+		slot.key_offset = offset;
+		slot.hash = uint32_t(hashes[slot_records[i]] >> 32);
+		slot.key_length = record.key_length;
+		slot.value_length = record.value_length;
+
+		memcpy(w + offset, pool.ptr() + record.offset, record.key_length);
+		const uint64_t value_offset = slot.get_value_offset();
+		memcpy(w + value_offset, pool.ptr() + record.offset + record.key_length, record.value_length);
+		offset = _frozen_hash_table_align(value_offset + record.value_length);
+	}
+
+	return blob;
+}
+
+Error FrozenHashTableBuilder::save(const String &p_path) const {
+	PackedByteArray blob = build();
+	ERR_FAIL_COND_V(blob.is_empty(), ERR_OUT_OF_MEMORY);
+
+	Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::WRITE);
+	ERR_FAIL_COND_V_MSG(file.is_null(), ERR_FILE_CANT_OPEN, "Cannot open file '" + p_path + "' for writing.");
+	file->store_buffer(blob);
+	return file->get_error();
+}
+
+Error FrozenHashTable::open(const uint8_t *p_data, uint64_t p_size) {
+	close();
+
+	ERR_FAIL_COND_V(p_data == nullptr, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V_MSG(p_size < sizeof(FrozenHashTableHeader), ERR_FILE_CORRUPT, "Frozen hash table is truncated.");
+	ERR_FAIL_COND_V_MSG(((uintptr_t)p_data & 7) != 0, ERR_INVALID_PARAMETER, "Frozen hash table data must be 8-byte aligned.");
+
+	const FrozenHashTableHeader *h = (const FrozenHashTableHeader *)p_data;
+	ERR_FAIL_COND_V_MSG(h->magic != FROZEN_HASH_TABLE_MAGIC, ERR_FILE_UNRECOGNIZED, "Not a frozen hash table.");
+	ERR_FAIL_COND_V_MSG(h->byte_order != FROZEN_HASH_TABLE_BYTE_ORDER, ERR_FILE_UNRECOGNIZED, "Frozen hash table was built with a different byte order.");
+	ERR_FAIL_COND_V_MSG(h->version != FROZEN_HASH_TABLE_VERSION, ERR_FILE_UNRECOGNIZED, vformat("Unsupported frozen hash table version %d.", h->version));
+	ERR_FAIL_COND_V_MSG(h->total_size != p_size, ERR_FILE_CORRUPT, "Frozen hash table size does not match its header.");
+	ERR_FAIL_COND_V_MSG(h->slot_count == 0 || (h->slot_count & (h->slot_count - 1)) != 0 || h->entry_count >= h->slot_count, ERR_FILE_CORRUPT, "Frozen hash table has an invalid slot count.");
+	ERR_FAIL_COND_V_MSG(h->data_offset != sizeof(FrozenHashTableHeader) + uint64_t(h->slot_count) * sizeof(FrozenHashTableSlot) || h->data_offset > p_size, ERR_FILE_CORRUPT, "Frozen hash table slots are out of bounds.");
+
+	data = p_data;
+	data_size = p_size;
+	header = h;
+	slots = (const FrozenHashTableSlot *)(p_data + sizeof(FrozenHashTableHeader));
+	slot_mask = h->slot_count - 1;
+	return OK;
+}
+
+void FrozenHashTable::close() {
+	data = nullptr;
+	data_size = 0;
+	header = nullptr;
+	slots = nullptr;
+	slot_mask = 0;
+}
+
+Error FrozenHashTableFile::_map(const String &p_path) {
+#ifdef FROZEN_HASH_TABLE_MMAP
+	const String path = ProjectSettings::get_singleton()->globalize_path(p_path);
+	if (path.is_empty() || path.begins_with("res://") || path.begins_with("user://")) {
+		return ERR_FILE_CANT_OPEN;
+	}
+
+	int fd = ::open(path.utf8().get_data(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		return ERR_FILE_CANT_OPEN;
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+		::close(fd);
+		return ERR_FILE_CANT_OPEN;
+	}
+	void *ptr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// The mapping keeps its own reference to the file.
+	::close(fd);
+	if (ptr == MAP_FAILED) {
+		return ERR_FILE_CANT_OPEN;
+	}
+	// Hash lookups jump around the file, read-ahead would only waste I/O.
+	madvise(ptr, st.st_size, MADV_RANDOM);
+
+	mapping = ptr;
+	mapping_size = st.st_size;
+	return OK;
+#else
+	return ERR_UNAVAILABLE;
+#endif
+}
+
+Error FrozenHashTableFile::open(const String &p_path) {
+	close();
+
+	const uint8_t *ptr;
+	uint64_t size;
+	if (_map(p_path) == OK) {
+		ptr = (const uint8_t *)mapping;
+		size = mapping_size;
+	} else {
+		buffer = FileAccess::get_file_as_bytes(p_path);
+		ERR_FAIL_COND_V_MSG(buffer.is_empty(), ERR_FILE_CANT_OPEN, "Cannot open frozen hash table '" + p_path + "'.");
+		ptr = buffer.ptr();
+		size = buffer.size();
+	}
+
+	Error err = table.open(ptr, size);
+	if (err != OK) {
+		close();
+	}
+	return err;
+}
+
+void FrozenHashTableFile::close() {
+	table.close();
+#ifdef FROZEN_HASH_TABLE_MMAP
+	if (mapping) {
+		munmap(mapping, mapping_size);
+	}
+#endif
+	mapping = nullptr;
+	mapping_size = 0;
+	buffer = PackedByteArray();
+}
+
+} // namespace godot
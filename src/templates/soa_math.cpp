@@ -0,0 +1,639 @@
+/**************************************************************************/
+/*  soa_math.cpp                                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include <godot_cpp/templates/soa_math.hpp>
+
+#include <godot_cpp/core/simd.hpp>
+
+namespace godot {
+
+namespace {
+
+// The kernels are written once against these, and run on four elements at
+// a time with SIMD, then on the remaining ones with plain scalar code. The
+// operations round the same way in both, as in the AoS methods.
+struct ScalarLanes {
+	typedef real_t Lane;
+	enum {
+		WIDTH = 1,
+	};
+
+	static _FORCE_INLINE_ Lane load(const real_t *p_src) { return *p_src; }
+	static _FORCE_INLINE_ void store(real_t *p_dst, Lane p_v) { *p_dst = p_v; }
+	static _FORCE_INLINE_ Lane splat(real_t p_value) { return p_value; }
+	static _FORCE_INLINE_ Lane add(Lane p_a, Lane p_b) { return p_a + p_b; }
+	static _FORCE_INLINE_ Lane sub(Lane p_a, Lane p_b) { return p_a - p_b; }
+	static _FORCE_INLINE_ Lane mul(Lane p_a, Lane p_b) { return p_a * p_b; }
+	static _FORCE_INLINE_ Lane div(Lane p_a, Lane p_b) { return p_a / p_b; }
+	static _FORCE_INLINE_ Lane sqrt(Lane p_v) { return Math::sqrt(p_v); }
+	static _FORCE_INLINE_ Lane clear_where_zero(Lane p_v, Lane p_test) { return p_test == 0 ? 0 : p_v; }
+};
+
+#ifdef GODOT_SIMD_ENABLED
+struct SimdLanes {
+	typedef Simd::Float4 Lane;
+	enum {
+		WIDTH = 4,
+	};
+
+	static _FORCE_INLINE_ Lane load(const real_t *p_src) { return Simd::load4(p_src); }
+	static _FORCE_INLINE_ void store(real_t *p_dst, Lane p_v) { Simd::store4(p_dst, p_v); }
+	static _FORCE_INLINE_ Lane splat(real_t p_value) { return Simd::splat(p_value); }
+	static _FORCE_INLINE_ Lane add(Lane p_a, Lane p_b) { return Simd::add(p_a, p_b); }
+	static _FORCE_INLINE_ Lane sub(Lane p_a, Lane p_b) { return Simd::sub(p_a, p_b); }
+	static _FORCE_INLINE_ Lane mul(Lane p_a, Lane p_b) { return Simd::mul(p_a, p_b); }
+	static _FORCE_INLINE_ Lane div(Lane p_a, Lane p_b) { return Simd::div(p_a, p_b); }
+	static _FORCE_INLINE_ Lane sqrt(Lane p_v) { return Simd::sqrt(p_v); }
+	static _FORCE_INLINE_ Lane clear_where_zero(Lane p_v, Lane p_test) { return Simd::clear_where_zero(p_v, p_test); }
+};
+#endif
+
+// Calls p_kernel(lanes, index) for every group of elements in [0, p_count).
+template <class F>
+_FORCE_INLINE_ void _for_each_lane(uint32_t p_count, F p_kernel) {
+	uint32_t i = 0;
+#ifdef GODOT_SIMD_ENABLED
+	for (; i + SimdLanes::WIDTH <= p_count; i += SimdLanes::WIDTH) {
+		p_kernel(SimdLanes(), i);
+	}
+#endif
+	for (; i < p_count; i++) {
+		p_kernel(ScalarLanes(), i);
+	}
+}
+
+// Same operations as Quaternion::xform().
+template <class L>
+_FORCE_INLINE_ void _rotate(typename L::Lane p_qx, typename L::Lane p_qy, typename L::Lane p_qz, typename L::Lane p_qw, real_t *r_x, real_t *r_y, real_t *r_z) {
+	typedef typename L::Lane Lane;
+	Lane vx = L::load(r_x);
+	Lane vy = L::load(r_y);
+	Lane vz = L::load(r_z);
+	Lane uvx = L::sub(L::mul(p_qy, vz), L::mul(p_qz, vy));
+	Lane uvy = L::sub(L::mul(p_qz, vx), L::mul(p_qx, vz));
+	Lane uvz = L::sub(L::mul(p_qx, vy), L::mul(p_qy, vx));
+	Lane tx = L::add(L::mul(uvx, p_qw), L::sub(L::mul(p_qy, uvz), L::mul(p_qz, uvy)));
+	Lane ty = L::add(L::mul(uvy, p_qw), L::sub(L::mul(p_qz, uvx), L::mul(p_qx, uvz)));
+	Lane tz = L::add(L::mul(uvz, p_qw), L::sub(L::mul(p_qx, uvy), L::mul(p_qy, uvx)));
+	Lane two = L::splat(2.0f);
+	L::store(r_x, L::add(vx, L::mul(tx, two)));
+	L::store(r_y, L::add(vy, L::mul(ty, two)));
+	L::store(r_z, L::add(vz, L::mul(tz, two)));
+}
+
+// Same operations as Quaternion::operator*=().
+template <class L>
+_FORCE_INLINE_ void _multiply(typename L::Lane p_qx, typename L::Lane p_qy, typename L::Lane p_qz, typename L::Lane p_qw, real_t *r_x, real_t *r_y, real_t *r_z, real_t *r_w) {
+	typedef typename L::Lane Lane;
+	Lane x = L::load(r_x);
+	Lane y = L::load(r_y);
+	Lane z = L::load(r_z);
+	Lane w = L::load(r_w);
+	L::store(r_x, L::sub(L::add(L::add(L::mul(w, p_qx), L::mul(x, p_qw)), L::mul(y, p_qz)), L::mul(z, p_qy)));
+	L::store(r_y, L::sub(L::add(L::add(L::mul(w, p_qy), L::mul(y, p_qw)), L::mul(z, p_qx)), L::mul(x, p_qz)));
+	L::store(r_z, L::sub(L::add(L::add(L::mul(w, p_qz), L::mul(z, p_qw)), L::mul(x, p_qy)), L::mul(y, p_qx)));
+	L::store(r_w, L::sub(L::sub(L::sub(L::mul(w, p_qw), L::mul(x, p_qx)), L::mul(y, p_qy)), L::mul(z, p_qz)));
+}
+
+// The twelve arrays of a TransformSoA, fetched once per batch operation.
+template <class T>
+struct TransformArrays {
+	T *b[3][3];
+	T *o[3];
+
+	template <class S>
+	TransformArrays(S &p_transforms) {
+		for (int i = 0; i < 3; i++) {
+			b[i][0] = p_transforms.basis[i].x.ptr();
+			b[i][1] = p_transforms.basis[i].y.ptr();
+			b[i][2] = p_transforms.basis[i].z.ptr();
+		}
+		o[0] = p_transforms.origin.x.ptr();
+		o[1] = p_transforms.origin.y.ptr();
+		o[2] = p_transforms.origin.z.ptr();
+	}
+};
+
+// A 3x4 matrix in registers, rows of the basis then the origin.
+template <class L>
+struct TransformLanes {
+	typename L::Lane b[3][3];
+	typename L::Lane o[3];
+
+	template <class T>
+	_FORCE_INLINE_ void load(const TransformArrays<T> &p_arrays, uint32_t p_index) {
+		for (int i = 0; i < 3; i++) {
+			for (int j = 0; j < 3; j++) {
+				b[i][j] = L::load(p_arrays.b[i][j] + p_index);
+			}
+			o[i] = L::load(p_arrays.o[i] + p_index);
+		}
+	}
+
+	_FORCE_INLINE_ void splat(const Transform3D &p_transform) {
+		for (int i = 0; i < 3; i++) {
+			for (int j = 0; j < 3; j++) {
+				b[i][j] = L::splat(p_transform.basis.rows[i][j]);
+			}
+			o[i] = L::splat(p_transform.origin[i]);
+		}
+	}
+
+	_FORCE_INLINE_ void store(const TransformArrays<real_t> &p_arrays, uint32_t p_index) const {
+		for (int i = 0; i < 3; i++) {
+			for (int j = 0; j < 3; j++) {
+				L::store(p_arrays.b[i][j] + p_index, b[i][j]);
+			}
+			L::store(p_arrays.o[i] + p_index, o[i]);
+		}
+	}
+
+	// Transform3D::xform(), row i of the basis dotted with the vector, plus the origin.
+	_FORCE_INLINE_ typename L::Lane xform(int p_row, typename L::Lane p_x, typename L::Lane p_y, typename L::Lane p_z) const {
+		return L::add(L::add(L::add(L::mul(b[p_row][0], p_x), L::mul(b[p_row][1], p_y)), L::mul(b[p_row][2], p_z)), o[p_row]);
+	}
+
+	// Transform3D::operator*=(), this becomes this * p_other.
+	_FORCE_INLINE_ void compose(const TransformLanes &p_other) {
+		typename L::Lane ox = xform(0, p_other.o[0], p_other.o[1], p_other.o[2]);
+		typename L::Lane oy = xform(1, p_other.o[0], p_other.o[1], p_other.o[2]);
+		typename L::Lane oz = xform(2, p_other.o[0], p_other.o[1], p_other.o[2]);
+		o[0] = ox;
+		o[1] = oy;
+		o[2] = oz;
+		for (int i = 0; i < 3; i++) {
+			typename L::Lane row[3];
+			for (int j = 0; j < 3; j++) {
+				row[j] = L::add(L::add(L::mul(p_other.b[0][j], b[i][0]), L::mul(p_other.b[1][j], b[i][1])), L::mul(p_other.b[2][j], b[i][2]));
+			}
+			b[i][0] = row[0];
+			b[i][1] = row[1];
+			b[i][2] = row[2];
+		}
+	}
+};
+
+} // namespace
+
+void Vector3SoA::resize(uint32_t p_size) {
+	const uint32_t old_size = size();
+	x.resize(p_size);
+	y.resize(p_size);
+	z.resize(p_size);
+	for (uint32_t i = old_size; i < p_size; i++) {
+		x[i] = 0;
+		y[i] = 0;
+		z[i] = 0;
+	}
+}
+
+void Vector3SoA::clear() {
+	x.clear();
+	y.clear();
+	z.clear();
+}
+
+void Vector3SoA::push_back(const Vector3 &p_value) {
+	x.push_back(p_value.x);
+	y.push_back(p_value.y);
+	z.push_back(p_value.z);
+}
+
+void Vector3SoA::add(const Vector3SoA &p_other) {
+	ERR_FAIL_COND(p_other.size() != size());
+	real_t *rx = x.ptr();
+	real_t *ry = y.ptr();
+	real_t *rz = z.ptr();
+	const real_t *ox = p_other.x.ptr();
+	const real_t *oy = p_other.y.ptr();
+	const real_t *oz = p_other.z.ptr();
+	_for_each_lane(size(), [&](auto p_lanes, uint32_t i) {
+		typedef decltype(p_lanes) L;
+		L::store(rx + i, L::add(L::load(rx + i), L::load(ox + i)));
+		L::store(ry + i, L::add(L::load(ry + i), L::load(oy + i)));
+		L::store(rz + i, L::add(L::load(rz + i), L::load(oz + i)));
+	});
+}
+
+void Vector3SoA::add(const Vector3 &p_offset) {
+	real_t *rx = x.ptr();
+	real_t *ry = y.ptr();
+	real_t *rz = z.ptr();
+	_for_each_lane(size(), [&](auto p_lanes, uint32_t i) {
+		typedef decltype(p_lanes) L;
+		L::store(rx + i, L::add(L::load(rx + i), L::splat(p_offset.x)));
+		L::store(ry + i, L::add(L::load(ry + i), L::splat(p_offset.y)));
+		L::store(rz + i, L::add(L::load(rz + i), L::splat(p_offset.z)));
+	});
+}
+
+void Vector3SoA::add_scaled(const Vector3SoA &p_other, real_t p_scale) {
+	ERR_FAIL_COND(p_other.size() != size());
+	real_t *rx = x.ptr();
+	real_t *ry = y.ptr();
+	real_t *rz = z.ptr();
+	const real_t *ox = p_other.x.ptr();
+	const real_t *oy = p_other.y.ptr();
+	const real_t *oz = p_other.z.ptr();
+	_for_each_lane(size(), [&](auto p_lanes, uint32_t i) {
+		typedef decltype(p_lanes) L;
+		const typename L::Lane s = L::splat(p_scale);
+		L::store(rx + i, L::add(L::load(rx + i), L::mul(L::load(ox + i), s)));
+		L::store(ry + i, L::add(L::load(ry + i), L::mul(L::load(oy + i), s)));
+		L::store(rz + i, L::add(L::load(rz + i), L::mul(L::load(oz + i), s)));
+	});
+}
+
+void Vector3SoA::scale(real_t p_scale) {
+	real_t *rx = x.ptr();
+	real_t *ry = y.ptr();
+	real_t *rz = z.ptr();
+	_for_each_lane(size(), [&](auto p_lanes, uint32_t i) {
+		typedef decltype(p_lanes) L;
+		const typename L::Lane s = L::splat(p_scale);
+		L::store(rx + i, L::mul(L::load(rx + i), s));
+		L::store(ry + i, L::mul(L::load(ry + i), s));
+		L::store(rz + i, L::mul(L::load(rz + i), s));
+	});
+}
+
+void Vector3SoA::normalize() {
+	real_t *rx = x.ptr();
+	real_t *ry = y.ptr();
+	real_t *rz = z.ptr();
+	_for_each_lane(size(), [&](auto p_lanes, uint32_t i) {
+		typedef decltype(p_lanes) L;
+		typename L::Lane vx = L::load(rx + i);
+		typename L::Lane vy = L::load(ry + i);
+		typename L::Lane vz = L::load(rz + i);
+		typename L::Lane lengthsq = L::add(L::add(L::mul(vx, vx), L::mul(vy, vy)), L::mul(vz, vz));
+		typename L::Lane length = L::sqrt(lengthsq);
+		L::store(rx + i, L::clear_where_zero(L::div(vx, length), lengthsq));
+		L::store(ry + i, L::clear_where_zero(L::div(vy, length), lengthsq));
+		L::store(rz + i, L::clear_where_zero(L::div(vz, length), lengthsq));
+	});
+}
+
+void Vector3SoA::rotate(const Quaternion &p_rotation) {
+	real_t *rx = x.ptr();
+	real_t *ry = y.ptr();
+	real_t *rz = z.ptr();
+	_for_each_lane(size(), [&](auto p_lanes, uint32_t i) {
+		typedef decltype(p_lanes) L;
+		_rotate<L>(L::splat(p_rotation.x), L::splat(p_rotation.y), L::splat(p_rotation.z), L::splat(p_rotation.w), rx + i, ry + i, rz + i);
+	});
+}
+
+void Vector3SoA::rotate(const QuaternionSoA &p_rotations) {
+	ERR_FAIL_COND(p_rotations.size() != size());
+	real_t *rx = x.ptr();
+	real_t *ry = y.ptr();
+	real_t *rz = z.ptr();
+	const real_t *qx = p_rotations.x.ptr();
+	const real_t *qy = p_rotations.y.ptr();
+	const real_t *qz = p_rotations.z.ptr();
+	const real_t *qw = p_rotations.w.ptr();
+	_for_each_lane(size(), [&](auto p_lanes, uint32_t i) {
+		typedef decltype(p_lanes) L;
+		_rotate<L>(L::load(qx + i), L::load(qy + i), L::load(qz + i), L::load(qw + i), rx + i, ry + i, rz + i);
+	});
+}
+
+void Vector3SoA::from_packed_array(const PackedVector3Array &p_array) {
+	resize(p_array.size());
+	const Vector3 *src = p_array.ptr();
+	real_t *rx = x.ptr();
+	real_t *ry = y.ptr();
+	real_t *rz = z.ptr();
+	for (uint32_t i = 0; i < size(); i++) {
+		rx[i] = src[i].x;
+		ry[i] = src[i].y;
+		rz[i] = src[i].z;
+	}
+}
+
+PackedVector3Array Vector3SoA::to_packed_array() const {
+	PackedVector3Array array;
+	array.resize(size());
+	Vector3 *dst = array.ptrw();
+	for (uint32_t i = 0; i < size(); i++) {
+		dst[i] = Vector3(x[i], y[i], z[i]);
+	}
+	return array;
+}
+
+void Vector3SoA::from_float32_array(const PackedFloat32Array &p_array) {
+	ERR_FAIL_COND_MSG(p_array.size() % 3 != 0, "The array size must be a multiple of 3.");
+	resize(p_array.size() / 3);
+	const float *src = p_array.ptr();
+	for (uint32_t i = 0; i < size(); i++) {
+		x[i] = src[i * 3 + 0];
+		y[i] = src[i * 3 + 1];
+		z[i] = src[i * 3 + 2];
+	}
+}
+
+PackedFloat32Array Vector3SoA::to_float32_array() const {
+	PackedFloat32Array array;
+	array.resize(size() * 3);
+	float *dst = array.ptrw();
+	for (uint32_t i = 0; i < size(); i++) {
+		dst[i * 3 + 0] = x[i];
+		dst[i * 3 + 1] = y[i];
+		dst[i * 3 + 2] = z[i];
+	}
+	return array;
+}
+
+void QuaternionSoA::resize(uint32_t p_size) {
+	const uint32_t old_size = size();
+	x.resize(p_size);
+	y.resize(p_size);
+	z.resize(p_size);
+	w.resize(p_size);
+	for (uint32_t i = old_size; i < p_size; i++) {
+		x[i] = 0;
+		y[i] = 0;
+		z[i] = 0;
+		w[i] = 1;
+	}
+}
+
+void QuaternionSoA::clear() {
+	x.clear();
+	y.clear();
+	z.clear();
+	w.clear();
+}
+
+void QuaternionSoA::push_back(const Quaternion &p_value) {
+	x.push_back(p_value.x);
+	y.push_back(p_value.y);
+	z.push_back(p_value.z);
+	w.push_back(p_value.w);
+}
+
+void QuaternionSoA::normalize() {
+	real_t *rx = x.ptr();
+	real_t *ry = y.ptr();
+	real_t *rz = z.ptr();
+	real_t *rw = w.ptr();
+	_for_each_lane(size(), [&](auto p_lanes, uint32_t i) {
+		typedef decltype(p_lanes) L;
+		typename L::Lane qx = L::load(rx + i);
+		typename L::Lane qy = L::load(ry + i);
+		typename L::Lane qz = L::load(rz + i);
+		typename L::Lane qw = L::load(rw + i);
+		typename L::Lane lengthsq = L::add(L::add(L::add(L::mul(qx, qx), L::mul(qy, qy)), L::mul(qz, qz)), L::mul(qw, qw));
+		// Quaternion::operator/=() multiplies by the inverse.
+		typename L::Lane s = L::div(L::splat(1.0f), L::sqrt(lengthsq));
+		L::store(rx + i, L::mul(qx, s));
+		L::store(ry + i, L::mul(qy, s));
+		L::store(rz + i, L::mul(qz, s));
+		L::store(rw + i, L::mul(qw, s));
+	});
+}
+
+void QuaternionSoA::multiply(const QuaternionSoA &p_other) {
+	ERR_FAIL_COND(p_other.size() != size());
+	real_t *rx = x.ptr();
+	real_t *ry = y.ptr();
+	real_t *rz = z.ptr();
+	real_t *rw = w.ptr();
+	const real_t *qx = p_other.x.ptr();
+	const real_t *qy = p_other.y.ptr();
+	const real_t *qz = p_other.z.ptr();
+	const real_t *qw = p_other.w.ptr();
+	_for_each_lane(size(), [&](auto p_lanes, uint32_t i) {
+		typedef decltype(p_lanes) L;
+		_multiply<L>(L::load(qx + i), L::load(qy + i), L::load(qz + i), L::load(qw + i), rx + i, ry + i, rz + i, rw + i);
+	});
+}
+
+void QuaternionSoA::multiply(const Quaternion &p_rotation) {
+	real_t *rx = x.ptr();
+	real_t *ry = y.ptr();
+	real_t *rz = z.ptr();
+	real_t *rw = w.ptr();
+	_for_each_lane(size(), [&](auto p_lanes, uint32_t i) {
+		typedef decltype(p_lanes) L;
+		_multiply<L>(L::splat(p_rotation.x), L::splat(p_rotation.y), L::splat(p_rotation.z), L::splat(p_rotation.w), rx + i, ry + i, rz + i, rw + i);
+	});
+}
+
+void QuaternionSoA::from_float32_array(const PackedFloat32Array &p_array) {
+	ERR_FAIL_COND_MSG(p_array.size() % 4 != 0, "The array size must be a multiple of 4.");
+	resize(p_array.size() / 4);
+	const float *src = p_array.ptr();
+	for (uint32_t i = 0; i < size(); i++) {
+		x[i] = src[i * 4 + 0];
+		y[i] = src[i * 4 + 1];
+		z[i] = src[i * 4 + 2];
+		w[i] = src[i * 4 + 3];
+	}
+}
+
+PackedFloat32Array QuaternionSoA::to_float32_array() const {
+	PackedFloat32Array array;
+	array.resize(size() * 4);
+	float *dst = array.ptrw();
+	for (uint32_t i = 0; i < size(); i++) {
+		dst[i * 4 + 0] = x[i];
+		dst[i * 4 + 1] = y[i];
+		dst[i * 4 + 2] = z[i];
+		dst[i * 4 + 3] = w[i];
+	}
+	return array;
+}
+
+void TransformSoA::resize(uint32_t p_size) {
+	const uint32_t old_size = size();
+	for (int i = 0; i < 3; i++) {
+		basis[i].resize(p_size);
+	}
+	origin.resize(p_size);
+	for (uint32_t i = old_size; i < p_size; i++) {
+		basis[0].x[i] = 1;
+		basis[1].y[i] = 1;
+		basis[2].z[i] = 1;
+	}
+}
+
+void TransformSoA::clear() {
+	for (int i = 0; i < 3; i++) {
+		basis[i].clear();
+	}
+	origin.clear();
+}
+
+Transform3D TransformSoA::get(uint32_t p_index) const {
+	return Transform3D(
+			basis[0].x[p_index], basis[0].y[p_index], basis[0].z[p_index],
+			basis[1].x[p_index], basis[1].y[p_index], basis[1].z[p_index],
+			basis[2].x[p_index], basis[2].y[p_index], basis[2].z[p_index],
+			origin.x[p_index], origin.y[p_index], origin.z[p_index]);
+}
+
+void TransformSoA::set(uint32_t p_index, const Transform3D &p_value) {
+	for (int i = 0; i < 3; i++) {
+		basis[i].set(p_index, p_value.basis.rows[i]);
+	}
+	origin.set(p_index, p_value.origin);
+}
+
+void TransformSoA::push_back(const Transform3D &p_value) {
+	for (int i = 0; i < 3; i++) {
+		basis[i].push_back(p_value.basis.rows[i]);
+	}
+	origin.push_back(p_value.origin);
+}
+
+void TransformSoA::set_rotations_and_origins(const QuaternionSoA &p_rotations, const Vector3SoA &p_origins) {
+	ERR_FAIL_COND(p_origins.size() != p_rotations.size());
+	resize(p_rotations.size());
+	if (&p_origins != &origin) {
+		origin.x = p_origins.x;
+		origin.y = p_origins.y;
+		origin.z = p_origins.z;
+	}
+	const real_t *qx = p_rotations.x.ptr();
+	const real_t *qy = p_rotations.y.ptr();
+	const real_t *qz = p_rotations.z.ptr();
+	const real_t *qw = p_rotations.w.ptr();
+	_for_each_lane(size(), [&](auto p_lanes, uint32_t i) {
+		typedef decltype(p_lanes) L;
+		typedef typename L::Lane Lane;
+		// Same operations as Basis::set_quaternion().
+		Lane x = L::load(qx + i);
+		Lane y = L::load(qy + i);
+		Lane z = L::load(qz + i);
+		Lane w = L::load(qw + i);
+		Lane d = L::add(L::add(L::add(L::mul(x, x), L::mul(y, y)), L::mul(z, z)), L::mul(w, w));
+		Lane s = L::div(L::splat(2.0f), d);
+		Lane xs = L::mul(x, s), ys = L::mul(y, s), zs = L::mul(z, s);
+		Lane wx = L::mul(w, xs), wy = L::mul(w, ys), wz = L::mul(w, zs);
+		Lane xx = L::mul(x, xs), xy = L::mul(x, ys), xz = L::mul(x, zs);
+		Lane yy = L::mul(y, ys), yz = L::mul(y, zs), zz = L::mul(z, zs);
+		Lane one = L::splat(1.0f);
+		L::store(basis[0].x.ptr() + i, L::sub(one, L::add(yy, zz)));
+		L::store(basis[0].y.ptr() + i, L::sub(xy, wz));
+		L::store(basis[0].z.ptr() + i, L::add(xz, wy));
+		L::store(basis[1].x.ptr() + i, L::add(xy, wz));
+		L::store(basis[1].y.ptr() + i, L::sub(one, L::add(xx, zz)));
+		L::store(basis[1].z.ptr() + i, L::sub(yz, wx));
+		L::store(basis[2].x.ptr() + i, L::sub(xz, wy));
+		L::store(basis[2].y.ptr() + i, L::add(yz, wx));
+		L::store(basis[2].z.ptr() + i, L::sub(one, L::add(xx, yy)));
+	});
+}
+
+void TransformSoA::compose(const TransformSoA &p_other) {
+	ERR_FAIL_COND(p_other.size() != size());
+	const TransformArrays<real_t> arrays(*this);
+	const TransformArrays<const real_t> other_arrays(p_other);
+	_for_each_lane(size(), [&](auto p_lanes, uint32_t i) {
+		typedef decltype(p_lanes) L;
+		TransformLanes<L> t;
+		TransformLanes<L> other;
+		t.load(arrays, i);
+		other.load(other_arrays, i);
+		t.compose(other);
+		t.store(arrays, i);
+	});
+}
+
+void TransformSoA::compose_parent(const Transform3D &p_parent) {
+	const TransformArrays<real_t> arrays(*this);
+	_for_each_lane(size(), [&](auto p_lanes, uint32_t i) {
+		typedef decltype(p_lanes) L;
+		TransformLanes<L> t;
+		TransformLanes<L> child;
+		t.splat(p_parent);
+		child.load(arrays, i);
+		t.compose(child);
+		t.store(arrays, i);
+	});
+}
+
+void TransformSoA::xform(Vector3SoA &p_points) const {
+	ERR_FAIL_COND(p_points.size() != size());
+	real_t *rx = p_points.x.ptr();
+	real_t *ry = p_points.y.ptr();
+	real_t *rz = p_points.z.ptr();
+	const TransformArrays<const real_t> arrays(*this);
+	_for_each_lane(size(), [&](auto p_lanes, uint32_t i) {
+		typedef decltype(p_lanes) L;
+		TransformLanes<L> t;
+		t.load(arrays, i);
+		typename L::Lane vx = L::load(rx + i);
+		typename L::Lane vy = L::load(ry + i);
+		typename L::Lane vz = L::load(rz + i);
+		L::store(rx + i, t.xform(0, vx, vy, vz));
+		L::store(ry + i, t.xform(1, vx, vy, vz));
+		L::store(rz + i, t.xform(2, vx, vy, vz));
+	});
+}
+
+void TransformSoA::from_float32_array(const PackedFloat32Array &p_array) {
+	ERR_FAIL_COND_MSG(p_array.size() % 12 != 0, "The array size must be a multiple of 12.");
+	resize(p_array.size() / 12);
+	const float *src = p_array.ptr();
+	for (uint32_t i = 0; i < size(); i++) {
+		const float *t = src + i * 12;
+		for (int j = 0; j < 3; j++) {
+			basis[j].x[i] = t[j * 4 + 0];
+			basis[j].y[i] = t[j * 4 + 1];
+			basis[j].z[i] = t[j * 4 + 2];
+		}
+		origin.x[i] = t[3];
+		origin.y[i] = t[7];
+		origin.z[i] = t[11];
+	}
+}
+
+PackedFloat32Array TransformSoA::to_float32_array() const {
+	PackedFloat32Array array;
+	array.resize(size() * 12);
+	float *dst = array.ptrw();
+	for (uint32_t i = 0; i < size(); i++) {
+		float *t = dst + i * 12;
+		for (int j = 0; j < 3; j++) {
+			t[j * 4 + 0] = basis[j].x[i];
+			t[j * 4 + 1] = basis[j].y[i];
+			t[j * 4 + 2] = basis[j].z[i];
+		}
+		t[3] = origin.x[i];
+		t[7] = origin.y[i];
+		t[11] = origin.z[i];
+	}
+	return array;
+}
+
+} // namespace godot
@@ -0,0 +1,438 @@
+/**************************************************************************/
+/*  task_graph.cpp                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include <godot_cpp/templates/task_graph.hpp>
+
+#include <godot_cpp/classes/file_access.hpp>
+
+#include <chrono>
+
+namespace godot {
+
+uint64_t TaskGraph::_get_ticks_usec() {
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+TaskGraph::NodeID TaskGraph::_add_node(const String &p_name, NodeFunction *p_function, uint32_t p_elements, uint32_t p_grain) {
+	Node *node = memnew(Node);
+	node->name = p_name;
+	node->function = p_function;
+	node->elements = p_elements;
+	if (p_grain == 0) {
+		p_grain = MAX(1u, p_elements / DEFAULT_CHUNKS);
+	}
+	node->grain = p_grain;
+	// Empty ranges still get one (empty) chunk, so that the node completes.
+	node->chunk_count = MAX(1u, uint32_t((uint64_t(p_elements) + p_grain - 1) / p_grain));
+	nodes.push_back(node);
+	compiled = false;
+	return nodes.size() - 1;
+}
+
+void TaskGraph::add_dependency(NodeID p_before, NodeID p_after) {
+	ERR_FAIL_UNSIGNED_INDEX(p_before, nodes.size());
+	ERR_FAIL_UNSIGNED_INDEX(p_after, nodes.size());
+	ERR_FAIL_COND_MSG(p_before == p_after, "A TaskGraph node can't depend on itself.");
+
+	LocalVector<NodeID> &successors = nodes[p_before]->successors;
+	for (NodeID successor : successors) {
+		if (successor == p_after) {
+			return;
+		}
+	}
+	successors.push_back(p_after);
+	compiled = false;
+}
+
+Error TaskGraph::compile() {
+	for (Node *node : nodes) {
+		node->dependency_count = 0;
+	}
+	for (Node *node : nodes) {
+		for (NodeID successor : node->successors) {
+			nodes[successor]->dependency_count++;
+		}
+	}
+
+	// Kahn's algorithm; nodes left out are part of a cycle.
+	order.clear();
+	LocalVector<uint32_t> in_degree;
+	in_degree.resize(nodes.size());
+	for (uint32_t i = 0; i < nodes.size(); i++) {
+		in_degree[i] = nodes[i]->dependency_count;
+		if (in_degree[i] == 0) {
+			order.push_back(i);
+		}
+	}
+	for (uint32_t i = 0; i < order.size(); i++) {
+		for (NodeID successor : nodes[order[i]]->successors) {
+			if (--in_degree[successor] == 0) {
+				order.push_back(successor);
+			}
+		}
+	}
+	ERR_FAIL_COND_V_MSG(order.size() != nodes.size(), ERR_CYCLIC_LINK, "TaskGraph has a dependency cycle.");
+
+	total_chunks = 0;
+	for (Node *node : nodes) {
+		total_chunks += node->chunk_count;
+	}
+	ready.resize(total_chunks);
+	frame_events.resize(total_chunks);
+	// Engine runners are started at most once per chunk, see _request_runners().
+	runner_tasks.reserve(total_chunks);
+
+	_update_priorities();
+	compiled = true;
+	return OK;
+}
+
+void TaskGraph::_update_priorities() {
+	for (int64_t i = int64_t(order.size()) - 1; i >= 0; i--) {
+		Node *node = nodes[order[i]];
+		uint64_t longest = 0;
+		for (NodeID successor : node->successors) {
+			longest = MAX(longest, nodes[successor]->priority);
+		}
+		node->priority = node->duration_usec + longest;
+	}
+}
+
+void TaskGraph::_push_ready(NodeID p_node) {
+	const Node *node = nodes[p_node];
+	ready_lock.lock();
+	for (uint32_t chunk = 0; chunk < node->chunk_count; chunk++) {
+		uint32_t i = ready_count++;
+		while (i > 0) {
+			uint32_t parent = (i - 1) / 2;
+			if (ready[parent].priority >= node->priority) {
+				break;
+			}
+			ready[i] = ready[parent];
+			i = parent;
+		}
+		ready[i] = { node->priority, p_node, chunk };
+	}
+	const uint32_t ready_chunks = ready_count;
+	ready_lock.unlock();
+	_wake_runners(node->chunk_count > 1);
+	if (engine_pool) {
+		_request_runners(ready_chunks, node->chunk_count);
+	}
+}
+
+bool TaskGraph::_pop_ready(ReadyChunk &r_chunk) {
+	ready_lock.lock();
+	if (ready_count == 0) {
+		ready_lock.unlock();
+		return false;
+	}
+	r_chunk = ready[0];
+	const ReadyChunk last = ready[--ready_count];
+	uint32_t i = 0;
+	while (true) {
+		uint32_t child = i * 2 + 1;
+		if (child >= ready_count) {
+			break;
+		}
+		if (child + 1 < ready_count && ready[child + 1].priority > ready[child].priority) {
+			child++;
+		}
+		if (ready[child].priority <= last.priority) {
+			break;
+		}
+		ready[i] = ready[child];
+		i = child;
+	}
+	if (ready_count > 0) {
+		ready[i] = last;
+	}
+	ready_lock.unlock();
+	return true;
+}
+
+bool TaskGraph::_spin_ready(ReadyChunk &r_chunk) {
+	SpinBackoff backoff;
+	for (uint32_t i = 0; i < IDLE_SPINS; i++) {
+		backoff.wait();
+		if (_pop_ready(r_chunk)) {
+			return true;
+		}
+		if (remaining_nodes.load(std::memory_order_acquire) == 0) {
+			return false;
+		}
+	}
+	return false;
+}
+
+bool TaskGraph::_wait_ready(ReadyChunk &r_chunk) {
+	if (_spin_ready(r_chunk)) {
+		return true;
+	}
+
+	// Pairs with _wake_runners(): either the chunks are seen here, or the
+	// thread pushing them sees this runner and bumps the epoch.
+	const uint32_t epoch = ready_epoch.load(std::memory_order_seq_cst);
+	idle_runners.fetch_add(1, std::memory_order_seq_cst);
+	const bool found = _pop_ready(r_chunk);
+	if (!found && remaining_nodes.load(std::memory_order_seq_cst) != 0) {
+		std::unique_lock<std::mutex> lock(idle_mutex);
+		idle_condition.wait(lock, [this, epoch]() {
+			return ready_epoch.load(std::memory_order_seq_cst) != epoch;
+		});
+	}
+	idle_runners.fetch_sub(1, std::memory_order_relaxed);
+	return found;
+}
+
+void TaskGraph::_wake_runners(bool p_all) {
+	ready_epoch.fetch_add(1, std::memory_order_seq_cst);
+	if (idle_runners.load(std::memory_order_seq_cst) > 0) {
+		std::lock_guard<std::mutex> lock(idle_mutex);
+		if (p_all) {
+			idle_condition.notify_all();
+		} else {
+			idle_condition.notify_one();
+		}
+	}
+}
+
+void TaskGraph::_request_runners(uint32_t p_ready, uint32_t p_pushed) {
+	// At most one new runner per pushed chunk, which bounds runner_tasks by total_chunks.
+	std::lock_guard<std::mutex> lock(runner_mutex);
+	const uint32_t wanted = MIN(p_ready, max_engine_runners);
+	for (uint32_t i = 0; i < p_pushed && active_runners < wanted; i++) {
+		active_runners++;
+		runner_tasks.push_back(engine_pool->add_native_task(&TaskGraph::_engine_runner, this, true));
+	}
+}
+
+void TaskGraph::_engine_runner(void *p_graph) {
+	TaskGraph *graph = static_cast<TaskGraph *>(p_graph);
+	graph->runner_mutex.lock();
+	const uint32_t id = graph->free_runner_ids[--graph->free_runner_count];
+	graph->runner_mutex.unlock();
+
+	// Leaves as soon as nothing is ready, rather than holding an engine
+	// thread that the nodes running elsewhere may need.
+	ReadyChunk chunk;
+	while (graph->_pop_ready(chunk) || graph->_spin_ready(chunk)) {
+		graph->_run_ready(id, chunk);
+	}
+
+	graph->runner_mutex.lock();
+	graph->free_runner_ids[graph->free_runner_count++] = id;
+	graph->active_runners--;
+	graph->runner_mutex.unlock();
+}
+
+void TaskGraph::_execute_on_engine(WorkerThreadPool *p_pool) {
+	// The calling thread runs chunks too, and one engine thread is left for
+	// the group tasks of nodes calling parallel_for().
+	engine_pool = p_pool;
+	max_engine_runners = MIN(total_chunks, (uint32_t)MAX(1, _parallel_thread_count(p_pool))) - 1;
+	if (free_runner_ids.size() < max_engine_runners) {
+		free_runner_ids.resize(max_engine_runners);
+	}
+	for (uint32_t i = 0; i < max_engine_runners; i++) {
+		free_runner_ids[i] = i + 1;
+	}
+	free_runner_count = max_engine_runners;
+	runner_tasks.clear();
+
+	_begin_execution();
+	run_chunk(0, 0, 0);
+
+	// A runner's task is recorded before it starts, and runners only start
+	// others while they run, so once every recorded task is done none are left.
+	uint32_t waited = 0;
+	while (true) {
+		runner_mutex.lock();
+		if (waited == runner_tasks.size()) {
+			runner_mutex.unlock();
+			break;
+		}
+		const WorkerThreadPool::TaskID task = runner_tasks[waited++];
+		runner_mutex.unlock();
+		engine_pool->wait_for_task_completion(task);
+	}
+	engine_pool = nullptr;
+	_end_execution();
+}
+
+void TaskGraph::_complete_node(Node *p_node) {
+	for (NodeID successor : p_node->successors) {
+		if (nodes[successor]->pending_dependencies.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			_push_ready(successor);
+		}
+	}
+	if (remaining_nodes.fetch_sub(1, std::memory_order_seq_cst) == 1) {
+		_wake_runners(true);
+	}
+}
+
+void TaskGraph::_begin_execution() {
+	for (Node *node : nodes) {
+		node->pending_dependencies.store(node->dependency_count, std::memory_order_relaxed);
+		node->pending_chunks.store(node->chunk_count, std::memory_order_relaxed);
+		node->start_usec.store(0, std::memory_order_relaxed);
+	}
+	ready_count = 0;
+	frame_event_count.store(0, std::memory_order_relaxed);
+	remaining_nodes.store(nodes.size(), std::memory_order_relaxed);
+	for (uint32_t i = 0; i < nodes.size(); i++) {
+		if (nodes[i]->dependency_count == 0) {
+			_push_ready(i);
+		}
+	}
+}
+
+void TaskGraph::_end_execution() {
+	for (Node *node : nodes) {
+		node->duration_usec = MAX(uint64_t(1), node->end_usec - node->start_usec.load(std::memory_order_relaxed));
+	}
+	_update_priorities();
+
+	if (tracing && trace_capacity > 0) {
+		const uint32_t count = frame_event_count.load(std::memory_order_relaxed);
+		for (uint32_t i = 0; i < count; i++) {
+			if (trace.size() < trace_capacity) {
+				trace.push_back(frame_events[i]);
+			} else {
+				trace[trace_start] = frame_events[i];
+				trace_start = (trace_start + 1) % trace_capacity;
+			}
+		}
+	}
+	frame++;
+}
+
+void TaskGraph::_run_ready(uint32_t p_runner, const ReadyChunk &p_chunk) {
+	Node *node = nodes[p_chunk.node];
+	const uint64_t begin = uint64_t(p_chunk.chunk) * node->grain;
+	const uint64_t end = MIN(begin + node->grain, uint64_t(node->elements));
+
+	const uint64_t start_usec = _get_ticks_usec();
+	uint64_t unset = 0;
+	node->start_usec.compare_exchange_strong(unset, start_usec, std::memory_order_relaxed);
+	node->function->call(uint32_t(begin), uint32_t(end));
+	const uint64_t end_usec = _get_ticks_usec();
+
+	if (tracing) {
+		const uint32_t index = frame_event_count.fetch_add(1, std::memory_order_relaxed);
+		frame_events[index] = { p_chunk.node, p_chunk.chunk, p_runner, frame, start_usec, end_usec };
+	}
+
+	if (node->pending_chunks.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+		node->end_usec = end_usec;
+		_complete_node(node);
+	}
+}
+
+void TaskGraph::run_chunk(uint32_t p_runner, uint32_t p_begin, uint32_t p_end) {
+	while (remaining_nodes.load(std::memory_order_acquire) != 0) {
+		ReadyChunk chunk;
+		if (_pop_ready(chunk) || _wait_ready(chunk)) {
+			_run_ready(p_runner, chunk);
+		}
+	}
+}
+
+String TaskGraph::get_node_name(NodeID p_node) const {
+	ERR_FAIL_UNSIGNED_INDEX_V(p_node, nodes.size(), String());
+	return nodes[p_node]->name;
+}
+
+uint64_t TaskGraph::get_node_time_usec(NodeID p_node) const {
+	ERR_FAIL_UNSIGNED_INDEX_V(p_node, nodes.size(), 0);
+	return nodes[p_node]->duration_usec;
+}
+
+Error TaskGraph::save_trace(const String &p_path) const {
+	Ref<FileAccess> file = FileAccess::open(p_path, FileAccess::WRITE);
+	ERR_FAIL_COND_V_MSG(file.is_null(), ERR_FILE_CANT_OPEN, "Cannot open file '" + p_path + "' for writing.");
+
+	uint64_t origin = UINT64_MAX;
+	for (const TraceEvent &event : trace) {
+		origin = MIN(origin, event.start_usec);
+	}
+	// Oldest event first.
+	const uint32_t count = trace.size();
+
+	LocalVector<String> escaped_names;
+	escaped_names.resize(nodes.size());
+	for (uint32_t i = 0; i < nodes.size(); i++) {
+		escaped_names[i] = nodes[i]->name.json_escape();
+	}
+
+	file->store_string("{\"traceEvents\":[\n");
+	for (uint32_t i = 0; i < count; i++) {
+		const TraceEvent &event = trace[(trace_start + i) % count];
+		String line = "{\"name\":\"" + escaped_names[event.node] + "\",\"cat\":\"task_graph\",\"ph\":\"X\",\"pid\":0";
+		line += ",\"tid\":" + String::num_int64(event.thread);
+		line += ",\"ts\":" + String::num_int64(event.start_usec - origin);
+		line += ",\"dur\":" + String::num_int64(event.end_usec - event.start_usec);
+		line += ",\"args\":{\"frame\":" + String::num_int64(event.frame) + ",\"chunk\":" + String::num_int64(event.chunk) + "}}";
+		line += i + 1 < count ? ",\n" : "\n";
+		file->store_string(line);
+	}
+	file->store_string("]}\n");
+	return file->get_error();
+}
+
+void TaskGraph::set_trace_capacity(uint32_t p_events) {
+	trace_capacity = p_events;
+	clear_trace();
+}
+
+void TaskGraph::clear_trace() {
+	trace.reset();
+	trace_start = 0;
+	frame = 0;
+}
+
+void TaskGraph::clear() {
+	for (Node *node : nodes) {
+		memdelete(node->function);
+		memdelete(node);
+	}
+	nodes.reset();
+	order.reset();
+	ready.reset();
+	frame_events.reset();
+	runner_tasks.reset();
+	free_runner_ids.reset();
+	free_runner_count = 0;
+	total_chunks = 0;
+	compiled = false;
+	clear_trace();
+}
+
+} // namespace godot
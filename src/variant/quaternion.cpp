@@ -62,6 +62,9 @@ Vector3 Quaternion::get_euler_yxz() const {
 }
 
 void Quaternion::operator*=(const Quaternion &p_q) {
+#ifdef GODOT_SIMD_ENABLED
+	Simd::store4(components, Simd::quaternion_multiply(Simd::load4(components), Simd::load4(p_q.components)));
+#else
 	real_t xx = w * p_q.x + x * p_q.w + y * p_q.z - z * p_q.y;
 	real_t yy = w * p_q.y + y * p_q.w + z * p_q.x - x * p_q.z;
 	real_t zz = w * p_q.z + z * p_q.w + x * p_q.y - y * p_q.x;
@@ -69,6 +72,7 @@ void Quaternion::operator*=(const Quaternion &p_q) {
 	x = xx;
 	y = yy;
 	z = zz;
+#endif
 }
 
 Quaternion Quaternion::operator*(const Quaternion &p_q) const {
@@ -72,6 +72,15 @@ real_t Vector4::length() const {
 }
 
 void Vector4::normalize() {
+#ifdef GODOT_SIMD_ENABLED
+	Simd::Float4 v = Simd::load4(components);
+	real_t lengthsq = Simd::dot4(v, v);
+	if (lengthsq == 0) {
+		x = y = z = w = 0;
+	} else {
+		Simd::store4(components, Simd::div(v, Simd::splat(Math::sqrt(lengthsq))));
+	}
+#else
 	real_t lengthsq = length_squared();
 	if (lengthsq == 0) {
 		x = y = z = w = 0;
@@ -82,6 +91,7 @@ void Vector4::normalize() {
 		z /= length;
 		w /= length;
 	}
+#endif
 }
 
 Vector4 Vector4::normalized() const {
@@ -117,11 +127,23 @@ Vector4 Vector4::sign() const {
 }
 
 Vector4 Vector4::floor() const {
+#ifdef GODOT_SIMD_ROUNDING
+	Vector4 ret;
+	Simd::store4(ret.components, Simd::floor(Simd::load4(components)));
+	return ret;
+#else
 	return Vector4(Math::floor(x), Math::floor(y), Math::floor(z), Math::floor(w));
+#endif
 }
 
 Vector4 Vector4::ceil() const {
+#ifdef GODOT_SIMD_ROUNDING
+	Vector4 ret;
+	Simd::store4(ret.components, Simd::ceil(Simd::load4(components)));
+	return ret;
+#else
 	return Vector4(Math::ceil(x), Math::ceil(y), Math::ceil(z), Math::ceil(w));
+#endif
 }
 
 Vector4 Vector4::round() const {
@@ -129,11 +151,17 @@ Vector4 Vector4::round() const {
 }
 
 Vector4 Vector4::lerp(const Vector4 &p_to, const real_t p_weight) const {
+#ifdef GODOT_SIMD_ENABLED
+	Vector4 ret;
+	Simd::store4(ret.components, Simd::lerp(Simd::load4(components), Simd::load4(p_to.components), p_weight));
+	return ret;
+#else
 	return Vector4(
 			x + (p_weight * (p_to.x - x)),
 			y + (p_weight * (p_to.y - y)),
 			z + (p_weight * (p_to.z - z)),
 			w + (p_weight * (p_to.w - w)));
+#endif
 }
 
 Vector4 Vector4::cubic_interpolate(const Vector4 &p_b, const Vector4 &p_pre_a, const Vector4 &p_post_b, const real_t p_weight) const {
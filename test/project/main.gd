@@ -155,6 +155,116 @@ func _ready():
 	# PackedArray iterators
 	assert_equal(example.test_vector_ops(), 105)
 
+	# FlatHashMap.
+	assert_equal(example.test_flat_hash_map(), 6534)
+
+	# ConcurrentHashMap.
+	assert_equal(example.test_concurrent_hash_map(1000), 499000)
+
+	# ParallelSortArray.
+	assert_equal(example.test_parallel_sort(100000), true)
+
+	# SmallVector.
+	assert_equal(example.test_small_vector(), 3976)
+
+	# Vector copy-on-write.
+	assert_equal(example.test_vector_copy_on_write(), [1, 2, 3, 4, 5, 5, 4, 3, 2, 1, 1, 2, 9, 3, 4, 5, 5, 4, 3, 2, 1])
+
+	# BTreeMap and BTreeSet.
+	assert_equal(example.test_b_tree(10000), true)
+
+	# SPSCQueue and MPMCQueue.
+	assert_equal(example.test_queues(10000), true)
+
+	# RID_Owner.
+	assert_equal(example.test_rid_owner(1000), true)
+
+	# SpinLock and RWSpinLock.
+	assert_equal(example.test_spin_locks(10000), true)
+
+	# HashStream64.
+	assert_equal(example.test_hash_stream(), true)
+
+	# SearchArray, VMap and VSet.
+	assert_equal(example.test_search_array(), true)
+
+	# SlotMap.
+	assert_equal(example.test_slot_map(10000), true)
+
+	# WorkStealingDeque and WorkStealingPool.
+	assert_equal(example.test_work_stealing(10000), true)
+
+	# CPUTopology.
+	assert_equal(example.test_cpu_topology(), true)
+
+	# ThreadWorkPool scratch arenas.
+	assert_equal(example.test_thread_scratch(1000), true)
+
+	# SIMD math, bit for bit against the scalar formulas.
+	assert_equal(example.test_simd_math(100000), true)
+
+	# RadixSort.
+	assert_equal(example.test_radix_sort(PackedInt32Array([5, -3, 42, 0, -100, 7])), PackedInt32Array([-100, -3, 0, 5, 7, 42]))
+	assert_equal(example.test_radix_sort_matches(5000), true)
+
+	# BitVector.
+	assert_equal(example.test_bit_vector(PackedByteArray([0x0F, 0xF0, 0x01])), PackedByteArray([0xF0, 0x0F, 0xFE]))
+
+	# FrozenHashTable.
+	assert_equal(example.test_frozen_hash_table("sword"), "Very sharp")
+	assert_equal(example.test_frozen_hash_table("axe"), "not found")
+
+	# parallel_for() and parallel_reduce().
+	assert_equal(example.test_parallel_reduce(1000), 332833500)
+
+	# WorkerTasks, TaskFuture and TaskGroup.
+	assert_equal(example.test_worker_tasks(20), 51)
+
+	# TaskGraph.
+	assert_equal(example.test_task_graph(100), 24910050)
+
+	# ScratchArena.
+	assert_equal(example.test_scratch_arena(20000), 599970000)
+
+	# EngineCommandBuffer.
+	assert_equal(example.test_command_buffer(100), "Commands:4950:7")
+
+	# Vector and Quaternion math, checked against the engine.
+	var va = Vector3(1.5, -2.25, 3.75)
+	var vb = Vector3(-0.5, 4.0, 2.125)
+	var qa = Quaternion(Vector3(0.6, 0.0, 0.8), 0.9)
+	var qb = Quaternion(Vector3(0.0, 1.0, 0.0), -1.3)
+	var v4a = Vector4(1.25, -3.5, 0.75, 2.0)
+	var v4b = Vector4(-2.0, 0.5, 4.25, -1.5)
+	var math_expected = [
+		va.dot(vb), va.cross(vb), va.normalized(), va.length(), va.lerp(vb, 0.25),
+		Vector3(minf(va.x, vb.x), minf(va.y, vb.y), minf(va.z, vb.z)),
+		Vector3(maxf(va.x, vb.x), maxf(va.y, vb.y), maxf(va.z, vb.z)),
+		va.floor(), qa * qb, qa * vb,
+		v4a.dot(v4b), v4a.normalized(), v4a.lerp(v4b, 0.25),
+		Vector4(minf(v4a.x, v4b.x), minf(v4a.y, v4b.y), minf(v4a.z, v4b.z), minf(v4a.w, v4b.w)),
+		v4a.ceil(),
+	]
+	var math_results = example.test_vector_math(va, vb, qa, qb, v4a, v4b)
+	assert_equal(math_results.size(), math_expected.size())
+	for i in math_expected.size():
+		if math_expected[i] is float:
+			assert_true(is_equal_approx(math_results[i], math_expected[i]))
+		else:
+			assert_true(math_results[i].is_equal_approx(math_expected[i]))
+
+	# Vector3SoA and TransformSoA.
+	var positions = PackedVector3Array()
+	var velocities = PackedVector3Array()
+	for i in 7:
+		positions.push_back(Vector3(i, -i * 0.5, 2.0))
+		velocities.push_back(Vector3(1.0, i, -i))
+	var soa_results = example.test_soa_math(positions, velocities, qa)
+	assert_equal(soa_results.size(), positions.size())
+	for i in positions.size():
+		var expected = qa * (positions[i] + velocities[i] * 0.5) + Vector3(1, 2, 3)
+		assert_true(soa_results[i].is_equal_approx(expected))
+
 	# Properties.
 	assert_equal(example.group_subgroup_custom_position, Vector2(0, 0))
 	example.group_subgroup_custom_position = Vector2(50, 50)
@@ -241,6 +351,34 @@ func _ready():
 	assert_equal(new_example_ref.was_post_initialized(), true)
 	assert_equal(example.test_post_initialize(), true)
 
+	# Coroutines, resumed over the next frames.
+	var coroutines = ExampleCoroutines.new()
+	add_child(coroutines)
+	var coroutine_owner = Node.new()
+	coroutines.start(coroutine_owner)
+	coroutine_owner.free()
+	coroutines.step.emit(7)
+	for i in range(100):
+		if coroutines.is_done():
+			break
+		await get_tree().process_frame
+	coroutines.finish()
+	assert_equal(coroutines.get_results(), {
+		"signal": [7],
+		"owner_cancelled": true,
+		"background": 42,
+		"background_on_main_thread": true,
+		"nested": 42,
+		"cleared": true,
+	})
+	coroutines.queue_free()
+
+	# Timings of the performance oriented containers, only with `-- --benchmark`.
+	if OS.get_cmdline_user_args().has("--benchmark"):
+		var timings = example.run_benchmarks(1000000)
+		for key in timings:
+			print("%s: %d usec" % [key, timings[key]])
+
 	exit_with_status()
 
 func _on_Example_custom_signal(signal_name, value):
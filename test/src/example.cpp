@@ -11,8 +11,44 @@
 #include <godot_cpp/classes/label.hpp>
 #include <godot_cpp/classes/multiplayer_api.hpp>
 #include <godot_cpp/classes/multiplayer_peer.hpp>
+#include <godot_cpp/classes/time.hpp>
 #include <godot_cpp/variant/utility_functions.hpp>
 
+#include <godot_cpp/core/engine_command_buffer.hpp>
+#include <godot_cpp/templates/b_tree_map.hpp>
+#include <godot_cpp/templates/b_tree_set.hpp>
+#include <godot_cpp/templates/bit_vector.hpp>
+#include <godot_cpp/templates/concurrent_hash_map.hpp>
+#include <godot_cpp/templates/cpu_topology.hpp>
+#include <godot_cpp/templates/eytzinger_array.hpp>
+#include <godot_cpp/templates/flat_hash_map.hpp>
+#include <godot_cpp/templates/flat_hash_set.hpp>
+#include <godot_cpp/templates/frozen_hash_table.hpp>
+#include <godot_cpp/templates/hash_map.hpp>
+#include <godot_cpp/templates/mpmc_queue.hpp>
+#include <godot_cpp/templates/parallel_for.hpp>
+#include <godot_cpp/templates/parallel_sort_array.hpp>
+#include <godot_cpp/templates/radix_sort.hpp>
+#include <godot_cpp/templates/rb_map.hpp>
+#include <godot_cpp/templates/rid_owner.hpp>
+#include <godot_cpp/templates/scratch_arena.hpp>
+#include <godot_cpp/templates/search_array.hpp>
+#include <godot_cpp/templates/slot_map.hpp>
+#include <godot_cpp/templates/small_vector.hpp>
+#include <godot_cpp/templates/soa_math.hpp>
+#include <godot_cpp/templates/sort_array.hpp>
+#include <godot_cpp/templates/spin_lock.hpp>
+#include <godot_cpp/templates/spsc_queue.hpp>
+#include <godot_cpp/templates/task_graph.hpp>
+#include <godot_cpp/templates/thread_work_pool.hpp>
+#include <godot_cpp/templates/vmap.hpp>
+#include <godot_cpp/templates/vset.hpp>
+#include <godot_cpp/templates/work_stealing_deque.hpp>
+#include <godot_cpp/templates/work_stealing_pool.hpp>
+#include <godot_cpp/templates/worker_tasks.hpp>
+
+#include <thread>
+
 using namespace godot;
 
 class MyCallableCustom : public CallableCustom {
@@ -197,6 +233,34 @@ void Example::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("test_string_is_fourty_two"), &Example::test_string_is_fourty_two);
 	ClassDB::bind_method(D_METHOD("test_string_resize"), &Example::test_string_resize);
 	ClassDB::bind_method(D_METHOD("test_vector_ops"), &Example::test_vector_ops);
+	ClassDB::bind_method(D_METHOD("test_flat_hash_map"), &Example::test_flat_hash_map);
+	ClassDB::bind_method(D_METHOD("test_concurrent_hash_map", "count"), &Example::test_concurrent_hash_map);
+	ClassDB::bind_method(D_METHOD("test_parallel_sort", "count"), &Example::test_parallel_sort);
+	ClassDB::bind_method(D_METHOD("test_small_vector"), &Example::test_small_vector);
+	ClassDB::bind_method(D_METHOD("test_vector_copy_on_write"), &Example::test_vector_copy_on_write);
+	ClassDB::bind_method(D_METHOD("test_b_tree", "count"), &Example::test_b_tree);
+	ClassDB::bind_method(D_METHOD("test_queues", "count"), &Example::test_queues);
+	ClassDB::bind_method(D_METHOD("test_rid_owner", "count"), &Example::test_rid_owner);
+	ClassDB::bind_method(D_METHOD("test_spin_locks", "count"), &Example::test_spin_locks);
+	ClassDB::bind_method(D_METHOD("test_hash_stream"), &Example::test_hash_stream);
+	ClassDB::bind_method(D_METHOD("test_search_array"), &Example::test_search_array);
+	ClassDB::bind_method(D_METHOD("test_slot_map", "count"), &Example::test_slot_map);
+	ClassDB::bind_method(D_METHOD("test_work_stealing", "count"), &Example::test_work_stealing);
+	ClassDB::bind_method(D_METHOD("test_cpu_topology"), &Example::test_cpu_topology);
+	ClassDB::bind_method(D_METHOD("test_thread_scratch", "count"), &Example::test_thread_scratch);
+	ClassDB::bind_method(D_METHOD("test_simd_math", "count"), &Example::test_simd_math);
+	ClassDB::bind_method(D_METHOD("test_radix_sort", "array"), &Example::test_radix_sort);
+	ClassDB::bind_method(D_METHOD("test_radix_sort_matches", "count"), &Example::test_radix_sort_matches);
+	ClassDB::bind_method(D_METHOD("test_bit_vector", "bytes"), &Example::test_bit_vector);
+	ClassDB::bind_method(D_METHOD("test_frozen_hash_table", "key"), &Example::test_frozen_hash_table);
+	ClassDB::bind_method(D_METHOD("test_parallel_reduce", "count"), &Example::test_parallel_reduce);
+	ClassDB::bind_method(D_METHOD("test_worker_tasks", "value"), &Example::test_worker_tasks);
+	ClassDB::bind_method(D_METHOD("test_task_graph", "count"), &Example::test_task_graph);
+	ClassDB::bind_method(D_METHOD("test_scratch_arena", "count"), &Example::test_scratch_arena);
+	ClassDB::bind_method(D_METHOD("test_command_buffer", "count"), &Example::test_command_buffer);
+	ClassDB::bind_method(D_METHOD("test_vector_math", "a", "b", "q", "r", "v", "u"), &Example::test_vector_math);
+	ClassDB::bind_method(D_METHOD("test_soa_math", "positions", "velocities", "rotation"), &Example::test_soa_math);
+	ClassDB::bind_method(D_METHOD("run_benchmarks", "count"), &Example::run_benchmarks);
 
 	ClassDB::bind_method(D_METHOD("test_object_cast_to_node", "object"), &Example::test_object_cast_to_node);
 	ClassDB::bind_method(D_METHOD("test_object_cast_to_control", "object"), &Example::test_object_cast_to_control);
@@ -408,6 +472,1611 @@ int Example::test_vector_ops() const {
 	return ret;
 }
 
+int Example::test_flat_hash_map() const {
+	FlatHashMap<int, int> map;
+	for (int i = 0; i < 100; i++) {
+		map.insert(i, i * 2);
+	}
+	for (int i = 0; i < 100; i += 3) {
+		map.erase(i);
+	}
+	if (map.size() != 66 || map.has(3) || !map.has(4)) {
+		return -1;
+	}
+	map[200] += 1;
+	map[4] += 1;
+	if (map.size() != 67 || map[200] != 1 || map[4] != 9) {
+		return -1;
+	}
+	map.erase(200);
+	map[4] -= 1;
+
+	FlatHashSet<int> set;
+	for (int i = 0; i < 100; i++) {
+		set.insert(i % 50);
+	}
+	for (int i = 0; i < 50; i += 2) {
+		set.erase(i);
+	}
+	if (set.size() != 25 || set.has(2) || !set.has(3)) {
+		return -1;
+	}
+	int ret = 0;
+	for (const KeyValue<int, int> &E : map) {
+		ret += E.value;
+	}
+	return ret;
+}
+
+int64_t Example::test_concurrent_hash_map(int p_count) const {
+	// Writers and readers run at the same time on a ThreadWorkPool.
+	ConcurrentHashMap<int, int> map;
+	std::atomic<int> errors = { 0 };
+	ThreadWorkPool pool;
+	pool.init();
+	parallel_for(0, p_count, 16, [&](uint32_t i) {
+		map.insert(i, i * 2);
+		int value = 0;
+		if (map.get(i / 2, value) && value != int(i / 2) * 2) {
+			errors++;
+		}
+		if (map.get_or_insert(-1, i) != map.get_or_insert(-1, -2)) {
+			errors++;
+		}
+	}, &pool);
+	parallel_for(0, p_count, 16, [&](uint32_t i) {
+		if (i % 2 == 1 && !map.erase(i)) {
+			errors++;
+		}
+	}, &pool);
+	pool.finish();
+	if (errors.load() != 0 || !map.erase(-1) || map.has(1) || map.size() != uint32_t(p_count + 1) / 2) {
+		return -1;
+	}
+
+	int64_t sum = 0;
+	for (const KeyValue<int, int> &E : map.snapshot()) {
+		sum += E.value;
+	}
+	return sum;
+}
+
+bool Example::test_parallel_sort(int p_count) const {
+	// Distinct values, a few distinct values, and a single repeated value.
+	const int value_ranges[] = { p_count, 3, 1 };
+	ParallelSortArray<int> sorter;
+	for (int range : value_ranges) {
+		LocalVector<int> values;
+		values.resize(p_count);
+		for (int i = 0; i < p_count; i++) {
+			values[i] = (int)(hash_murmur3_one_32(i) % range);
+		}
+		LocalVector<int> selected = values;
+
+		sorter.sort(values.ptr(), p_count);
+		for (int i = 1; i < p_count; i++) {
+			if (values[i - 1] > values[i]) {
+				return false;
+			}
+		}
+
+		int nth = p_count / 3;
+		sorter.nth_element(0, p_count, nth, selected.ptr());
+		if (selected[nth] != values[nth]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+int Example::test_small_vector() const {
+	// Spilling to the heap, and back to inline storage.
+	SmallVector<int, 4> small = { 1, 2, 3, 4 };
+	if (!small.is_inline()) {
+		return -1;
+	}
+	small.push_back(5);
+	if (small.is_inline() || small.size() != 5) {
+		return -1;
+	}
+	small.reset();
+	small.push_back(0x01020304);
+	Vector<uint8_t> bytes = small.to_byte_array();
+	if (!small.is_inline() || bytes.size() != 4 || memcmp(bytes.ptr(), small.ptr(), 4) != 0) {
+		return -1;
+	}
+
+	// Outer containers move the nested ones with memcpy when they grow.
+	LocalVector<SmallVector<int, 4>> local;
+	Vector<SmallVector<int, 4>> cow;
+	for (int i = 0; i < 32; i++) {
+		local.push_back(SmallVector<int, 4>{ i });
+		cow.push_back(SmallVector<int, 4>{ i });
+		local[i / 2].push_back(i);
+		cow.write[i / 2].push_back(i);
+	}
+	Vector<SmallVector<int, 4>> cow_copy = cow;
+	cow.write[0].push_back(1000);
+
+	int sum = 0;
+	for (int i = 0; i < 32; i++) {
+		for (int value : local[i]) {
+			sum += value;
+		}
+		for (int value : cow[i]) {
+			sum += value;
+		}
+		for (int value : cow_copy[i]) {
+			sum += value;
+		}
+	}
+	return sum;
+}
+
+Array Example::test_vector_copy_on_write() const {
+	// reverse(), insert() and append_array() unshare once before writing, copies must be left untouched.
+	Vector<int> original = { 1, 2, 3, 4, 5 };
+	Vector<int> reversed = original;
+	reversed.reverse();
+	Vector<int> appended = original;
+	appended.insert(2, 9);
+	appended.append_array(reversed);
+
+	Array ret;
+	for (const Vector<int> &vector : { original, reversed, appended }) {
+		for (int value : vector) {
+			ret.push_back(value);
+		}
+	}
+	return ret;
+}
+
+// Compares the contents and the bound queries of B-trees against an RBMap holding the same keys.
+template <class M, class S>
+static bool _b_tree_matches(const M &p_map, const S &p_set, const RBMap<int, int> &p_reference, int p_probe) {
+	if (p_map.size() != (uint32_t)p_reference.size() || p_set.size() != (uint32_t)p_reference.size()) {
+		return false;
+	}
+	const RBMap<int, int>::Element *E = p_reference.front();
+	typename S::Iterator set_iterator = p_set.begin();
+	for (const KeyValue<int, int> &pair : p_map) {
+		if (!E || E->key() != pair.key || E->value() != pair.value || *set_iterator != pair.key) {
+			return false;
+		}
+		E = E->next();
+		++set_iterator;
+	}
+	if (E || set_iterator != p_set.end()) {
+		return false;
+	}
+
+	const RBMap<int, int>::Element *closest = p_reference.find_closest(p_probe);
+	typename M::ConstIterator map_closest = p_map.find_closest(p_probe);
+	if (bool(closest) != bool(map_closest) || (closest && closest->key() != map_closest->key)) {
+		return false;
+	}
+	typename M::ConstIterator lower = p_map.lower_bound(p_probe);
+	const RBMap<int, int>::Element *expected_lower = closest && closest->key() == p_probe ? closest : (closest ? closest->next() : p_reference.front());
+	return bool(lower) == bool(expected_lower) && (!lower || lower->key == expected_lower->key());
+}
+
+bool Example::test_b_tree(int p_count) const {
+	// Tiny nodes, so splits and underflow merges happen all the time.
+	BTreeMap<int, int, Comparator<int>, 4> map;
+	BTreeSet<int, Comparator<int>, 4> set;
+	RBMap<int, int> reference;
+
+	// Random inserts and erases, over a key range small enough to hit existing keys often.
+	const int key_range = p_count / 4 + 1;
+	for (int i = 0; i < p_count; i++) {
+		uint32_t random = hash_murmur3_one_32(i);
+		int key = (int)((random >> 8) % key_range);
+		if (random % 3 != 0) {
+			map.insert(key, i);
+			set.insert(key);
+			reference.insert(key, i);
+		} else {
+			bool erased = reference.erase(key);
+			if (map.erase(key) != erased || set.erase(key) != erased) {
+				return false;
+			}
+		}
+		if (map.has(key) != reference.has(key) || set.has(key) != reference.has(key)) {
+			return false;
+		}
+		if (i % 64 == 0 && !_b_tree_matches(map, set, reference, key)) {
+			return false;
+		}
+	}
+	if (!_b_tree_matches(map, set, reference, key_range / 2)) {
+		return false;
+	}
+
+	// Erase everything, odd keys first so nodes underflow all over the tree, merging down to an empty one.
+	for (int i = 0; i < key_range; i++) {
+		int key = i < key_range / 2 ? i * 2 + 1 : (i - key_range / 2) * 2;
+		bool erased = reference.erase(key);
+		if (map.erase(key) != erased || set.erase(key) != erased) {
+			return false;
+		}
+	}
+	if (!map.is_empty() || !set.is_empty() || map.begin() != map.end() || !_b_tree_matches(map, set, reference, 0)) {
+		return false;
+	}
+
+	// Linear time construction from sorted keys, then further edits on top of it.
+	LocalVector<int> keys;
+	LocalVector<int> values;
+	for (int i = 0; i < p_count; i++) {
+		keys.push_back(i * 2);
+		values.push_back(-i);
+		reference.insert(i * 2, -i);
+	}
+	map.bulk_load(keys.ptr(), values.ptr(), p_count);
+	set.bulk_load(keys.ptr(), p_count);
+	if (!_b_tree_matches(map, set, reference, p_count)) {
+		return false;
+	}
+	for (int i = 0; i < p_count; i += 3) {
+		map.erase(i);
+		set.erase(i);
+		reference.erase(i);
+		map.insert(i + 1, i);
+		set.insert(i + 1);
+		reference.insert(i + 1, i);
+	}
+	return _b_tree_matches(map, set, reference, p_count + 1);
+}
+
+// Fills a queue up to its capacity and drains it, checking FIFO order and the full and empty cases.
+template <class Q>
+static bool _queue_fifo_matches(Q &p_queue) {
+	const int capacity = p_queue.get_capacity();
+	int value = 0;
+	for (int i = 0; i < capacity; i++) {
+		if (!p_queue.push(i)) {
+			return false;
+		}
+	}
+	if (p_queue.push(capacity) || p_queue.size() != (uint32_t)capacity) {
+		return false;
+	}
+	for (int i = 0; i < capacity; i++) {
+		if (!p_queue.pop(value) || value != i) {
+			return false;
+		}
+	}
+	if (p_queue.pop(value) || !p_queue.is_empty()) {
+		return false;
+	}
+
+	// Batches are cut to what fits, and wrap around the ring.
+	p_queue.push(0);
+	p_queue.pop(value);
+	int values[64];
+	for (int i = 0; i < 64; i++) {
+		values[i] = i;
+	}
+	if (p_queue.push_batch(values, 3) != 3 || p_queue.push_batch(values + 3, 64) != uint32_t(capacity - 3)) {
+		return false;
+	}
+	int popped[64];
+	return p_queue.pop_batch(popped, 64) == (uint32_t)capacity && popped[capacity - 1] == capacity - 1 && p_queue.is_empty();
+}
+
+bool Example::test_queues(int p_count) const {
+	SPSCQueue<int> spsc(5);
+	MPMCQueue<int> mpmc(5);
+	if (spsc.get_capacity() != 8 || mpmc.get_capacity() != 8 || !_queue_fifo_matches(spsc) || !_queue_fifo_matches(mpmc)) {
+		return false;
+	}
+
+	// One producer thread and one consumer thread, through a queue much smaller than the data.
+	bool in_order = true;
+	std::thread producer([&spsc, p_count]() {
+		for (int i = 0; i < p_count; i++) {
+			while (!spsc.push(i)) {
+				std::this_thread::yield();
+			}
+		}
+	});
+	for (int i = 0; i < p_count; i++) {
+		int value = 0;
+		while (!spsc.pop(value)) {
+			std::this_thread::yield();
+		}
+		in_order = in_order && value == i;
+	}
+	producer.join();
+	if (!in_order) {
+		return false;
+	}
+
+	// Several producers and consumers: nothing lost or duplicated, and every consumer
+	// sees the values of each producer in the order they were pushed.
+	const int threads = 4;
+	std::atomic<int64_t> sum = { 0 };
+	std::atomic<int> received = { 0 };
+	std::atomic<bool> ordered = { true };
+	std::thread workers[threads * 2];
+	for (int t = 0; t < threads; t++) {
+		workers[t * 2] = std::thread([&mpmc, p_count, t]() {
+			for (int i = 0; i < p_count; i++) {
+				while (!mpmc.push(i * threads + t)) {
+					std::this_thread::yield();
+				}
+			}
+		});
+		workers[t * 2 + 1] = std::thread([&, p_count]() {
+			int last[threads] = { -1, -1, -1, -1 };
+			while (received.load() < p_count * threads) {
+				int value = 0;
+				if (!mpmc.pop(value)) {
+					std::this_thread::yield();
+					continue;
+				}
+				if (value <= last[value % threads]) {
+					ordered = false;
+				}
+				last[value % threads] = value;
+				sum += value;
+				received++;
+			}
+		});
+	}
+	for (std::thread &worker : workers) {
+		worker.join();
+	}
+	const int64_t total = int64_t(p_count) * threads;
+	return ordered.load() && mpmc.is_empty() && sum.load() == total * (total - 1) / 2;
+}
+
+bool Example::test_rid_owner(int p_count) const {
+	// Small chunks, so the threads also race on allocating new ones while others look RIDs up.
+	RID_Owner<int64_t, true> owner(64, p_count * 4);
+	std::atomic<bool> valid = { true };
+	std::thread threads[4];
+	for (int t = 0; t < 4; t++) {
+		threads[t] = std::thread([&owner, &valid, p_count, t]() {
+			LocalVector<RID> rids;
+			for (int i = 0; i < p_count; i++) {
+				rids.push_back(owner.make_rid(int64_t(t) * p_count + i));
+			}
+			for (int i = 0; i < p_count; i++) {
+				const int64_t *value = owner.get_or_null(rids[i]);
+				if (!value || *value != int64_t(t) * p_count + i || !owner.owns(rids[i])) {
+					valid = false;
+				}
+			}
+			for (int i = 0; i < p_count; i++) {
+				owner.free(rids[i]);
+				if (owner.owns(rids[i]) || owner.get_or_null(rids[i])) {
+					valid = false;
+				}
+			}
+		});
+	}
+	for (std::thread &thread : threads) {
+		thread.join();
+	}
+	if (!valid.load() || owner.get_rid_count() != 0) {
+		return false;
+	}
+
+	// A freed slot is reused, with a new validator the stale RID doesn't match.
+	RID first = owner.make_rid(1);
+	owner.free(first);
+	RID second = owner.make_rid(2);
+	if ((first.get_id() & 0xFFFFFFFF) != (second.get_id() & 0xFFFFFFFF) || first == second || owner.owns(first) || owner.get_or_null(first) || *owner.get_or_null(second) != 2) {
+		return false;
+	}
+	owner.free(second);
+
+	// Allocating past the maximum number of elements fails with an error, and a null RID.
+	RID_Owner<int> limited(sizeof(int) * 4, 8);
+	RID limited_rids[8];
+	for (RID &rid : limited_rids) {
+		rid = limited.make_rid(0);
+	}
+	bool over_limit = limited.allocate_rid().is_valid();
+	for (const RID &rid : limited_rids) {
+		if (!limited.owns(rid)) {
+			return false;
+		}
+		limited.free(rid);
+	}
+	return !over_limit && limited.get_rid_count() == 0;
+}
+
+bool Example::test_spin_locks(int p_count) const {
+	SpinLock lock;
+	RWSpinLock rw_lock;
+	if (!lock.try_lock() || lock.try_lock()) {
+		return false;
+	}
+	lock.unlock();
+	// Readers share the lock, a writer excludes everyone.
+	if (!rw_lock.try_read_lock() || !rw_lock.try_read_lock() || rw_lock.try_write_lock()) {
+		return false;
+	}
+	rw_lock.read_unlock();
+	rw_lock.read_unlock();
+	if (!rw_lock.try_write_lock() || rw_lock.try_read_lock() || rw_lock.try_write_lock()) {
+		return false;
+	}
+	rw_lock.write_unlock();
+
+	// Non-atomic counters only add up if the locks really exclude each other.
+	int64_t counter = 0;
+	int64_t pair[2] = { 0, 0 };
+	std::atomic<bool> torn = { false };
+	std::thread threads[4];
+	for (int t = 0; t < 4; t++) {
+		threads[t] = std::thread([&, t]() {
+			for (int i = 0; i < p_count; i++) {
+				lock.lock();
+				counter++;
+				lock.unlock();
+
+				if (t % 2 == 0) {
+					RWSpinLockWrite write(rw_lock);
+					pair[0]++;
+					pair[1]++;
+				} else {
+					RWSpinLockRead read(rw_lock);
+					if (pair[0] != pair[1]) {
+						torn = true;
+					}
+				}
+			}
+		});
+	}
+	for (std::thread &thread : threads) {
+		thread.join();
+	}
+	return counter == int64_t(p_count) * 4 && pair[0] == int64_t(p_count) * 2 && !torn.load();
+}
+
+bool Example::test_hash_stream() const {
+	uint8_t data[1000];
+	for (int i = 0; i < 1000; i++) {
+		data[i] = (uint8_t)hash_murmur3_one_32(i);
+	}
+
+	// Lengths around the small input cases and the 48 byte blocks, fed in pieces that
+	// land inside, on and across block boundaries.
+	const int lengths[] = { 0, 1, 3, 4, 8, 15, 16, 17, 47, 48, 49, 95, 96, 97, 143, 144, 1000 };
+	const int pieces[] = { 1, 5, 16, 47, 48, 49, 1000 };
+	for (int length : lengths) {
+		const uint64_t expected = hash_wyhash_buffer(data, length);
+		for (int piece : pieces) {
+			HashStream64 stream;
+			for (int offset = 0; offset < length; offset += piece) {
+				stream.update(data + offset, MIN(piece, length - offset));
+			}
+			if (stream.digest() != expected) {
+				return false;
+			}
+		}
+
+		// A different seed changes the digest, reset() goes back to the initial state.
+		HashStream64 seeded(12345);
+		seeded.update(data, length);
+		if (seeded.digest() != hash_wyhash_buffer(data, length, 12345) || seeded.digest() == expected) {
+			return false;
+		}
+		seeded.reset();
+		seeded.update(data, length);
+		if (seeded.digest() != expected) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Bisection point found by scanning the whole array, as a reference.
+template <class T>
+static int _linear_bisect(const T *p_array, int p_len, const T &p_value, bool p_before) {
+	int i = 0;
+	while (i < p_len && (p_before ? p_array[i] < p_value : !(p_value < p_array[i]))) {
+		i++;
+	}
+	return i;
+}
+
+template <class T>
+static bool _search_array_matches(int p_len) {
+	// Pairs of equal values, probed with every value in and around the range.
+	LocalVector<T> values;
+	for (int i = 0; i < p_len; i++) {
+		values.push_back(T(i / 2 * 2));
+	}
+	SearchArray<T> search;
+	EytzingerArray<T> eytzinger(values.ptr(), p_len);
+	if (eytzinger.size() != p_len) {
+		return false;
+	}
+	for (int probe = -1; probe <= p_len + 1; probe++) {
+		for (bool before : { true, false }) {
+			int expected = _linear_bisect(values.ptr(), p_len, T(probe), before);
+			if (search.bisect(values.ptr(), p_len, T(probe), before) != expected || eytzinger.bisect(T(probe), before) != expected) {
+				return false;
+			}
+		}
+		int first = search.bisect(values.ptr(), p_len, T(probe), true);
+		if (eytzinger.find(T(probe)) != (first < p_len && values[first] == T(probe) ? first : -1)) {
+			return false;
+		}
+	}
+
+	// Distinct even values, so odd probes are missing.
+	VSet<T> set;
+	VMap<T, int> map;
+	LocalVector<T> keys;
+	for (int i = 0; i < p_len; i++) {
+		set.insert(T(i * 2));
+		map.insert(T(i * 2), i);
+		keys.push_back(T(i * 2));
+	}
+	for (int probe = -1; probe <= p_len * 2; probe++) {
+		int nearest = _linear_bisect(keys.ptr(), p_len, T(probe), true);
+		int expected = nearest < p_len && keys[nearest] == T(probe) ? nearest : -1;
+		if (set.find(T(probe)) != expected || map.find(T(probe)) != expected || map.find_nearest(T(probe)) != nearest) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool Example::test_search_array() const {
+	// Sizes around the SIMD scan threshold, and large enough for prefetching.
+	for (int len = 0; len <= SEARCH_ARRAY_LINEAR_THRESHOLD * 3; len++) {
+		if (!_search_array_matches<int32_t>(len) || !_search_array_matches<float>(len) || !_search_array_matches<int64_t>(len)) {
+			return false;
+		}
+	}
+	// Full Eytzinger trees and one element either side of them, where the last level is empty or complete.
+	for (int len : { 127, 128, 129, 1000, 1023, 1024, 1025 }) {
+		if (!_search_array_matches<int32_t>(len) || !_search_array_matches<float>(len) || !_search_array_matches<int64_t>(len)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool Example::test_slot_map(int p_count) const {
+	SlotMap<int> slot_map;
+	LocalVector<SlotMapHandle> live;
+	LocalVector<SlotMapHandle> erased;
+	for (int i = 0; i < p_count; i++) {
+		uint32_t r = hash_murmur3_one_32(i);
+		if (live.is_empty() || r % 3 != 0) {
+			SlotMapHandle handle = slot_map.insert(i);
+			if (slot_map.get(handle) != i) {
+				return false;
+			}
+			live.push_back(handle);
+		} else {
+			// Erasing moves the last element, the other handles must follow it.
+			uint32_t index = (r >> 8) % live.size();
+			if (!slot_map.erase(live[index]) || slot_map.erase(live[index])) {
+				return false;
+			}
+			erased.push_back(live[index]);
+			live.remove_at_unordered(index);
+		}
+	}
+	if (slot_map.size() != live.size()) {
+		return false;
+	}
+	for (const SlotMapHandle &handle : live) {
+		if (!slot_map.has(handle) || slot_map.get_handle(slot_map.get_index(handle)) != handle) {
+			return false;
+		}
+	}
+	// Slots of erased elements have been reused, yet their handles never match again.
+	for (const SlotMapHandle &handle : erased) {
+		if (slot_map.has(handle) || slot_map.get_or_null(handle) != nullptr || slot_map.get_index(handle) != -1) {
+			return false;
+		}
+	}
+	if (slot_map.has(SlotMapHandle()) || slot_map.has(SlotMapHandle(slot_map.size() + p_count, 1))) {
+		return false;
+	}
+	slot_map.clear();
+	for (const SlotMapHandle &handle : live) {
+		if (slot_map.has(handle)) {
+			return false;
+		}
+	}
+	SlotMapHandle reused = slot_map.insert(-1);
+	return slot_map.size() == 1 && slot_map.get(reused) == -1 && !slot_map.has(live.is_empty() ? SlotMapHandle() : live[0]);
+}
+
+// Work methods for the WorkStealingPool test and benchmark.
+struct WorkStealingTestJob {
+	WorkStealingPool *pool = nullptr;
+	std::atomic<uint32_t> *hits = nullptr;
+	std::atomic<int64_t> sum = { 0 };
+
+	void hit(uint32_t p_index, uint32_t p_offset) {
+		hits[p_offset + p_index].fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void add(uint32_t p_index, uint32_t p_base) {
+		sum.fetch_add(p_base + p_index, std::memory_order_relaxed);
+	}
+
+	// Each element starts a job of its own on the same pool.
+	void nest(uint32_t p_index, uint32_t p_count) {
+		pool->do_work(p_count, this, &WorkStealingTestJob::add, p_index * p_count);
+	}
+
+	// Costs p_rounds + p_index hashes, so the last elements take far longer than the first ones.
+	void hash(uint32_t p_index, uint32_t p_rounds) {
+		uint32_t h = p_index;
+		for (uint32_t i = 0; i < p_rounds + p_index; i++) {
+			h = hash_murmur3_one_32(h);
+		}
+		sum.fetch_add(h & 1, std::memory_order_relaxed);
+	}
+};
+
+bool Example::test_work_stealing(int p_count) const {
+	// The owner pushes and pops at the bottom of a small deque, so it grows, while thieves steal
+	// from the top: every value must be taken exactly once.
+	{
+		WorkStealingDeque<uint32_t> deque(16);
+		std::atomic<int> taken = { 0 };
+		std::atomic<uint64_t> checksum = { 0 };
+		auto take = [&](uint32_t p_value) {
+			checksum += hash_murmur3_one_32(p_value);
+			taken++;
+		};
+		std::thread thieves[3];
+		for (std::thread &thief : thieves) {
+			thief = std::thread([&, p_count]() {
+				while (taken.load() < p_count) {
+					uint32_t value = 0;
+					if (deque.steal(value)) {
+						take(value);
+					} else {
+						std::this_thread::yield();
+					}
+				}
+			});
+		}
+		for (int i = 0; i < p_count; i++) {
+			deque.push(i);
+			uint32_t value = 0;
+			if (i % 4 == 0 && deque.pop(value)) {
+				take(value);
+			}
+		}
+		uint32_t value = 0;
+		while (deque.pop(value)) {
+			take(value);
+		}
+		for (std::thread &thief : thieves) {
+			thief.join();
+		}
+		uint64_t expected = 0;
+		for (int i = 0; i < p_count; i++) {
+			expected += hash_murmur3_one_32(i);
+		}
+		if (taken.load() != p_count || checksum.load() != expected || !deque.is_empty()) {
+			return false;
+		}
+	}
+
+	WorkStealingPool pool;
+	pool.init(4);
+	const int callers = 4;
+	std::atomic<uint32_t> *hits = memnew_arr(std::atomic<uint32_t>, p_count * callers);
+	for (int i = 0; i < p_count * callers; i++) {
+		hits[i].store(0);
+	}
+	WorkStealingTestJob jobs[callers];
+
+	// Several threads outside the pool run jobs at once, split down to single elements,
+	// each with a nested job per element.
+	std::thread threads[callers];
+	for (int t = 0; t < callers; t++) {
+		threads[t] = std::thread([&, t, p_count]() {
+			jobs[t].pool = &pool;
+			jobs[t].hits = hits;
+			pool.do_work(p_count, &jobs[t], &WorkStealingTestJob::hit, uint32_t(t * p_count), 1);
+			pool.do_work(64, &jobs[t], &WorkStealingTestJob::nest, uint32_t(p_count / 64));
+		});
+	}
+	for (std::thread &thread : threads) {
+		thread.join();
+	}
+	pool.finish();
+
+	bool valid = true;
+	for (int i = 0; i < p_count * callers; i++) {
+		valid = valid && hits[i].load() == 1;
+	}
+	memdelete_arr(hits);
+	const int64_t nested = int64_t(p_count / 64) * 64;
+	for (const WorkStealingTestJob &job : jobs) {
+		valid = valid && job.sum.load() == nested * (nested - 1) / 2;
+	}
+	return valid;
+}
+
+bool Example::test_cpu_topology() const {
+	const CPUTopology &topology = CPUTopology::get_singleton();
+	const uint32_t cpu_count = topology.get_cpu_count();
+	if (cpu_count == 0 || topology.get_core_count() == 0 || topology.get_core_count() > cpu_count || topology.get_l3_group_count() == 0 || topology.get_l3_group_count() > topology.get_core_count() || topology.get_package_count() == 0 || topology.get_package_count() > topology.get_core_count()) {
+		return false;
+	}
+
+	auto reset_counts = [](LocalVector<uint32_t> &r_counts, uint32_t p_size) {
+		r_counts.resize(p_size);
+		for (uint32_t &count : r_counts) {
+			count = 0;
+		}
+	};
+
+	// Every CPU has a distinct id, and every core and L3 group has at least one CPU.
+	uint32_t max_id = 0;
+	LocalVector<uint32_t> cpus_per_core;
+	LocalVector<uint32_t> cpus_per_l3_group;
+	reset_counts(cpus_per_core, topology.get_core_count());
+	reset_counts(cpus_per_l3_group, topology.get_l3_group_count());
+	for (uint32_t i = 0; i < cpu_count; i++) {
+		const CPUTopology::CPU &cpu = topology.get_cpu(i);
+		if (cpu.core >= topology.get_core_count() || cpu.l3_group >= topology.get_l3_group_count() || cpu.package >= topology.get_package_count()) {
+			return false;
+		}
+		cpus_per_core[cpu.core]++;
+		cpus_per_l3_group[cpu.l3_group]++;
+		max_id = MAX(max_id, cpu.id);
+	}
+	LocalVector<uint32_t> seen;
+	reset_counts(seen, max_id + 1);
+	for (uint32_t i = 0; i < cpu_count; i++) {
+		const CPUTopology::CPU &cpu = topology.get_cpu(i);
+		if (seen[cpu.id]++ != 0 || cpu.smt_index >= cpus_per_core[cpu.core]) {
+			return false;
+		}
+	}
+	for (uint32_t count : cpus_per_core) {
+		if (count == 0) {
+			return false;
+		}
+	}
+	for (uint32_t count : cpus_per_l3_group) {
+		if (count == 0) {
+			return false;
+		}
+	}
+
+	// Compact and scatter hand out every CPU once per round, and scatter puts the first threads
+	// on distinct cores.
+	LocalVector<uint32_t> index_of_id;
+	index_of_id.resize(max_id + 1);
+	for (uint32_t i = 0; i < cpu_count; i++) {
+		index_of_id[topology.get_cpu(i).id] = i;
+	}
+	LocalVector<uint32_t> thread_cpus;
+	for (CPUTopology::Placement placement : { CPUTopology::PLACEMENT_COMPACT, CPUTopology::PLACEMENT_SCATTER }) {
+		reset_counts(seen, max_id + 1);
+		reset_counts(cpus_per_core, topology.get_core_count());
+		for (uint32_t thread = 0; thread < cpu_count; thread++) {
+			topology.get_thread_cpus(placement, thread, thread_cpus);
+			if (thread_cpus.size() != 1 || thread_cpus[0] > max_id || seen[thread_cpus[0]]++ != 0) {
+				return false;
+			}
+			const uint32_t core = topology.get_cpu(index_of_id[thread_cpus[0]]).core;
+			if (placement == CPUTopology::PLACEMENT_SCATTER && thread < topology.get_core_count() && cpus_per_core[core]++ != 0) {
+				return false;
+			}
+		}
+	}
+
+	// Each L3 group thread may run on exactly the CPUs of its group.
+	for (uint32_t thread = 0; thread < topology.get_l3_group_count(); thread++) {
+		topology.get_thread_cpus(CPUTopology::PLACEMENT_L3_GROUPS, thread, thread_cpus);
+		if (thread_cpus.size() != cpus_per_l3_group[thread]) {
+			return false;
+		}
+		for (uint32_t id : thread_cpus) {
+			if (id > max_id || !seen[id] || topology.get_cpu(index_of_id[id]).l3_group != thread) {
+				return false;
+			}
+		}
+	}
+	topology.get_thread_cpus(CPUTopology::PLACEMENT_NONE, 0, thread_cpus);
+	return thread_cpus.is_empty();
+}
+
+// Work method for the ThreadWorkPool scratch test, recording what each item allocated.
+struct ThreadScratchTestJob {
+	struct Item {
+		ScratchArena *arena = nullptr;
+		const uint8_t *data = nullptr;
+	};
+	Item *items = nullptr;
+
+	void run(uint32_t p_index, uint32_t p_size) {
+		ScratchArena &arena = ThreadWorkPool::get_thread_scratch();
+		uint32_t *values = arena.alloc_array<uint32_t>(p_size);
+		for (uint32_t i = 0; i < p_size; i++) {
+			values[i] = p_index + i;
+		}
+		items[p_index] = { &arena, (const uint8_t *)values };
+	}
+};
+
+bool Example::test_thread_scratch(int p_count) const {
+	ThreadWorkPool pool;
+	pool.init(4);
+	LocalVector<ThreadScratchTestJob::Item> items;
+	items.resize(p_count);
+	ThreadScratchTestJob job;
+	job.items = items.ptr();
+
+	// Allocations fit in one block, so each arena must be back to its first allocation of the
+	// round once end_work() returned. The second round reuses the reset arenas.
+	bool valid = true;
+	for (int round = 0; round < 2; round++) {
+		pool.do_work(p_count, &job, &ThreadScratchTestJob::run, 16u);
+		for (int i = 0; i < p_count; i++) {
+			const uint8_t *first = items[i].data;
+			for (int j = 0; j < p_count; j++) {
+				if (items[j].arena == items[i].arena && items[j].data < first) {
+					first = items[j].data;
+				}
+			}
+			valid = valid && items[i].arena->get_marker().position == first;
+		}
+	}
+
+	// A single chunk runs on the calling thread, with the caller arena of the pool.
+	for (int round = 0; round < 2; round++) {
+		ThreadScratchTestJob::Item caller;
+		parallel_for(0, p_count, p_count, [&](uint32_t p_begin, uint32_t p_end) {
+			ScratchArena &arena = ThreadWorkPool::get_thread_scratch();
+			caller = { &arena, (const uint8_t *)arena.alloc_array<uint32_t>(p_end - p_begin) };
+		}, &pool);
+		valid = valid && caller.arena->get_marker().position == caller.data;
+	}
+
+	pool.finish();
+	return valid;
+}
+
+// The scalar formulas the SIMD kernels replace, written out so that they stay scalar in every
+// build. Results must match them bit for bit.
+static Vector3 _scalar_cross(const Vector3 &p_a, const Vector3 &p_b) {
+	return Vector3((p_a.y * p_b.z) - (p_a.z * p_b.y), (p_a.z * p_b.x) - (p_a.x * p_b.z), (p_a.x * p_b.y) - (p_a.y * p_b.x));
+}
+
+static Vector3 _scalar_normalized(const Vector3 &p_v) {
+	const real_t lengthsq = p_v.x * p_v.x + p_v.y * p_v.y + p_v.z * p_v.z;
+	if (lengthsq == 0) {
+		return Vector3(0, 0, 0);
+	}
+	const real_t length = Math::sqrt(lengthsq);
+	return Vector3(p_v.x / length, p_v.y / length, p_v.z / length);
+}
+
+static Vector4 _scalar_normalized(const Vector4 &p_v) {
+	const real_t lengthsq = p_v.x * p_v.x + p_v.y * p_v.y + p_v.z * p_v.z + p_v.w * p_v.w;
+	if (lengthsq == 0) {
+		return Vector4(0, 0, 0, 0);
+	}
+	const real_t length = Math::sqrt(lengthsq);
+	return Vector4(p_v.x / length, p_v.y / length, p_v.z / length, p_v.w / length);
+}
+
+static Quaternion _scalar_multiply(const Quaternion &p_a, const Quaternion &p_b) {
+	return Quaternion(
+			p_a.w * p_b.x + p_a.x * p_b.w + p_a.y * p_b.z - p_a.z * p_b.y,
+			p_a.w * p_b.y + p_a.y * p_b.w + p_a.z * p_b.x - p_a.x * p_b.z,
+			p_a.w * p_b.z + p_a.z * p_b.w + p_a.x * p_b.y - p_a.y * p_b.x,
+			p_a.w * p_b.w - p_a.x * p_b.x - p_a.y * p_b.y - p_a.z * p_b.z);
+}
+
+template <class T>
+static bool _same_bits(const T &p_a, const T &p_b) {
+	return memcmp(&p_a, &p_b, sizeof(T)) == 0;
+}
+
+static bool _simd_math_matches(const Vector3 &p_a, const Vector3 &p_b, const Vector4 &p_c, const Vector4 &p_d, real_t p_weight) {
+	const Vector3 v3_min(MIN(p_a.x, p_b.x), MIN(p_a.y, p_b.y), MIN(p_a.z, p_b.z));
+	const Vector3 v3_max(MAX(p_a.x, p_b.x), MAX(p_a.y, p_b.y), MAX(p_a.z, p_b.z));
+	const Vector3 v3_lerp(p_a.x + (p_weight * (p_b.x - p_a.x)), p_a.y + (p_weight * (p_b.y - p_a.y)), p_a.z + (p_weight * (p_b.z - p_a.z)));
+	const real_t v3_dot = p_a.x * p_b.x + p_a.y * p_b.y + p_a.z * p_b.z;
+	const real_t v3_length_squared = p_a.x * p_a.x + p_a.y * p_a.y + p_a.z * p_a.z;
+	if (!_same_bits(p_a.min(p_b), v3_min) || !_same_bits(p_a.max(p_b), v3_max) || !_same_bits(p_a.lerp(p_b, p_weight), v3_lerp) ||
+			!_same_bits(p_a.dot(p_b), v3_dot) || !_same_bits(p_a.cross(p_b), _scalar_cross(p_a, p_b)) ||
+			!_same_bits(p_a.length_squared(), v3_length_squared) || !_same_bits(p_a.length(), Math::sqrt(v3_length_squared)) ||
+			!_same_bits(p_a.normalized(), _scalar_normalized(p_a)) ||
+			!_same_bits(p_a.floor(), Vector3(Math::floor(p_a.x), Math::floor(p_a.y), Math::floor(p_a.z))) ||
+			!_same_bits(p_a.ceil(), Vector3(Math::ceil(p_a.x), Math::ceil(p_a.y), Math::ceil(p_a.z)))) {
+		return false;
+	}
+
+	const Vector4 v4_min(MIN(p_c.x, p_d.x), MIN(p_c.y, p_d.y), MIN(p_c.z, p_d.z), MIN(p_c.w, p_d.w));
+	const Vector4 v4_max(MAX(p_c.x, p_d.x), MAX(p_c.y, p_d.y), MAX(p_c.z, p_d.z), MAX(p_c.w, p_d.w));
+	const Vector4 v4_lerp(p_c.x + (p_weight * (p_d.x - p_c.x)), p_c.y + (p_weight * (p_d.y - p_c.y)), p_c.z + (p_weight * (p_d.z - p_c.z)), p_c.w + (p_weight * (p_d.w - p_c.w)));
+	const real_t v4_dot = p_c.x * p_d.x + p_c.y * p_d.y + p_c.z * p_d.z + p_c.w * p_d.w;
+	if (!_same_bits(p_c.min(p_d), v4_min) || !_same_bits(p_c.max(p_d), v4_max) || !_same_bits(p_c.lerp(p_d, p_weight), v4_lerp) ||
+			!_same_bits(p_c.dot(p_d), v4_dot) || !_same_bits(p_c.normalized(), _scalar_normalized(p_c)) ||
+			!_same_bits(p_c.floor(), Vector4(Math::floor(p_c.x), Math::floor(p_c.y), Math::floor(p_c.z), Math::floor(p_c.w))) ||
+			!_same_bits(p_c.ceil(), Vector4(Math::ceil(p_c.x), Math::ceil(p_c.y), Math::ceil(p_c.z), Math::ceil(p_c.w)))) {
+		return false;
+	}
+
+	const Quaternion qa(p_c.x, p_c.y, p_c.z, p_c.w);
+	const Quaternion qb(p_d.x, p_d.y, p_d.z, p_d.w);
+	if (!_same_bits(qa.dot(qb), v4_dot) || !_same_bits(qa * qb, _scalar_multiply(qa, qb))) {
+		return false;
+	}
+
+	// xform() expects a unit quaternion.
+	const real_t length = Math::sqrt(p_c.x * p_c.x + p_c.y * p_c.y + p_c.z * p_c.z + p_c.w * p_c.w);
+	const Quaternion unit(p_c.x / length, p_c.y / length, p_c.z / length, p_c.w / length);
+	if (!unit.is_normalized()) {
+		return true;
+	}
+	const Vector3 u(unit.x, unit.y, unit.z);
+	const Vector3 uv = _scalar_cross(u, p_b);
+	return _same_bits(unit.xform(p_b), p_b + ((uv * unit.w) + _scalar_cross(u, uv)) * ((real_t)2));
+}
+
+bool Example::test_simd_math(int p_count) const {
+	const real_t nan = NAN;
+	const real_t inf = INFINITY;
+
+	// Zero vectors normalize to (positive) zero, and MIN/MAX pick their second operand when
+	// either is NaN, whichever side it is on.
+	const Vector3 zero3(0, 0, 0);
+	const Vector4 zero4(0, 0, 0, 0);
+	if (!_simd_math_matches(zero3, zero3, zero4, zero4, 0.5) || !_simd_math_matches(Vector3(-0.0, 0, -0.0), zero3, Vector4(-0.0, -0.0, 0, -0.0), zero4, 0.5) ||
+			!_simd_math_matches(Vector3(nan, 1, -inf), Vector3(2, nan, 3), Vector4(nan, 1, nan, -2), Vector4(0, nan, nan, inf), 0.25) ||
+			!_simd_math_matches(Vector3(1, -0.0, 0), Vector3(nan, 0, -0.0), Vector4(inf, -inf, 0, -0.0), Vector4(-inf, inf, -0.0, 0), 1)) {
+		return false;
+	}
+
+	// Pseudo-random values over a wide range of magnitudes, with some special ones mixed in.
+	const real_t specials[] = { 0, -0.0, 1, -1, 0.5, -2.5, 1e-30f, 3e38f, -3e38f, inf, -inf, nan };
+	const uint32_t special_count = sizeof(specials) / sizeof(specials[0]);
+	uint32_t seed = 0;
+	auto value = [&]() {
+		const uint32_t h = hash_murmur3_one_32(seed++);
+		if (h % 16 == 0) {
+			return specials[(h >> 4) % special_count];
+		}
+		return real_t(int32_t(h)) / real_t(1u << (h % 31));
+	};
+	for (int i = 0; i < p_count; i++) {
+		const Vector3 a(value(), value(), value());
+		const Vector3 b(value(), value(), value());
+		const Vector4 c(value(), value(), value(), value());
+		const Vector4 d(value(), value(), value(), value());
+		if (!_simd_math_matches(a, b, c, d, real_t(hash_murmur3_one_32(seed++) % 1024) / 1024)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+PackedInt32Array Example::test_radix_sort(PackedInt32Array p_array) const {
+	RadixSort<int32_t> sorter;
+	sorter.sort_array(p_array);
+	return p_array;
+}
+
+// Sorts with RadixSort, through the pointer, LocalVector and Vector overloads, and with SortArray,
+// which must agree.
+template <class T>
+static bool _radix_sort_matches(const LocalVector<T> &p_values) {
+	LocalVector<T> expected = p_values;
+	SortArray<T>().sort(expected.ptr(), expected.size());
+
+	LocalVector<T> sorted = p_values;
+	RadixSort<T>().sort(sorted);
+	LocalVector<T> scratch;
+	scratch.resize(p_values.size());
+	LocalVector<T> sorted_with_scratch = p_values;
+	RadixSort<T>().sort(sorted_with_scratch.ptr(), scratch.ptr(), sorted_with_scratch.size());
+	Vector<T> vector;
+	for (const T &value : p_values) {
+		vector.push_back(value);
+	}
+	RadixSort<T>().sort_array(vector);
+
+	for (uint32_t i = 0; i < expected.size(); i++) {
+		if (sorted[i] != expected[i] || sorted_with_scratch[i] != expected[i] || vector[i] != expected[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Pseudo-random bit patterns, skipping the NaNs, which RadixSort orders by their bits but SortArray doesn't order at all.
+static float _radix_sort_float(uint32_t p_seed) {
+	uint32_t bits = hash_murmur3_one_32(p_seed);
+	float value;
+	memcpy(&value, &bits, sizeof(value));
+	return Math::is_nan(value) ? float(p_seed) : value;
+}
+
+static double _radix_sort_double(uint32_t p_seed) {
+	uint64_t bits = (uint64_t(hash_murmur3_one_32(p_seed)) << 32) | hash_murmur3_one_32(p_seed + 1);
+	double value;
+	memcpy(&value, &bits, sizeof(value));
+	return Math::is_nan(value) ? double(p_seed) : value;
+}
+
+struct RadixSortTestParticle {
+	float depth = 0;
+	uint32_t id = 0;
+};
+
+struct RadixSortTestParticleDepth {
+	typedef uint32_t Key;
+	_FORCE_INLINE_ Key operator()(const RadixSortTestParticle &p_particle) const { return radix_sort_key_float(p_particle.depth); }
+};
+
+bool Example::test_radix_sort_matches(int p_count) const {
+	// Full range keys of every width, and small positive ones where only one or three passes
+	// run, so the result ends up in the scratch buffer and is copied back.
+	LocalVector<int32_t> int32s;
+	LocalVector<int32_t> bytes;
+	LocalVector<int32_t> three_bytes;
+	LocalVector<int64_t> int64s;
+	LocalVector<uint64_t> uint64s;
+	LocalVector<int16_t> int16s;
+	LocalVector<float> floats;
+	LocalVector<double> doubles;
+	for (int i = 0; i < p_count; i++) {
+		uint32_t h = hash_murmur3_one_32(i);
+		int32s.push_back(int32_t(h));
+		bytes.push_back(int32_t(h & 0xFF));
+		three_bytes.push_back(int32_t(h & 0xFFFFFF));
+		int64s.push_back(int64_t((uint64_t(h) << 32) | hash_murmur3_one_32(h)));
+		uint64s.push_back((uint64_t(hash_murmur3_one_32(h)) << 32) | h);
+		int16s.push_back(int16_t(h));
+		floats.push_back(_radix_sort_float(i));
+		doubles.push_back(_radix_sort_double(i));
+	}
+	if (!_radix_sort_matches(int32s) || !_radix_sort_matches(bytes) || !_radix_sort_matches(three_bytes) ||
+			!_radix_sort_matches(int64s) || !_radix_sort_matches(uint64s) || !_radix_sort_matches(int16s) ||
+			!_radix_sort_matches(floats) || !_radix_sort_matches(doubles)) {
+		return false;
+	}
+
+	// Infinities and both zeros, which compare equal but are ordered -0.0 first.
+	float specials[] = { INFINITY, 0.0f, -1.5f, -0.0f, -INFINITY, 1.5f, -0.0f, 0.0f };
+	float specials_sorted[] = { -INFINITY, -1.5f, -0.0f, -0.0f, 0.0f, 0.0f, 1.5f, INFINITY };
+	RadixSort<float>().sort(specials, std::size(specials));
+	if (memcmp(specials, specials_sorted, sizeof(specials)) != 0) {
+		return false;
+	}
+	double double_specials[] = { -0.0, INFINITY, -INFINITY, 0.0, -2.0 };
+	double double_specials_sorted[] = { -INFINITY, -2.0, -0.0, 0.0, INFINITY };
+	RadixSort<double>().sort(double_specials, std::size(double_specials));
+	if (memcmp(double_specials, double_specials_sorted, sizeof(double_specials)) != 0) {
+		return false;
+	}
+
+	// Keys with many duplicates and their original positions as values: the sort must be stable.
+	LocalVector<int32_t> keys;
+	LocalVector<uint32_t> positions;
+	for (int i = 0; i < p_count; i++) {
+		keys.push_back(int32_t(hash_murmur3_one_32(i) % 32) - 16);
+		positions.push_back(i);
+	}
+	LocalVector<int32_t> sorted_keys = keys;
+	RadixSort<int32_t>().sort_with_values(sorted_keys.ptr(), positions.ptr(), sorted_keys.size());
+	for (uint32_t i = 0; i < sorted_keys.size(); i++) {
+		if (keys[positions[i]] != sorted_keys[i]) {
+			return false;
+		}
+		if (i > 0 && (sorted_keys[i - 1] > sorted_keys[i] || (sorted_keys[i - 1] == sorted_keys[i] && positions[i - 1] > positions[i]))) {
+			return false;
+		}
+	}
+
+	// A custom key extractor, sorting structs by one member, also stably.
+	LocalVector<RadixSortTestParticle> particles;
+	for (int i = 0; i < p_count; i++) {
+		particles.push_back({ float(int(hash_murmur3_one_32(i) % 64) - 32) * 0.25f, uint32_t(i) });
+	}
+	RadixSort<RadixSortTestParticle, RadixSortTestParticleDepth>().sort(particles);
+	for (uint32_t i = 1; i < particles.size(); i++) {
+		const RadixSortTestParticle &a = particles[i - 1];
+		const RadixSortTestParticle &b = particles[i];
+		if (a.depth > b.depth || (a.depth == b.depth && a.id > b.id)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+PackedByteArray Example::test_bit_vector(const PackedByteArray &p_bytes) const {
+	BitVector bits;
+	bits.from_packed_byte_array(p_bytes);
+	BitVector inverted = ~bits;
+	if (bits.intersects(inverted) || (bits | inverted).count() != bits.size()) {
+		return PackedByteArray();
+	}
+	return inverted.to_packed_byte_array();
+}
+
+String Example::test_frozen_hash_table(const String &p_key) const {
+	FrozenHashTableBuilder builder;
+	builder.add(String("sword"), String("Sharp"));
+	builder.add(String("shield"), String("Sturdy"));
+	builder.add(String("sword"), String("Very sharp"));
+	for (int32_t i = 0; i < 1000; i++) {
+		builder.add(i, i * 3);
+	}
+	const String path = "user://test_frozen_hash_table.bin";
+	if (builder.save(path) != OK) {
+		return "save failed";
+	}
+
+	FrozenHashTableFile file;
+	if (file.open(path) != OK) {
+		return "open failed";
+	}
+	const FrozenHashTable &table = file.get_table();
+	int32_t value = 0;
+	if (table.size() != 1002 || !table.lookup(999, value) || value != 2997 || table.has(1000)) {
+		return "lookup failed";
+	}
+	String result;
+	if (!table.lookup(p_key, result)) {
+		return "not found";
+	}
+	return result;
+}
+
+int64_t Example::test_parallel_reduce(int p_count) const {
+	// Squares written by parallel_for(), summed by parallel_reduce(), both on the engine WorkerThreadPool.
+	LocalVector<int64_t> squares;
+	squares.resize(p_count);
+	parallel_for(0, p_count, 0, [&squares](uint32_t i) { squares[i] = int64_t(i) * i; });
+	auto sum_range = [&squares](uint32_t p_begin, uint32_t p_end) {
+		int64_t sum = 0;
+		for (uint32_t i = p_begin; i < p_end; i++) {
+			sum += squares[i];
+		}
+		return sum;
+	};
+	auto add = [](int64_t p_a, int64_t p_b) { return p_a + p_b; };
+	return parallel_reduce(0, p_count, 64, int64_t(0), sum_range, add);
+}
+
+int Example::test_worker_tasks(int p_value) const {
+	TaskFuture<int> doubled = WorkerTasks::submit([p_value]() { return p_value * 2; }).then([](int &p_result) { return p_result + 1; });
+
+	std::atomic<int> sum = { 0 };
+	TaskGroup group;
+	for (int i = 1; i <= 4; i++) {
+		group.add([&sum, i]() { sum += i; });
+	}
+	TaskFuture<int> total = group.then([&sum]() { return sum.load(); });
+
+	return doubled.get() + total.get();
+}
+
+int64_t Example::test_task_graph(int p_count) const {
+	// Squares and cubes are computed in parallel, then summed, and the graph runs twice.
+	// Every chunk of the "doubles" node waits for a parallel_for() of its own on the engine pool,
+	// which must not be starved by the graph runners.
+	LocalVector<int64_t> squares;
+	LocalVector<int64_t> cubes;
+	LocalVector<int64_t> doubles;
+	const uint32_t double_rows = 8;
+	int64_t sum = 0;
+
+	TaskGraph graph;
+	TaskGraph::NodeID setup = graph.add_node("setup", [&]() {
+		squares.resize(p_count);
+		cubes.resize(p_count);
+		doubles.resize(double_rows * p_count);
+		sum = 0;
+	});
+	TaskGraph::NodeID square = graph.add_parallel_node("square", p_count, 16, [&](uint32_t i) { squares[i] = int64_t(i) * i; });
+	TaskGraph::NodeID cube = graph.add_parallel_node("cube", p_count, 16, [&](uint32_t i) { cubes[i] = int64_t(i) * i * i; });
+	TaskGraph::NodeID doubled = graph.add_parallel_node("doubles", double_rows, 1, [&](uint32_t row) {
+		parallel_for(0, p_count, 1, [&](uint32_t i) { doubles[row * p_count + i] = int64_t(i) * 2; });
+	});
+	TaskGraph::NodeID total = graph.add_node("total", [&]() {
+		for (int i = 0; i < p_count; i++) {
+			sum += squares[i] + cubes[i];
+		}
+		for (int64_t value : doubles) {
+			sum += value;
+		}
+	});
+	graph.add_dependency(setup, square);
+	graph.add_dependency(setup, cube);
+	graph.add_dependency(setup, doubled);
+	graph.add_dependency(square, total);
+	graph.add_dependency(cube, total);
+	graph.add_dependency(doubled, total);
+
+	graph.execute();
+	graph.execute();
+	return sum;
+}
+
+int64_t Example::test_scratch_arena(int p_count) const {
+	// Enough rounds to chain blocks, then reuse the coalesced block after reset().
+	ScratchArena arena;
+	int64_t sum = 0;
+	for (int round = 0; round < 3; round++) {
+		int64_t *values = arena.alloc_array<int64_t>(p_count);
+		for (int i = 0; i < p_count; i++) {
+			values[i] = i;
+		}
+		ScratchArena::Marker marker = arena.get_marker();
+		for (int i = 0; i < p_count; i++) {
+			int64_t *copy = arena.create<int64_t>(values[i]);
+			sum += *copy;
+		}
+		arena.rewind(marker);
+		arena.reset();
+	}
+	return sum;
+}
+
+String Example::test_command_buffer(int p_count) const {
+	// Commands recorded from worker threads, run here by flush().
+	Node *node = memnew(Node);
+	int64_t sum = 0;
+	EngineCommandBuffer commands;
+	GDExtensionMethodBindPtr set_name = EngineCommandBuffer::get_method_bind("Node", "set_name", 83702148);
+
+	parallel_for(0, p_count, 8, [&](uint32_t i) {
+		commands.push([&sum, i]() { sum += i; });
+		if (i == 0) {
+			commands.push_ptrcall(node, set_name, String("Commands"));
+			commands.push_call(node, &Node::set_process_priority, 7);
+		}
+	});
+	commands.flush();
+
+	String result = String(node->get_name()) + ":" + itos(sum) + ":" + itos(node->get_process_priority());
+	memdelete(node);
+	return result;
+}
+
+Array Example::test_vector_math(const Vector3 &p_a, const Vector3 &p_b, const Quaternion &p_q, const Quaternion &p_r, const Vector4 &p_v, const Vector4 &p_u) const {
+	// Uses the SIMD code paths when they are enabled.
+	Array results;
+	results.push_back(p_a.dot(p_b));
+	results.push_back(p_a.cross(p_b));
+	results.push_back(p_a.normalized());
+	results.push_back(p_a.length());
+	results.push_back(p_a.lerp(p_b, 0.25));
+	results.push_back(p_a.min(p_b));
+	results.push_back(p_a.max(p_b));
+	results.push_back(p_a.floor());
+	results.push_back(p_q * p_r);
+	results.push_back(p_q.xform(p_b));
+	results.push_back(p_v.dot(p_u));
+	results.push_back(p_v.normalized());
+	results.push_back(p_v.lerp(p_u, 0.25));
+	results.push_back(p_v.min(p_u));
+	results.push_back(p_v.ceil());
+	return results;
+}
+
+PackedVector3Array Example::test_soa_math(const PackedVector3Array &p_positions, const PackedVector3Array &p_velocities, const Quaternion &p_rotation) const {
+	Vector3SoA positions;
+	Vector3SoA velocities;
+	positions.from_packed_array(p_positions);
+	velocities.from_packed_array(p_velocities);
+	positions.add_scaled(velocities, 0.5);
+	positions.rotate(p_rotation);
+
+	// Round trip through the MultiMesh buffer layout, then move the origins.
+	TransformSoA transforms;
+	transforms.resize(positions.size());
+	transforms.origin = positions;
+	TransformSoA copy;
+	copy.from_float32_array(transforms.to_float32_array());
+	copy.compose_parent(Transform3D(Basis(), Vector3(1, 2, 3)));
+
+	Vector3SoA origins;
+	origins.resize(copy.size());
+	copy.xform(origins);
+	return origins.to_packed_array();
+}
+
+// Keeps the timed work from being optimized away.
+static volatile int64_t benchmark_sink = 0;
+
+template <class F>
+static int64_t _time_usec(F p_function) {
+	uint64_t begin = Time::get_singleton()->get_ticks_usec();
+	benchmark_sink = benchmark_sink + p_function();
+	return Time::get_singleton()->get_ticks_usec() - begin;
+}
+
+Dictionary Example::run_benchmarks(int p_count) const {
+	Dictionary timings;
+
+	// FlatHashMap against HashMap.
+	{
+		HashMap<int, int> hash_map;
+		FlatHashMap<int, int> flat_hash_map;
+		timings["hash_map_insert"] = _time_usec([&]() {
+			for (int i = 0; i < p_count; i++) {
+				hash_map.insert(i * 7, i);
+			}
+			return (int64_t)hash_map.size();
+		});
+		timings["flat_hash_map_insert"] = _time_usec([&]() {
+			for (int i = 0; i < p_count; i++) {
+				flat_hash_map.insert(i * 7, i);
+			}
+			return (int64_t)flat_hash_map.size();
+		});
+		timings["hash_map_lookup"] = _time_usec([&]() {
+			int64_t sum = 0;
+			for (int i = 0; i < p_count * 2; i++) {
+				const int *value = hash_map.getptr(i * 7 / 2);
+				sum += value ? *value : 0;
+			}
+			return sum;
+		});
+		timings["flat_hash_map_lookup"] = _time_usec([&]() {
+			int64_t sum = 0;
+			for (int i = 0; i < p_count * 2; i++) {
+				const int *value = flat_hash_map.getptr(i * 7 / 2);
+				sum += value ? *value : 0;
+			}
+			return sum;
+		});
+	}
+
+	// ConcurrentHashMap, inserts and lookups from all ThreadWorkPool threads.
+	{
+		ConcurrentHashMap<int, int> concurrent_hash_map;
+		ThreadWorkPool pool;
+		pool.init();
+		timings["concurrent_hash_map_insert"] = _time_usec([&]() {
+			parallel_for(0, p_count, 1024, [&](uint32_t i) { concurrent_hash_map.insert(i * 7, i); }, &pool);
+			return (int64_t)concurrent_hash_map.size();
+		});
+		timings["concurrent_hash_map_parallel_lookup"] = _time_usec([&]() {
+			std::atomic<int64_t> found = { 0 };
+			parallel_for(0, p_count * 2, 1024, [&](uint32_t i) {
+				int value = 0;
+				if (concurrent_hash_map.get(i * 7 / 2, value)) {
+					found.fetch_add(1, std::memory_order_relaxed);
+				}
+			}, &pool);
+			return found.load();
+		});
+		pool.finish();
+	}
+
+	// ParallelSortArray against SortArray, on distinct and on repeated values.
+	{
+		LocalVector<int> distinct;
+		distinct.resize(p_count);
+		for (int i = 0; i < p_count; i++) {
+			distinct[i] = (int)hash_murmur3_one_32(i);
+		}
+		LocalVector<int> values = distinct;
+		timings["sort_array"] = _time_usec([&]() {
+			SortArray<int>().sort(values.ptr(), p_count);
+			return (int64_t)values[0];
+		});
+		values = distinct;
+		timings["parallel_sort_array"] = _time_usec([&]() {
+			ParallelSortArray<int>().sort(values.ptr(), p_count);
+			return (int64_t)values[0];
+		});
+		for (int i = 0; i < p_count; i++) {
+			values[i] = distinct[i] % 4;
+		}
+		timings["parallel_sort_array_duplicates"] = _time_usec([&]() {
+			ParallelSortArray<int>().sort(values.ptr(), p_count);
+			return (int64_t)values[0];
+		});
+	}
+
+	// SPSCQueue and MPMCQueue, values moved from one producer thread to one consumer thread.
+	{
+		SPSCQueue<int> spsc(1024);
+		MPMCQueue<int> mpmc(1024);
+		auto transfer = [p_count](auto &p_queue) {
+			std::thread producer([&p_queue, p_count]() {
+				for (int i = 0; i < p_count; i++) {
+					while (!p_queue.push(i)) {
+						std::this_thread::yield();
+					}
+				}
+			});
+			int64_t sum = 0;
+			for (int i = 0; i < p_count; i++) {
+				int value = 0;
+				while (!p_queue.pop(value)) {
+					std::this_thread::yield();
+				}
+				sum += value;
+			}
+			producer.join();
+			return sum;
+		};
+		timings["spsc_queue_transfer"] = _time_usec([&]() { return transfer(spsc); });
+		timings["mpmc_queue_transfer"] = _time_usec([&]() { return transfer(mpmc); });
+	}
+
+	// hash_wyhash_buffer() against hash_murmur3_buffer(), from 8 byte keys to 1 MiB buffers,
+	// hashing about the same number of bytes at each length.
+	{
+		LocalVector<uint8_t> buffer;
+		buffer.resize((1 << 20) + 8);
+		for (uint32_t i = 0; i < buffer.size(); i++) {
+			buffer[i] = (uint8_t)i;
+		}
+		for (int len : { 8, 64, 1 << 10, 1 << 16, 1 << 20 }) {
+			const int rounds = MAX(int(int64_t(p_count) * 16 / len), 1);
+			timings[vformat("hash_murmur3_buffer_%d", len)] = _time_usec([&]() {
+				int64_t hash = 0;
+				for (int i = 0; i < rounds; i++) {
+					hash += hash_murmur3_buffer(buffer.ptr() + (i & 7), len, i);
+				}
+				return hash;
+			});
+			timings[vformat("hash_wyhash_buffer_%d", len)] = _time_usec([&]() {
+				int64_t hash = 0;
+				for (int i = 0; i < rounds; i++) {
+					hash += hash_wyhash_buffer(buffer.ptr() + (i & 7), len, i);
+				}
+				return hash;
+			});
+		}
+	}
+
+	// HashMap with HashMapHasherWyhash against the default hasher, on short String keys.
+	{
+		LocalVector<String> keys;
+		for (int i = 0; i < p_count / 10; i++) {
+			keys.push_back("key_" + itos(i));
+		}
+		auto insert_and_find = [&keys](auto &p_map) {
+			for (uint32_t i = 0; i < keys.size(); i++) {
+				p_map.insert(keys[i], i);
+			}
+			int64_t sum = 0;
+			for (int round = 0; round < 4; round++) {
+				for (uint32_t i = 0; i < keys.size(); i++) {
+					const uint32_t *value = p_map.getptr(keys[i]);
+					sum += value ? *value : 0;
+				}
+			}
+			return sum;
+		};
+		timings["hash_map_string_default_hasher"] = _time_usec([&]() {
+			HashMap<String, uint32_t> map;
+			return insert_and_find(map);
+		});
+		timings["hash_map_string_wyhash_hasher"] = _time_usec([&]() {
+			HashMap<String, uint32_t, HashMapHasherWyhash> map;
+			return insert_and_find(map);
+		});
+	}
+
+	// SearchArray::bisect() on a sorted array that fits in the SIMD scan, and on one much larger than the caches,
+	// against EytzingerArray::bisect() on the same values.
+	{
+		SearchArray<int32_t> search;
+		for (int len : { SEARCH_ARRAY_LINEAR_THRESHOLD, 1 << 22 }) {
+			LocalVector<int32_t> sorted;
+			sorted.resize(len);
+			for (int i = 0; i < len; i++) {
+				sorted[i] = i * 2;
+			}
+			timings[vformat("search_array_bisect_%d", len)] = _time_usec([&]() {
+				int64_t sum = 0;
+				for (int i = 0; i < p_count; i++) {
+					sum += search.bisect(sorted.ptr(), len, int32_t(hash_murmur3_one_32(i) % (len * 2)), true);
+				}
+				return sum;
+			});
+			EytzingerArray<int32_t> eytzinger(sorted.ptr(), len);
+			timings[vformat("eytzinger_array_bisect_%d", len)] = _time_usec([&]() {
+				int64_t sum = 0;
+				for (int i = 0; i < p_count; i++) {
+					sum += eytzinger.bisect(int32_t(hash_murmur3_one_32(i) % (len * 2)), true);
+				}
+				return sum;
+			});
+		}
+	}
+
+	// WorkStealingPool against ThreadWorkPool on the same uneven job, on many small jobs (the
+	// completion latency of do_work()), and on nested jobs.
+	{
+		WorkStealingTestJob job;
+		const int small_jobs = MAX(p_count / 1000, 1);
+		ThreadWorkPool thread_work_pool;
+		thread_work_pool.init();
+		timings["thread_work_pool_do_work"] = _time_usec([&]() {
+			thread_work_pool.do_work(p_count / 100, &job, &WorkStealingTestJob::hash, 100u);
+			return job.sum.load();
+		});
+		timings["thread_work_pool_small_do_work"] = _time_usec([&]() {
+			for (int i = 0; i < small_jobs; i++) {
+				thread_work_pool.do_work(32, &job, &WorkStealingTestJob::hash, 10u);
+			}
+			return job.sum.load();
+		});
+		thread_work_pool.finish();
+
+		WorkStealingPool pool;
+		pool.init();
+		job.pool = &pool;
+		timings["work_stealing_pool_do_work"] = _time_usec([&]() {
+			pool.do_work(p_count / 100, &job, &WorkStealingTestJob::hash, 100u);
+			return job.sum.load();
+		});
+		timings["work_stealing_pool_small_do_work"] = _time_usec([&]() {
+			for (int i = 0; i < small_jobs; i++) {
+				pool.do_work(32, &job, &WorkStealingTestJob::hash, 10u);
+			}
+			return job.sum.load();
+		});
+		timings["work_stealing_pool_nested_do_work"] = _time_usec([&]() {
+			pool.do_work(1000, &job, &WorkStealingTestJob::nest, uint32_t(p_count / 1000));
+			return job.sum.load();
+		});
+		pool.finish();
+	}
+
+	// Vector3SoA against a LocalVector<Vector3> on the same integrate, rotate and normalize steps.
+	{
+		const Quaternion rotation = Quaternion(Vector3(1, 2, 3).normalized(), 0.01);
+		LocalVector<Vector3> positions;
+		LocalVector<Vector3> velocities;
+		Vector3SoA positions_soa;
+		Vector3SoA velocities_soa;
+		for (int i = 0; i < p_count; i++) {
+			const Vector3 position = Vector3(i % 101, i % 103, i % 107);
+			const Vector3 velocity = Vector3(i % 7, 1, -(i % 5));
+			positions.push_back(position);
+			velocities.push_back(velocity);
+			positions_soa.push_back(position);
+			velocities_soa.push_back(velocity);
+		}
+		const int rounds = 10;
+		timings["vector3_array_integrate"] = _time_usec([&]() {
+			for (int r = 0; r < rounds; r++) {
+				for (uint32_t i = 0; i < positions.size(); i++) {
+					positions[i] += velocities[i] * 0.016;
+					velocities[i] = rotation.xform(velocities[i]).normalized();
+				}
+			}
+			return int64_t(positions[positions.size() / 2].x);
+		});
+		timings["vector3_soa_integrate"] = _time_usec([&]() {
+			for (int r = 0; r < rounds; r++) {
+				positions_soa.add_scaled(velocities_soa, 0.016);
+				velocities_soa.rotate(rotation);
+				velocities_soa.normalize();
+			}
+			return int64_t(positions_soa.x[positions_soa.size() / 2]);
+		});
+	}
+
+	return timings;
+}
+
 Callable Example::test_callable_mp() {
 	return callable_mp(this, &Example::unbound_method1);
 }
@@ -129,6 +129,34 @@ public:
 	bool test_string_is_fourty_two(const String &p_str) const;
 	String test_string_resize(String p_original) const;
 	int test_vector_ops() const;
+	int test_flat_hash_map() const;
+	int64_t test_concurrent_hash_map(int p_count) const;
+	bool test_parallel_sort(int p_count) const;
+	int test_small_vector() const;
+	Array test_vector_copy_on_write() const;
+	bool test_b_tree(int p_count) const;
+	bool test_queues(int p_count) const;
+	bool test_rid_owner(int p_count) const;
+	bool test_spin_locks(int p_count) const;
+	bool test_hash_stream() const;
+	bool test_search_array() const;
+	bool test_slot_map(int p_count) const;
+	bool test_work_stealing(int p_count) const;
+	bool test_cpu_topology() const;
+	bool test_thread_scratch(int p_count) const;
+	bool test_simd_math(int p_count) const;
+	PackedInt32Array test_radix_sort(PackedInt32Array p_array) const;
+	bool test_radix_sort_matches(int p_count) const;
+	PackedByteArray test_bit_vector(const PackedByteArray &p_bytes) const;
+	String test_frozen_hash_table(const String &p_key) const;
+	int64_t test_parallel_reduce(int p_count) const;
+	int test_worker_tasks(int p_value) const;
+	int64_t test_task_graph(int p_count) const;
+	int64_t test_scratch_arena(int p_count) const;
+	String test_command_buffer(int p_count) const;
+	Array test_vector_math(const Vector3 &p_a, const Vector3 &p_b, const Quaternion &p_q, const Quaternion &p_r, const Vector4 &p_v, const Vector4 &p_u) const;
+	PackedVector3Array test_soa_math(const PackedVector3Array &p_positions, const PackedVector3Array &p_velocities, const Quaternion &p_rotation) const;
+	Dictionary run_benchmarks(int p_count) const;
 
 	bool test_object_cast_to_node(Object *p_object) const;
 	bool test_object_cast_to_control(Object *p_object) const;
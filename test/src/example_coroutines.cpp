@@ -0,0 +1,82 @@
+/* godot-cpp integration testing project.
+ *
+ * This is free and unencumbered software released into the public domain.
+ */
+
+#include "example_coroutines.h"
+
+#include <godot_cpp/classes/os.hpp>
+#include <godot_cpp/core/class_db.hpp>
+#include <godot_cpp/templates/coroutine.hpp>
+
+// Sets a result when destroyed, which is also when the coroutine holding it
+// is cancelled.
+struct CoroutineDestroyedFlag {
+	Dictionary results;
+	String key;
+
+	~CoroutineDestroyedFlag() {
+		results[key] = true;
+	}
+};
+
+// The results are shared with the ExampleCoroutines node, as Dictionary copies share their data.
+static Coroutine _await_signal(Object *p_emitter, Dictionary p_results) {
+	Array arguments = co_await Signal(p_emitter, "step");
+	p_results["signal"] = arguments;
+}
+
+static Coroutine _await_freed_owner(Node *p_owner, Dictionary p_results) {
+	CoroutineDestroyedFlag flag{ p_results, "owner_cancelled" };
+	co_await Coroutines::next_frame(p_owner);
+	p_results["owner_resumed"] = true;
+}
+
+static Coroutine _await_background(Dictionary p_results) {
+	int value = co_await Coroutines::run_in_background([]() { return 6 * 7; });
+	p_results["background"] = value;
+	p_results["background_on_main_thread"] = OS::get_singleton()->get_thread_caller_id() == OS::get_singleton()->get_main_thread_id();
+}
+
+static CoroutineTask<int> _double_next_frame(int p_value) {
+	co_await Coroutines::next_frame();
+	co_return p_value * 2;
+}
+
+static Coroutine _await_nested(Dictionary p_results) {
+	int value = co_await _double_next_frame(21);
+	p_results["nested"] = value;
+}
+
+static Coroutine _wait_until_cleared(Dictionary p_results) {
+	CoroutineDestroyedFlag flag{ p_results, "cleared" };
+	while (true) {
+		co_await Coroutines::next_frame();
+	}
+}
+
+void ExampleCoroutines::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("start", "owner"), &ExampleCoroutines::start);
+	ClassDB::bind_method(D_METHOD("is_done"), &ExampleCoroutines::is_done);
+	ClassDB::bind_method(D_METHOD("finish"), &ExampleCoroutines::finish);
+	ClassDB::bind_method(D_METHOD("get_results"), &ExampleCoroutines::get_results);
+
+	ADD_SIGNAL(MethodInfo("step", PropertyInfo(Variant::INT, "value")));
+}
+
+void ExampleCoroutines::start(Node *p_owner) {
+	results.clear();
+	_await_signal(this, results);
+	_await_freed_owner(p_owner, results);
+	_await_background(results);
+	_await_nested(results);
+	_wait_until_cleared(results);
+}
+
+bool ExampleCoroutines::is_done() const {
+	return results.has("signal") && results.has("owner_cancelled") && results.has("background") && results.has("nested");
+}
+
+void ExampleCoroutines::finish() {
+	Coroutines::clear();
+}
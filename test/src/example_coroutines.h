@@ -0,0 +1,34 @@
+/* godot-cpp integration testing project.
+ *
+ * This is free and unencumbered software released into the public domain.
+ */
+
+#ifndef EXAMPLE_COROUTINES_H
+#define EXAMPLE_COROUTINES_H
+
+#include <godot_cpp/classes/node.hpp>
+#include <godot_cpp/variant/dictionary.hpp>
+
+using namespace godot;
+
+// Tests for coroutine.hpp. The implementation is built as C++20, unlike the
+// rest of the project, so this header must stay valid C++17.
+class ExampleCoroutines : public Node {
+	GDCLASS(ExampleCoroutines, Node);
+
+	Dictionary results;
+
+protected:
+	static void _bind_methods();
+
+public:
+	// Starts the coroutines; p_owner is the owner of a frame wait and is
+	// expected to be freed before the next frame.
+	void start(Node *p_owner);
+	bool is_done() const;
+	// Calls Coroutines::clear(), destroying the coroutine still waiting.
+	void finish();
+	Dictionary get_results() const { return results; }
+};
+
+#endif // EXAMPLE_COROUTINES_H
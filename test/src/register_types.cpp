@@ -12,6 +12,7 @@
 #include <godot_cpp/godot.hpp>
 
 #include "example.h"
+#include "example_coroutines.h"
 #include "tests.h"
 
 using namespace godot;
@@ -27,6 +28,7 @@ void initialize_example_module(ModuleInitializationLevel p_level) {
 	ClassDB::register_class<ExampleVirtual>(true);
 	ClassDB::register_abstract_class<ExampleAbstractBase>();
 	ClassDB::register_class<ExampleConcrete>();
+	ClassDB::register_class<ExampleCoroutines>();
 }
 
 void uninitialize_example_module(ModuleInitializationLevel p_level) {
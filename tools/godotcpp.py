@@ -189,6 +189,14 @@ def options(opts, env):
             map=architecture_aliases,
         )
     )
+    opts.Add(
+        EnumVariable(
+            key="simd",
+            help="SIMD instruction set used by the single precision math types. 'auto' uses what the architecture guarantees (SSE2 on x86_64, NEON on arm64). 'sse4' and 'avx2' are x86 only, and MSVC only supports 'avx2' as it has no SSE4.1 switch.",
+            default=env.get("simd", "auto"),
+            allowed_values=("auto", "none", "sse4", "avx2"),
+        )
+    )
 
     # compiledb
     opts.Add(
@@ -336,6 +344,20 @@ def generate(env):
     if env["precision"] == "double":
         env.Append(CPPDEFINES=["REAL_T_IS_DOUBLE"])
 
+    if env["simd"] == "none":
+        env.Append(CPPDEFINES=["GODOT_SIMD_DISABLED"])
+    elif env["simd"] != "auto":
+        if env["arch"] not in ("x86_32", "x86_64"):
+            print("SIMD instruction set '" + env["simd"] + "' is only available on x86 architectures.")
+            env.Exit(1)
+        if env.get("is_msvc", False):
+            if env["simd"] != "avx2":
+                print("SIMD instruction set '" + env["simd"] + "' is not available with MSVC, which has no SSE4.1 switch; use 'avx2'.")
+                env.Exit(1)
+            env.Append(CCFLAGS=["/arch:AVX2"])
+        else:
+            env.Append(CCFLAGS=["-mavx2" if env["simd"] == "avx2" else "-msse4.1"])
+
     # Allow detecting when building as a GDExtension.
     env.Append(CPPDEFINES=["GDEXTENSION"])
 
@@ -382,6 +404,7 @@ def _godot_cpp(env):
     add_sources(sources, "src", "cpp")
     add_sources(sources, "src/classes", "cpp")
     add_sources(sources, "src/core", "cpp")
+    add_sources(sources, "src/templates", "cpp")
     add_sources(sources, "src/variant", "cpp")
     sources.extend([f for f in bindings if str(f).endswith(".cpp")])
 